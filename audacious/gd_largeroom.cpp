@@ -78,7 +78,8 @@ static PluginParameterTable ppConfTable[] = {
   {"Decay","Decay","", "",           0,1,     2,   0.5, 0,true,true,false,kFloat,(void*)_decay,},
 };
 
-static void mod_samples(pfloat_t * iL, pfloat_t * iR, pfloat_t * oL, pfloat_t * oR, gint length, gint srate)
+static void mod_samples_strided(const pfloat_t * iL, const pfloat_t * iR, long iStride,
+				pfloat_t * oL, pfloat_t * oR, long oStride, gint length, gint srate)
 {
   if(pthread_mutex_trylock(&plugin_mutex) == EBUSY) return;
   if(plugin_available != true||XMMSPlugin == NULL)
@@ -97,9 +98,10 @@ static void mod_samples(pfloat_t * iL, pfloat_t * iR, pfloat_t * oL, pfloat_t *
   XMMSPlugin->callNRTParameters();
   uint32_t mxcsr = UTILS::getMXCSR();
   UTILS::setMXCSR(FV3_X86SIMD_MXCSR_FZ|FV3_X86SIMD_MXCSR_DAZ|FV3_X86SIMD_MXCSR_EMASK_ALL);
-  DSP.processreplace(iL,iR,oL,oR,length);
+  DSP.processstrided(iL,iR,iStride,oL,oR,oStride,length);
   UTILS::setMXCSR(mxcsr);
   pthread_mutex_unlock(&plugin_mutex);
 }
 
+#define MOD_SAMPLES_STRIDED
 #include "libxmmsplugin_table.hpp"
@@ -915,7 +915,8 @@ static void cleanup(void)
 }
 
 static int validNumber = 0;
-static void mod_samples_f(pfloat_t * iL, pfloat_t * iR, pfloat_t * oL, pfloat_t * oR, gint length, gint srate)
+// the i-th input sample of a channel is at [i*iStride]
+static void mod_samples_f(const pfloat_t * iL, const pfloat_t * iR, long iStride, pfloat_t * oL, pfloat_t * oR, gint length, gint srate)
 {
   if(length <= 0) return;
   if(validModel != true) fprintf(stderr, "Impulser2: !validModel\n");
@@ -1058,9 +1059,9 @@ static void mod_samples_f(pfloat_t * iL, pfloat_t * iR, pfloat_t * oL, pfloat_t
                   if(typeid(*(*reverbVector)[i]) == typeid(IRMODEL1))
                     options = FV3_IR_DEFAULT;
                   if(i == 0)
-                    (*reverbVector)[i]->processreplace(iL,iR,oL,oR,length,options);
+                    (*reverbVector)[i]->processstrided(iL,iR,iStride,oL,oR,1,length,options);
                   else
-                    (*reverbVector)[i]->processreplace(iL,iR,oL,oR,length,options|FV3_IR_SKIP_INIT);
+                    (*reverbVector)[i]->processstrided(iL,iR,iStride,oL,oR,1,length,options|FV3_IR_SKIP_INIT);
                   validNumber ++;
                 }
             }
@@ -1072,9 +1073,11 @@ static void mod_samples_f(pfloat_t * iL, pfloat_t * iR, pfloat_t * oL, pfloat_t
 static SLOTP origLR, orig, reverb;
 static void mod_samples_d(gfloat * LR, gint samples, gint srate)
 {
-  if(orig.getsize() < samples)
+  if(reverb.getsize() < samples)
     {
+#ifdef PLUGDOUBLE
       orig.alloc(samples, 2);
+#endif
       reverb.alloc(samples, 2);
     }
 #ifdef PLUGDOUBLE
@@ -1083,10 +1086,11 @@ static void mod_samples_d(gfloat * LR, gint samples, gint srate)
       orig.L[tmpi] = LR[tmpi*2+0];
       orig.R[tmpi] = LR[tmpi*2+1];
     }
+  mod_samples_f(orig.L,orig.R,1,reverb.L,reverb.R,samples,srate);
 #else
-  fv3::splitChannelsV(2, samples, LR, orig.L, orig.R);
+  // the interleaved input is read directly, the planar output is dithered into LR
+  mod_samples_f(LR,LR+1,2,reverb.L,reverb.R,samples,srate);
 #endif
-  mod_samples_f(orig.L,orig.R,reverb.L,reverb.R,samples,srate);
   if(validNumber <= 0) return;
   if(next_dithering != conf_dithering||gdither_on == FALSE)
     {
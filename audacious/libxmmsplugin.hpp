@@ -127,6 +127,7 @@ namespace fv3
 	}
       conf_dialog = NULL;
       _mod_samples = NULL;
+      _mod_samples_strided = NULL;
       plugin_rate = plugin_ch = 0;
     }
     
@@ -140,9 +141,23 @@ namespace fv3
       _mod_samples = _vf;
     }
 
+    // the i-th sample of a channel is at [i*stride], the interleaved LR is processed in place
+    void registerModSamplesStrided(void (*_vf)(const pfloat_t * iL, const pfloat_t * iR, long iStride,
+                                               pfloat_t * oL, pfloat_t * oR, long oStride, gint length, gint srate))
+    {
+      _mod_samples_strided = _vf;
+    }
+
     void mod_samples(gfloat * LR, gint samples, gint srate)
     {
-      if(_mod_samples == NULL) return;
+#ifndef PLUGDOUBLE
+      if(_mod_samples_strided != NULL)
+	{
+	  _mod_samples_strided(LR, LR+1, 2, LR, LR+1, 2, samples, srate);
+	  return;
+	}
+#endif
+      if(_mod_samples == NULL&&_mod_samples_strided == NULL) return;
       if(orig.getsize() < samples)
 	{
 	  orig.alloc(samples, 2);
@@ -157,7 +172,10 @@ namespace fv3
 #else
       fv3::splitChannelsV(2, samples, LR, orig.L, orig.R);
 #endif
-      _mod_samples(orig.L,orig.R,reverb.L,reverb.R,samples,srate);
+      if(_mod_samples != NULL)
+	_mod_samples(orig.L,orig.R,reverb.L,reverb.R,samples,srate);
+      else
+	_mod_samples_strided(orig.L,orig.R,1,reverb.L,reverb.R,1,samples,srate);
 #ifdef PLUGDOUBLE
       for(int tmpi = 0;tmpi < samples;tmpi ++)
         {
@@ -577,6 +595,8 @@ namespace fv3
     SLOTP origLR, orig, reverb;
     gint plugin_rate, plugin_ch;
     void (*_mod_samples)(pfloat_t * iL, pfloat_t * iR, pfloat_t * oL, pfloat_t * oR, gint length, gint srate);
+    void (*_mod_samples_strided)(const pfloat_t * iL, const pfloat_t * iR, long iStride,
+                                 pfloat_t * oL, pfloat_t * oR, long oStride, gint length, gint srate);
     const char *aboutString, *productString, *configSectionString;
     std::vector<PluginParameter> ParamsV;
     GtkWidget *conf_dialog;
@@ -51,7 +51,11 @@ static gboolean init(void)
   if(XMMSPlugin != NULL) delete XMMSPlugin;
   XMMSPlugin = new fv3::libxmmsplugin(ppConfTable, sizeof(ppConfTable)/sizeof(PluginParameterTable),
 				      about_text, productString, configSectionString);  
+#ifdef MOD_SAMPLES_STRIDED
+  XMMSPlugin->registerModSamplesStrided(mod_samples_strided);
+#else
   XMMSPlugin->registerModSamples(mod_samples);
+#endif
   pthread_mutex_unlock(&plugin_mutex);
   return TRUE;
 }
@@ -112,6 +112,75 @@ fv3_float_t FV3_(allpass)::getdecay()
   return decay;
 }
 
+void FV3_(allpass)::process(const fv3_float_t * input, fv3_float_t * output, long numsamples)
+{
+  if(numsamples <= 0) return;
+  if(bufsize == 0)
+    {
+      if(output != input) std::memcpy(output, input, sizeof(fv3_float_t)*numsamples);
+      return;
+    }
+  while(numsamples > 0)
+    {
+      long count = bufsize - bufidx; if(count > numsamples) count = numsamples;
+      fv3_float_t * buf = buffer + bufidx;
+      for(long i = 0;i < count;i ++)
+	{
+	  fv3_float_t buffer_tmp = buf[i], in = input[i] + feedback * buffer_tmp;
+	  output[i] = FV3_(utils)::undenormal(buffer_tmp - feedback * in);
+	  buf[i] = in;
+	}
+      bufidx += count; if(bufidx >= bufsize) bufidx = 0;
+      input += count; output += count; numsamples -= count;
+    }
+}
+
+void FV3_(allpass)::process_dc(const fv3_float_t * input, fv3_float_t * output, long numsamples)
+{
+  if(numsamples <= 0) return;
+  if(bufsize == 0)
+    {
+      if(output != input) std::memcpy(output, input, sizeof(fv3_float_t)*numsamples);
+      return;
+    }
+  while(numsamples > 0)
+    {
+      long count = bufsize - bufidx; if(count > numsamples) count = numsamples;
+      fv3_float_t * buf = buffer + bufidx;
+      for(long i = 0;i < count;i ++)
+	{
+	  fv3_float_t buffer_tmp = buf[i], in = input[i] + feedback * buffer_tmp;
+	  output[i] = FV3_(utils)::undenormal(decay * buffer_tmp - feedback * in);
+	  buf[i] = in;
+	}
+      bufidx += count; if(bufidx >= bufsize) bufidx = 0;
+      input += count; output += count; numsamples -= count;
+    }
+}
+
+void FV3_(allpass)::process_ov(const fv3_float_t * input, fv3_float_t * output, long numsamples)
+{
+  if(numsamples <= 0) return;
+  if(bufsize == 0)
+    {
+      if(output != input) std::memcpy(output, input, sizeof(fv3_float_t)*numsamples);
+      return;
+    }
+  while(numsamples > 0)
+    {
+      long count = bufsize - bufidx; if(count > numsamples) count = numsamples;
+      fv3_float_t * buf = buffer + bufidx;
+      for(long i = 0;i < count;i ++)
+	{
+	  fv3_float_t bufout = FV3_(utils)::undenormal(buf[i]), in = input[i];
+	  buf[i] = in + (bufout * feedback);
+	  output[i] = bufout - in;
+	}
+      bufidx += count; if(bufidx >= bufsize) bufidx = 0;
+      input += count; output += count; numsamples -= count;
+    }
+}
+
 // modulated allpass filter
 
 FV3_(allpassm)::FV3_(allpassm)()
@@ -109,6 +109,77 @@ fv3_float_t FV3_(comb)::getfeedback()
   return feedback;
 }
 
+void FV3_(comb)::process(const fv3_float_t * input, fv3_float_t * output, long numsamples)
+{
+  if(numsamples <= 0) return;
+  if(bufsize == 0)
+    {
+      if(output != input) std::memcpy(output, input, sizeof(fv3_float_t)*numsamples);
+      return;
+    }
+  while(numsamples > 0)
+    {
+      long count = bufsize - bufidx; if(count > numsamples) count = numsamples;
+      fv3_float_t * buf = buffer + bufidx, fs = filterstore;
+      for(long i = 0;i < count;i ++)
+	{
+	  fv3_float_t bufout = FV3_(utils)::undenormal(buf[i]);
+	  fs = (bufout * damp2) + (fs * damp1);
+	  buf[i] = input[i] + (fs * feedback);
+	  output[i] = bufout;
+	}
+      filterstore = fs;
+      bufidx += count; if(bufidx >= bufsize) bufidx = 0;
+      input += count; output += count; numsamples -= count;
+    }
+}
+
+void FV3_(comb)::process_ff(const fv3_float_t * input, fv3_float_t * output, long numsamples)
+{
+  if(numsamples <= 0) return;
+  if(bufsize == 0)
+    {
+      if(output != input) std::memcpy(output, input, sizeof(fv3_float_t)*numsamples);
+      return;
+    }
+  while(numsamples > 0)
+    {
+      long count = bufsize - bufidx; if(count > numsamples) count = numsamples;
+      fv3_float_t * buf = buffer + bufidx;
+      for(long i = 0;i < count;i ++)
+	{
+	  fv3_float_t in = input[i];
+	  output[i] = FV3_(utils)::undenormal(buf[i] * feedback + in);
+	  buf[i] = in;
+	}
+      bufidx += count; if(bufidx >= bufsize) bufidx = 0;
+      input += count; output += count; numsamples -= count;
+    }
+}
+
+void FV3_(comb)::process_fb(const fv3_float_t * input, fv3_float_t * output, long numsamples)
+{
+  if(numsamples <= 0) return;
+  if(bufsize == 0)
+    {
+      if(output != input) std::memcpy(output, input, sizeof(fv3_float_t)*numsamples);
+      return;
+    }
+  while(numsamples > 0)
+    {
+      long count = bufsize - bufidx; if(count > numsamples) count = numsamples;
+      fv3_float_t * buf = buffer + bufidx;
+      for(long i = 0;i < count;i ++)
+	{
+	  fv3_float_t in = buf[i] * feedback + input[i];
+	  buf[i] = in;
+	  output[i] = FV3_(utils)::undenormal(in);
+	}
+      bufidx += count; if(bufidx >= bufsize) bufidx = 0;
+      input += count; output += count; numsamples -= count;
+    }
+}
+
 // modulated comb filter
 
 FV3_(combm)::FV3_(combm)()
@@ -212,4 +283,162 @@ fv3_float_t FV3_(combm)::getfeedback()
   return feedback;
 }
 
+// voice-packed comb filters
+
+FV3_(combv)::FV3_(combv)()
+{
+  buffer = filterstore = damp1 = damp2 = feedback = NULL;
+  delaysize = bufbase = bufend = bufidx = NULL;
+  lanes = bufsize = 0;
+}
+
+FV3_(combv)::FV3_(~combv)()
+{
+  this->free();
+}
+
+void FV3_(combv)::free()
+{
+  delete[] buffer; delete[] filterstore; delete[] damp1; delete[] damp2; delete[] feedback;
+  delete[] delaysize; delete[] bufbase; delete[] bufend; delete[] bufidx;
+  buffer = filterstore = damp1 = damp2 = feedback = NULL;
+  delaysize = bufbase = bufend = bufidx = NULL;
+  lanes = bufsize = 0;
+}
+
+void FV3_(combv)::setlanes(long size)
+{
+#ifdef DEBUG
+  std::fprintf(stderr, "combv::setlanes(%ld)\n", size);
+#endif
+  this->free();
+  if(size <= 0) return;
+  try
+    {
+      buffer = new fv3_float_t[size];
+      filterstore = new fv3_float_t[size];
+      damp1 = new fv3_float_t[size];
+      damp2 = new fv3_float_t[size];
+      feedback = new fv3_float_t[size];
+      delaysize = new long[size];
+      bufbase = new long[size];
+      bufend = new long[size];
+      bufidx = new long[size];
+    }
+  catch(std::bad_alloc)
+    {
+      std::fprintf(stderr, "combv::setlanes(%ld) bad_alloc\n", size);
+      this->free();
+      throw;
+    }
+  lanes = bufsize = size;
+  for(long i = 0;i < lanes;i ++)
+    {
+      buffer[i] = filterstore[i] = feedback[i] = 0; delaysize[i] = 0;
+      bufbase[i] = bufidx[i] = i; bufend[i] = i + 1;
+    }
+  setdamp(0);
+}
+
+long FV3_(combv)::getlanes()
+{
+  return lanes;
+}
+
+void FV3_(combv)::setsize(long lane, long size)
+{
+#ifdef DEBUG
+  std::fprintf(stderr, "combv::setsize(%ld,%ld)\n", lane, size);
+#endif
+  if(lane < 0||lane >= lanes||size <= 0) return;
+  long oldsize = bufend[lane] - bufbase[lane];
+  long newsize = bufsize - oldsize + size;
+  fv3_float_t * new_buffer = NULL;
+  try
+    {
+      new_buffer = new fv3_float_t[newsize];
+    }
+  catch(std::bad_alloc)
+    {
+      std::fprintf(stderr, "combv::setsize(%ld) bad_alloc\n", newsize);
+      delete[] new_buffer;
+      throw;
+    }
+  FV3_(utils)::mute(new_buffer, newsize);
+
+  long base = 0;
+  for(long i = 0;i < lanes;i ++)
+    {
+      long length = bufend[i] - bufbase[i], pos = bufidx[i] - bufbase[i];
+      if(i != lane)
+	{
+	  for(long j = 0;j < length;j ++) new_buffer[base + j] = buffer[bufbase[i] + j];
+	  bufbase[i] = base; bufend[i] = base + length; bufidx[i] = base + pos;
+	  base += length;
+	  continue;
+	}
+      // keep the latest samples in order (the oldest sample is at pos) like comb::setsize()
+      long keep = length < size ? length : size;
+      for(long j = 0;j < keep;j ++)
+	new_buffer[base + size - keep + j] = buffer[bufbase[i] + (pos + length - keep + j) % length];
+      bufbase[i] = bufidx[i] = base; bufend[i] = base + size;
+      filterstore[i] = 0; delaysize[i] = size;
+      base += size;
+    }
+
+  delete[] buffer;
+  buffer = new_buffer;
+  bufsize = newsize;
+}
+
+long FV3_(combv)::getsize(long lane)
+{
+  if(lane < 0||lane >= lanes) return 0;
+  return delaysize[lane];
+}
+
+void FV3_(combv)::mute()
+{
+  if(buffer == NULL||bufsize == 0) return;
+  FV3_(utils)::mute(buffer, bufsize);
+  for(long i = 0;i < lanes;i ++)
+    {
+      filterstore[i] = 0; bufidx[i] = bufbase[i];
+    }
+}
+
+void FV3_(combv)::setdamp(fv3_float_t val)
+{
+  for(long i = 0;i < lanes;i ++) setdamp(i, val);
+}
+
+void FV3_(combv)::setdamp(long lane, fv3_float_t val)
+{
+  if(lane < 0||lane >= lanes) return;
+  damp1[lane] = val; damp2[lane] = 1-val;
+}
+
+fv3_float_t FV3_(combv)::getdamp(long lane)
+{
+  if(lane < 0||lane >= lanes) return 0;
+  return damp1[lane];
+}
+
+void FV3_(combv)::setfeedback(fv3_float_t val)
+{
+  for(long i = 0;i < lanes;i ++) feedback[i] = val;
+}
+
+void FV3_(combv)::setfeedback(long lane, fv3_float_t val)
+{
+  if(lane < 0||lane >= lanes) return;
+  feedback[lane] = val;
+}
+
+fv3_float_t FV3_(combv)::getfeedback(long lane)
+{
+  if(lane < 0||lane >= lanes) return 0;
+  return feedback[lane];
+}
+
 #include "freeverb/fv3_ns_end.h"
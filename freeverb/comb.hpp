@@ -22,6 +22,7 @@
 #ifndef _FV3_COMB_HPP
 #define _FV3_COMB_HPP
 
+#include <cmath>
 #include <cstdio>
 #include <new>
 
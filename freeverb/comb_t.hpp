@@ -104,6 +104,18 @@ public:
   }
   inline _fv3_float_t _process_fb(_fv3_float_t input, _fv3_float_t fb){ setfeedback(fb); return _process_fb(input); }
 
+  /**
+   * Block versions of process(), process_ff() and process_fb().
+   * The block is split at the wrap point of the ring buffer.
+   * input and output may be the same array, but must not partially overlap.
+   * @param[in] input The input signal.
+   * @param[out] output The output signal.
+   * @param[in] numsamples The block size.
+   */
+  void process(const _fv3_float_t * input, _fv3_float_t * output, long numsamples);
+  void process_ff(const _fv3_float_t * input, _fv3_float_t * output, long numsamples);
+  void process_fb(const _fv3_float_t * input, _fv3_float_t * output, long numsamples);
+
 private:
   _FV3_(comb)(const _FV3_(comb)& x);
   _FV3_(comb)& operator=(const _FV3_(comb)& x);
@@ -166,3 +178,101 @@ private:
   _fv3_float_t *buffer, feedback, filterstore, damp1, damp2, z_1, modulationsize_f;
   long bufsize, readidx, writeidx, delaysize, modulationsize;
 };
+
+/**
+ * A bank of independent feedback delayed comb filters with LPF (same as comb::_process())
+ * which are advanced in lockstep. The delay lines of all lanes are the segments of one
+ * buffer addressed by absolute indexes, so that one step of all lanes is a gather, the
+ * element-wise filter arithmetic and a scatter to the same indexes.
+ */
+class _FV3_(combv)
+{
+public:
+  _FV3_(combv)();
+  _FV3_(~combv)();
+  void free();
+
+  /**
+   * Set the number of the lanes. This clears all delay sizes and data.
+   * @param[in] lanes The number of the comb filters in the bank.
+   */
+  void setlanes(long lanes);
+  long getlanes();
+
+  /**
+   * Set the delay size of one lane. This preserves previous data.
+   * The lanes are 1 sample delays until their sizes are set (getsize() returns 0).
+   * @param[in] lane The lane index.
+   * @param[in] size The delay size.
+   */
+  void setsize(long lane, long size);
+  long getsize(long lane);
+  void mute();
+  void          setdamp(_fv3_float_t val);
+  void          setdamp(long lane, _fv3_float_t val);
+  _fv3_float_t  getdamp(long lane);
+  void          setfeedback(_fv3_float_t val);
+  void          setfeedback(long lane, _fv3_float_t val);
+  _fv3_float_t  getfeedback(long lane);
+
+  /**
+   * Process one sample of all lanes.
+   * @param[in] input The input signals of the lanes.
+   * @param[out] output The output signals of the lanes.
+   */
+  inline void process(const _fv3_float_t * input, _fv3_float_t * output)
+  {
+    if(bufsize == 0){ for(long i = 0;i < lanes;i ++) output[i] = input[i]; return; }
+    _process(input, output);
+  }
+  inline void _process(const _fv3_float_t * input, _fv3_float_t * output)
+  {
+    const long n = lanes;
+    for(long i = 0;i < n;i ++)
+      {
+	long idx = bufidx[i];
+	_fv3_float_t o = buffer[idx];
+	UNDENORMAL(o);
+	_fv3_float_t f = (o * damp2[i]) + (filterstore[i] * damp1[i]);
+	filterstore[i] = f;
+	buffer[idx] = input[i] + (f * feedback[i]);
+	idx ++; if(idx >= bufend[i]) idx = bufbase[i];
+	bufidx[i] = idx;
+	output[i] = o;
+      }
+  }
+
+  /**
+   * Process one sample of all lanes with the same input signal.
+   * @param[in] input The input signal.
+   * @param[out] output The output signals of the lanes.
+   */
+  inline void process(_fv3_float_t input, _fv3_float_t * output)
+  {
+    if(bufsize == 0){ for(long i = 0;i < lanes;i ++) output[i] = input; return; }
+    _process(input, output);
+  }
+  inline void _process(_fv3_float_t input, _fv3_float_t * output)
+  {
+    const long n = lanes;
+    for(long i = 0;i < n;i ++)
+      {
+	long idx = bufidx[i];
+	_fv3_float_t o = buffer[idx];
+	UNDENORMAL(o);
+	_fv3_float_t f = (o * damp2[i]) + (filterstore[i] * damp1[i]);
+	filterstore[i] = f;
+	buffer[idx] = input + (f * feedback[i]);
+	idx ++; if(idx >= bufend[i]) idx = bufbase[i];
+	bufidx[i] = idx;
+	output[i] = o;
+      }
+  }
+
+private:
+  _FV3_(combv)(const _FV3_(combv)& x);
+  _FV3_(combv)& operator=(const _FV3_(combv)& x);
+  _fv3_float_t *buffer, *filterstore, *damp1, *damp2, *feedback;
+  long *delaysize, *bufbase, *bufend, *bufidx;
+  long lanes, bufsize;
+};
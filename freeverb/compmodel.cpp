@@ -155,6 +155,7 @@ fv3_float_t FV3_(compmodel)::getCGain()
  */
 void FV3_(compmodel)::processreplace(fv3_float_t *inputL, fv3_float_t *inputR, fv3_float_t *outputL, fv3_float_t *outputR, long numsamples)
 {
+  FV3_(denormalguard) guard;
   float gainL, gainR;
   for(long i = 0;i < numsamples;i ++)
     {
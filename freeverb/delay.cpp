@@ -191,4 +191,48 @@ fv3_float_t FV3_(delaym)::getfeedback()
   return feedback;
 }
 
+void FV3_(delay)::process(const fv3_float_t * input, fv3_float_t * output, long numsamples)
+{
+  if(numsamples <= 0) return;
+  if(bufsize == 0)
+    {
+      if(output != input) std::memcpy(output, input, sizeof(fv3_float_t)*numsamples);
+      return;
+    }
+  while(numsamples > 0)
+    {
+      long count = bufsize - bufidx; if(count > numsamples) count = numsamples;
+      fv3_float_t * buf = buffer + bufidx;
+      if(output == input)
+	{
+	  for(long i = 0;i < count;i ++){ fv3_float_t bufout = buf[i]; buf[i] = input[i]; output[i] = bufout; }
+	}
+      else
+	{
+	  std::memcpy(output, buf, sizeof(fv3_float_t)*count);
+	  std::memcpy(buf, input, sizeof(fv3_float_t)*count);
+	}
+      bufidx += count; if(bufidx >= bufsize) bufidx = 0;
+      input += count; output += count; numsamples -= count;
+    }
+}
+
+void FV3_(delay)::process_wf(const fv3_float_t * input, fv3_float_t * output, long numsamples)
+{
+  if(numsamples <= 0) return;
+  if(bufsize == 0)
+    {
+      for(long i = 0;i < numsamples;i ++) output[i] = feedback*input[i];
+      return;
+    }
+  while(numsamples > 0)
+    {
+      long count = bufsize - bufidx; if(count > numsamples) count = numsamples;
+      fv3_float_t * buf = buffer + bufidx;
+      for(long i = 0;i < count;i ++){ fv3_float_t bufout = buf[i]; buf[i] = feedback*input[i]; output[i] = bufout; }
+      bufidx += count; if(bufidx >= bufsize) bufidx = 0;
+      input += count; output += count; numsamples -= count;
+    }
+}
+
 #include "freeverb/fv3_ns_end.h"
@@ -95,6 +95,17 @@ class _FV3_(delay)
     return bufout;
   }
 
+  /**
+   * Block versions of process() and process_wf().
+   * The block is split at the wrap point of the ring buffer.
+   * input and output may be the same array, but must not partially overlap.
+   * @param[in] input The input signal.
+   * @param[out] output The output signal.
+   * @param[in] numsamples The block size.
+   */
+  void process(const _fv3_float_t * input, _fv3_float_t * output, long numsamples);
+  void process_wf(const _fv3_float_t * input, _fv3_float_t * output, long numsamples);
+
   void mute();
   void setfeedback(_fv3_float_t val);
   _fv3_float_t getfeedback();
@@ -157,6 +168,26 @@ class _FV3_(delaym)
   inline _fv3_float_t operator()(_fv3_float_t input, _fv3_float_t modulation){ return process(input,modulation); }
 
   inline _fv3_float_t _getlast(){ return z_1; }
+
+  /**
+   * _process() split for the lane-parallel callers, which keep z = _getlast() while they run.
+   * _tap() reads the two taps of the interpolation at the integer part of the modulation,
+   * the caller computes z = b + frac * (a - z) and stores feedback * input by _write().
+   * @param[in] floor_mod The integer part of (modulation + 1) * getmodulationsize().
+   */
+  inline void _tap(long floor_mod, _fv3_float_t& a, _fv3_float_t& b)
+  {
+    long readidx_a = readidx - floor_mod; if(readidx_a < 0) readidx_a += bufsize;
+    long readidx_b = readidx_a - 1; if(readidx_b < 0) readidx_b += bufsize;
+    a = buffer[readidx_a], b = buffer[readidx_b];
+    readidx ++; if(readidx >= bufsize) readidx = 0;
+  }
+  inline void _write(_fv3_float_t value)
+  {
+    buffer[writeidx] = value;
+    writeidx ++; if(writeidx >= bufsize) writeidx = 0;
+  }
+  inline void _setlast(_fv3_float_t value){ z_1 = value; }
   
  private:
   _FV3_(delaym)(const _FV3_(delaym)& x);
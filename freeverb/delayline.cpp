@@ -27,6 +27,7 @@ FV3_(delayline)::FV3_(delayline)()
 {
   currentfs = FV3_REVBASE_DEFAULT_FS;
   bufsize = baseidx = 0, buffer = NULL;
+  primeMode = true;
 }
 
 FV3_(delayline)::~FV3_(delayline)()
@@ -104,6 +105,26 @@ fv3_float_t FV3_(delayline)::process(fv3_float_t input)
   return lastOut;
 }
 
+void FV3_(delayline)::process(const fv3_float_t * input, fv3_float_t * output, long numsamples)
+{
+  if(numsamples <= 0) return;
+  if(bufsize == 0)
+    {
+      if(output != input) std::memcpy(output, input, sizeof(fv3_float_t)*numsamples);
+      return;
+    }
+  while(numsamples > 0)
+    {
+      // baseidx runs backward, the block covers [baseidx-count,baseidx)
+      if(baseidx == 0) baseidx = bufsize;
+      long count = baseidx; if(count > numsamples) count = numsamples;
+      fv3_float_t * buf = buffer + baseidx - 1;
+      for(long i = 0;i < count;i ++){ fv3_float_t lastOut = buf[-i]; buf[-i] = input[i]; output[i] = lastOut; }
+      baseidx -= count;
+      input += count; output += count; numsamples -= count;
+    }
+}
+
 long FV3_(delayline)::p_(fv3_float_t ms)
 {
   long base = static_cast<long>(currentfs*ms*0.001);
@@ -33,6 +33,18 @@ class _FV3_(delayline)
   long getsize();
   virtual void mute();
   virtual _fv3_float_t process(_fv3_float_t input);
+
+  /**
+   * Block version of process(). This base class version is the plain delay without
+   * the per-sample index wrap, the derived classes which override process(input)
+   * must override this too.
+   * input and output may be the same array, but must not partially overlap.
+   * @param[in] input The input signal.
+   * @param[out] output The output signal.
+   * @param[in] numsamples The block size.
+   */
+  virtual void process(const _fv3_float_t * input, _fv3_float_t * output, long numsamples);
+
   /**
    * set the prime mode for delay lines.
    * the size of the delay lines will prime numbers by default.
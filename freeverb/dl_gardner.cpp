@@ -83,6 +83,11 @@ fv3_float_t FV3_(dl_gd_largeroom)::process(fv3_float_t input)
   return out;
 }
 
+void FV3_(dl_gd_largeroom)::process(const fv3_float_t * input, fv3_float_t * output, long numsamples)
+{
+  for(long i = 0;i < numsamples;i ++) output[i] = process(input[i]);
+}
+
 //
 
 FV3_(gd_largeroom)::FV3_(gd_largeroom)() 
@@ -96,28 +101,28 @@ FV3_(gd_largeroom)::FV3_(gd_largeroom)()
 void FV3_(gd_largeroom)::processreplace(fv3_float_t *inputL, fv3_float_t *inputR, fv3_float_t *outputL, fv3_float_t *outputR, long numsamples)
 			
 {
+  FV3_(denormalguard) guard;
   if(numsamples <= 0) return;
   long count = numsamples*SRC.getSRCFactor();
   try{growWave(count);}catch(std::bad_alloc){throw;}
 
-  fv3_float_t outL, outR, *origOutL = outputL, *origOutR = outputR;
+  fv3_float_t *origOutL = outputL, *origOutR = outputR;
   SRC.usrc(inputL, inputR, over.L, over.R, numsamples);
   inputL = over.L; inputR = over.R; outputL = overO.L; outputR = overO.R;
 
-  while(count-- > 0)
+  for(long t = 0;t < count;t ++){ UNDENORMAL(inputL[t]); UNDENORMAL(inputR[t]); }
+  DL_Left.process(inputL, outputL, count);
+  DL_Right.process(inputR, outputR, count);
+  delayWL.process(outputL, outputL, count);
+  delayWR.process(outputR, outputR, count);
+  delayL.process(inputL, inputL, count);
+  delayR.process(inputR, inputR, count);
+  for(long t = 0;t < count;t ++)
     {
-      UNDENORMAL(*inputL); UNDENORMAL(*inputR);
-      outL = outR = 0.0;
- 
-      outL = DL_Left.process(*inputL);
-      outR = DL_Right.process(*inputR);
-
-      fv3_float_t fpL = delayWL.process(outL);
-      fv3_float_t fpR = delayWR.process(outR);
-      *outputL = fpL*wet1 + fpR*wet2 + delayL.process(*inputL)*dry;
-      *outputR = fpR*wet1 + fpL*wet2 + delayR.process(*inputR)*dry;
-      UNDENORMAL(*outputL); UNDENORMAL(*outputR);
-      inputL ++; inputR ++; outputL ++; outputR ++;
+      fv3_float_t fpL = outputL[t], fpR = outputR[t];
+      outputL[t] = fpL*wet1 + fpR*wet2 + inputL[t]*dry;
+      outputR[t] = fpR*wet1 + fpL*wet2 + inputR[t]*dry;
+      UNDENORMAL(outputL[t]); UNDENORMAL(outputR[t]);
     }
   SRC.dsrc(overO.L, overO.R, origOutL, origOutR, numsamples);
 }
@@ -28,6 +28,7 @@ class _FV3_(dl_gd_largeroom) : public _FV3_(delayline)
   virtual void setSampleRate(_fv3_float_t fs) ;
   virtual void mute();
   virtual _fv3_float_t process(_fv3_float_t input);
+  virtual void process(const _fv3_float_t * input, _fv3_float_t * output, long numsamples);
 
   void setDCC(_fv3_float_t fc){dccut.setCutOnFreq(fc, currentfs);}
   void setLPF(_fv3_float_t fc){lpf_loop.setLPF_BW(fc, currentfs);}
@@ -128,6 +128,7 @@ FV3_(earlyref)::FV3_(earlyref)()
   
 {
   tapLengthL = tapLengthR = 0;
+  tapMode = FV3_EARLYREF_TAP_AUTO, historySize = 0, fftMode = false;
   gainTableL = gainTableR = delayTableL = delayTableR = NULL;
   setdryr(0.8); setwetr(0.5); setwidth(0.2);
   setLRDelay(0.3);
@@ -147,7 +148,7 @@ FV3_(earlyref)::FV3_(~earlyref)()
 void FV3_(earlyref)::mute()
 {
   FV3_(revbase)::mute();
-  delayLineL.mute(); delayLineR.mute(); delayLtoR.mute(); delayRtoL.mute();
+  historySlot.mute(); tapIRL.mute(); tapIRR.mute(); delayLtoR.mute(); delayRtoL.mute();
   allpassXL.mute(); allpassXR.mute(); allpassL2.mute(); allpassR2.mute();
 }
 
@@ -266,13 +267,57 @@ void FV3_(earlyref)::loadReflection(const fv3_float_t * delayL, const fv3_float_
       gainTableR[i] = gainR[i];
       delayTableR[i] = getTotalFactorFs()*delayR[i];
     }
-  long maxLengthL = (long)(maxDelay(delayTableL, tapLengthL)+10);
-  long maxLengthR = (long)(maxDelay(delayTableR, tapLengthR)+10);
-  delayLineL.setsize(maxLengthL);
-  delayLineR.setsize(maxLengthR);
+  // the taps are integer delays, the longest one is at historySize-1.
+  fv3_float_t maxLengthL = maxDelay(delayTableL, tapLengthL), maxLengthR = maxDelay(delayTableR, tapLengthR);
+  historySize = (long)(maxLengthL > maxLengthR ? maxLengthL : maxLengthR) + 1;
+  historySlot.alloc(historySize+FV3_EARLYREF_BlockSize, 2);
+  wetSlot.alloc(FV3_EARLYREF_BlockSize, 2);
+  loadTapImpulse();
   mute();
 }
 
+void FV3_(earlyref)::loadTapImpulse()
+{
+  fftMode = false;
+  tapIRL.unloadImpulse(), tapIRR.unloadImpulse();
+  if(tapLengthL == 0||tapLengthR == 0||tapMode == FV3_EARLYREF_TAP_DIRECT) return;
+  if(tapMode == FV3_EARLYREF_TAP_AUTO)
+    {
+      // the direct sum costs one multiply-add per tap and sample
+      long taps = tapLengthL > tapLengthR ? tapLengthL : tapLengthR;
+      if(taps <= FV3_(irmodel5m)::getCost(historySize, FV3_(irmodel5m)::getOptimalFragmentSize(historySize))) return;
+    }
+  FV3_(slot) tapIR;
+  tapIR.alloc(historySize, 2);
+  for(long i = 0;i < tapLengthL;i ++){ tapIR.L[(long)delayTableL[i]] += gainTableL[i]; }
+  for(long i = 0;i < tapLengthR;i ++){ tapIR.R[(long)delayTableR[i]] += gainTableR[i]; }
+  tapIRL.loadImpulse(tapIR.L, historySize);
+  tapIRR.loadImpulse(tapIR.R, historySize);
+  fftMode = true;
+}
+
+void FV3_(earlyref)::setTapMode(long mode)
+{
+  if(mode != FV3_EARLYREF_TAP_AUTO&&mode != FV3_EARLYREF_TAP_DIRECT&&mode != FV3_EARLYREF_TAP_FFT)
+    {
+      std::fprintf(stderr, "earlyref::setTapMode(): invalid mode (%ld)\n", mode);
+      return;
+    }
+  tapMode = mode;
+  loadTapImpulse();
+  mute();
+}
+
+long FV3_(earlyref)::getTapMode()
+{
+  return tapMode;
+}
+
+bool FV3_(earlyref)::getFFTMode()
+{
+  return fftMode;
+}
+
 fv3_float_t FV3_(earlyref)::maxDelay(const fv3_float_t * delaySet, long size)
 {
   fv3_float_t max = 0;
@@ -291,29 +336,63 @@ void FV3_(earlyref)::unloadReflection()
   delete[] delayTableL;
   delete[] delayTableR;
   tapLengthL = tapLengthR = 0;
+  tapIRL.unloadImpulse(), tapIRR.unloadImpulse();
+  fftMode = false;
 }
 
 void FV3_(earlyref)::processreplace(fv3_float_t *inputL, fv3_float_t *inputR, fv3_float_t *outputL, fv3_float_t *outputR, long numsamples)
   
 {
+  FV3_(denormalguard) guard;
   if(numsamples <= 0) return;
   if(tapLengthL == 0||tapLengthR == 0) return;
 
-  while(numsamples-- > 0)
+  while(numsamples > 0)
+    {
+      long count = numsamples < FV3_EARLYREF_BlockSize ? numsamples : FV3_EARLYREF_BlockSize;
+      // the taps only depend on the input, sum them for the whole block first.
+      processTaps(inputL, inputR, count);
+      for(long i = 0;i < count;i ++)
+        {
+          fv3_float_t inL = inputL[i], inR = inputR[i];
+          // width = -1 ~ +1
+          fv3_float_t wetL = delayWL(wetSlot.L[i]), wetR = delayWR(wetSlot.R[i]);
+          outputL[i] = delayL(inL)*dry + out1_lpf(out1_hpf(allpassL2(wet1 * wetL + wet2 * allpassXL(delayRtoL(inR + wetR)))));
+          outputR[i] = delayR(inR)*dry + out2_lpf(out2_hpf(allpassR2(wet1 * wetR + wet2 * allpassXR(delayLtoR(inL + wetL)))));
+        }
+      inputL += count; inputR += count; outputL += count; outputR += count;
+      numsamples -= count;
+    }
+}
+
+void FV3_(earlyref)::processTaps(const fv3_float_t *inputL, const fv3_float_t *inputR, long numsamples)
+{
+  // numsamples <= FV3_EARLYREF_BlockSize
+  if(fftMode)
+    {
+      std::memcpy(wetSlot.L, inputL, sizeof(fv3_float_t)*numsamples);
+      std::memcpy(wetSlot.R, inputR, sizeof(fv3_float_t)*numsamples);
+      tapIRL.processreplace(wetSlot.L, numsamples);
+      tapIRR.processreplace(wetSlot.R, numsamples);
+      return;
+    }
+  processTapBlock(historySlot.L, inputL, wetSlot.L, gainTableL, delayTableL, tapLengthL, numsamples);
+  processTapBlock(historySlot.R, inputR, wetSlot.R, gainTableR, delayTableR, tapLengthR, numsamples);
+}
+
+void FV3_(earlyref)::processTapBlock(fv3_float_t * history, const fv3_float_t * input, fv3_float_t * output,
+                                     const fv3_float_t * gainTable, const fv3_float_t * delayTable, long tapLength, long numsamples)
+{
+  // history[historySize+i] = input[i], the tap of delay d reads history+historySize-d contiguously.
+  std::memcpy(history+historySize, input, sizeof(fv3_float_t)*numsamples);
+  FV3_(utils)::mute(output, numsamples);
+  for(long t = 0;t < tapLength;t ++)
     {
-      *outputL = delayL(*inputL)*dry;
-      *outputR = delayR(*inputR)*dry;
-      fv3_float_t wetL = 0, wetR = 0;
-      delayLineL.process(*inputL);
-      delayLineR.process(*inputR);
-      for(long i = 0;i < tapLengthL;i ++){ wetL += gainTableL[i]*delayLineL.at(delayTableL[i]); }
-      for(long i = 0;i < tapLengthR;i ++){ wetR += gainTableR[i]*delayLineR.at(delayTableR[i]);	}
-      // width = -1 ~ +1
-      wetL = delayWL(wetL); wetR = delayWR(wetR);
-      *outputL += out1_lpf(out1_hpf(allpassL2(wet1 * wetL + wet2 * allpassXL(delayRtoL(*inputR + wetR)))));
-      *outputR += out2_lpf(out2_hpf(allpassR2(wet1 * wetR + wet2 * allpassXR(delayLtoR(*inputL + wetL)))));
-      inputL ++; inputR ++; outputL ++; outputR ++;
+      const fv3_float_t * tap = history+historySize-(long)delayTable[t];
+      fv3_float_t gain = gainTable[t];
+      for(long i = 0;i < numsamples;i ++){ output[i] += gain*tap[i]; }
     }
+  std::memmove(history, history+numsamples, sizeof(fv3_float_t)*historySize);
 }
 
 void FV3_(earlyref)::setLRDelay(fv3_float_t value_ms)
@@ -22,12 +22,14 @@
 #define _FV3_EARLYREF_HPP
 
 #include <cstdio>
+#include <cstring>
 #include <new>
 
 #include "freeverb/fv3_defs.h"
 #include "freeverb/revbase.hpp"
-#include "freeverb/delayline.hpp"
+#include "freeverb/slot.hpp"
 #include "freeverb/biquad.hpp"
+#include "freeverb/irmodel5.hpp"
 
 namespace fv3
 {
@@ -33,6 +33,16 @@ public:
   void loadUserReflection(const _fv3_float_t * delayL, const _fv3_float_t * gainL, const _fv3_float_t * delayR, const _fv3_float_t * gainR, long sizeL, long sizeR)
     ;
   void unloadReflection();
+
+  /**
+   * set the tap processing mode.
+   * FV3_EARLYREF_TAP_DIRECT sums the delayed blocks of every tap,
+   * FV3_EARLYREF_TAP_FFT convolves the sparse impulse of the taps with irmodel5m,
+   * FV3_EARLYREF_TAP_AUTO (default) selects the cheaper one by the irmodel5m cost model.
+   */
+  void setTapMode(long mode);
+  long getTapMode();
+  bool getFFTMode();
   
   void         setLRDelay(_fv3_float_t value_ms);
   _fv3_float_t getLRDelay();
@@ -54,8 +64,16 @@ public:
   virtual void setFsFactors();
 
   _fv3_float_t maxDelay(const _fv3_float_t * delaySet, long size);
+  void loadTapImpulse();
+  void processTaps(const _fv3_float_t *inputL, const _fv3_float_t *inputR, long numsamples);
+  void processTapBlock(_fv3_float_t * history, const _fv3_float_t * input, _fv3_float_t * output,
+                       const _fv3_float_t * gainTable, const _fv3_float_t * delayTable, long tapLength, long numsamples);
   
-  _FV3_(delayline) delayLineL, delayLineR;
+  // historySlot = historySize past inputs + FV3_EARLYREF_BlockSize inputs
+  _FV3_(slot) historySlot, wetSlot;
+  _FV3_(irmodel5m) tapIRL, tapIRR;
+  long tapMode, historySize;
+  bool fftMode;
   _FV3_(delay) delayLtoR, delayRtoL;
   _FV3_(biquad) allpassXL, allpassL2, allpassXR, allpassR2;
   _FV3_(iir_1st) out1_lpf, out2_lpf, out1_hpf, out2_hpf;
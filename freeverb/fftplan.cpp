@@ -0,0 +1,180 @@
+/**
+ *  Process-wide FFTW plan cache
+ *
+ *  Copyright (C) 2006-2018 Teru Kamogashira
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "freeverb/fftplan.hpp"
+#include "freeverb/fv3_type_float.h"
+#include "freeverb/fv3_ns_start.h"
+
+std::vector<FV3_(fftplan)::entry>& FV3_(fftplan)::cache()
+{
+  static std::vector<entry> entries;
+  return entries;
+}
+
+std::mutex& FV3_(fftplan)::cacheLock()
+{
+  static std::mutex m;
+  return m;
+}
+
+FFTW_(plan) FV3_(fftplan)::lookup(long n, fftw_r2r_kind kind, unsigned fftflags, bool inplace, bool split)
+{
+  // cacheLock() must be held
+  std::vector<entry>& entries = cache();
+  for(long i = 0;i < (long)entries.size();i ++)
+    {
+      entry& e = entries[i];
+      if(e.n == n&&e.kind == kind&&e.fftflags == fftflags&&e.inplace == inplace&&e.split == split)
+        {
+          e.refCount ++;
+          return e.plan;
+        }
+    }
+  return NULL;
+}
+
+FFTW_(plan) FV3_(fftplan)::acquire(long n, fftw_r2r_kind kind, unsigned fftflags, bool inplace)
+  
+{
+  std::lock_guard<std::mutex> guard(cacheLock());
+  FFTW_(plan) cached = lookup(n, kind, fftflags, inplace, false);
+  if(cached != NULL) return cached;
+  // FFTW_MEASURE overwrites the arrays, so the plans are made on scratch arrays.
+  fv3_float_t * in = (fv3_float_t*)FV3_(utils)::aligned_malloc(sizeof(fv3_float_t)*n, FV3_PTR_ALIGN_BYTE);
+  fv3_float_t * out = inplace ? in : (fv3_float_t*)FV3_(utils)::aligned_malloc(sizeof(fv3_float_t)*n, FV3_PTR_ALIGN_BYTE);
+  if(in == NULL||out == NULL)
+    {
+      std::fprintf(stderr, "fftplan::acquire(%ld) bad_alloc\n", n);
+      FV3_(utils)::aligned_free(in);
+      if(!inplace) FV3_(utils)::aligned_free(out);
+      throw std::bad_alloc();
+    }
+  entry e;
+  e.n = n, e.kind = kind, e.fftflags = fftflags, e.inplace = inplace, e.split = false, e.refCount = 1;
+  e.plan = FFTW_(plan_r2r_1d)(n, in, out, kind, fftflags);
+  FV3_(utils)::aligned_free(in);
+  if(!inplace) FV3_(utils)::aligned_free(out);
+  if(e.plan == NULL)
+    {
+      std::fprintf(stderr, "fftplan::acquire(%ld): FFTW planner failed.\n", n);
+      throw std::bad_alloc();
+    }
+  cache().push_back(e);
+  return e.plan;
+}
+
+FFTW_(plan) FV3_(fftplan)::acquireSplit(long n, fftw_r2r_kind kind, unsigned fftflags)
+  
+{
+  std::lock_guard<std::mutex> guard(cacheLock());
+  FFTW_(plan) cached = lookup(n, kind, fftflags, false, true);
+  if(cached != NULL) return cached;
+  fv3_float_t * real = (fv3_float_t*)FV3_(utils)::aligned_malloc(sizeof(fv3_float_t)*n, FV3_PTR_ALIGN_BYTE);
+  fv3_float_t * re = (fv3_float_t*)FV3_(utils)::aligned_malloc(sizeof(fv3_float_t)*(n/2+1), FV3_PTR_ALIGN_BYTE);
+  fv3_float_t * im = (fv3_float_t*)FV3_(utils)::aligned_malloc(sizeof(fv3_float_t)*(n/2+1), FV3_PTR_ALIGN_BYTE);
+  if(real == NULL||re == NULL||im == NULL)
+    {
+      std::fprintf(stderr, "fftplan::acquireSplit(%ld) bad_alloc\n", n);
+      FV3_(utils)::aligned_free(real);
+      FV3_(utils)::aligned_free(re);
+      FV3_(utils)::aligned_free(im);
+      throw std::bad_alloc();
+    }
+  FFTW_(iodim) dim;
+  dim.n = n, dim.is = 1, dim.os = 1;
+  entry e;
+  e.n = n, e.kind = kind, e.fftflags = fftflags, e.inplace = false, e.split = true, e.refCount = 1;
+  if(kind == FFTW_R2HC)
+    e.plan = FFTW_(plan_guru_split_dft_r2c)(1, &dim, 0, NULL, real, re, im, fftflags);
+  else
+    e.plan = FFTW_(plan_guru_split_dft_c2r)(1, &dim, 0, NULL, re, im, real, fftflags);
+  FV3_(utils)::aligned_free(real);
+  FV3_(utils)::aligned_free(re);
+  FV3_(utils)::aligned_free(im);
+  if(e.plan == NULL)
+    {
+      std::fprintf(stderr, "fftplan::acquireSplit(%ld): FFTW planner failed.\n", n);
+      throw std::bad_alloc();
+    }
+  cache().push_back(e);
+  return e.plan;
+}
+
+void FV3_(fftplan)::release(FFTW_(plan) plan)
+{
+  std::lock_guard<std::mutex> guard(cacheLock());
+  std::vector<entry>& entries = cache();
+  for(long i = 0;i < (long)entries.size();i ++)
+    {
+      if(entries[i].plan == plan&&entries[i].refCount > 0)
+        {
+          entries[i].refCount --;
+          return;
+        }
+    }
+}
+
+void FV3_(fftplan)::purge()
+{
+  std::lock_guard<std::mutex> guard(cacheLock());
+  std::vector<entry>& entries = cache();
+  for(long i = (long)entries.size()-1;i >= 0;i --)
+    {
+      if(entries[i].refCount > 0) continue;
+      FFTW_(destroy_plan)(entries[i].plan);
+      entries.erase(entries.begin()+i);
+    }
+}
+
+long FV3_(fftplan)::getCachedCount()
+{
+  std::lock_guard<std::mutex> guard(cacheLock());
+  return (long)cache().size();
+}
+
+bool FV3_(fftplan)::importWisdom(const char * filename)
+{
+  std::lock_guard<std::mutex> guard(cacheLock());
+  if(FFTW_(import_wisdom_from_filename)(filename) == 0)
+    {
+      std::fprintf(stderr, "fftplan::importWisdom(%s): failed.\n", filename);
+      return false;
+    }
+  return true;
+}
+
+bool FV3_(fftplan)::exportWisdom(const char * filename)
+{
+  std::lock_guard<std::mutex> guard(cacheLock());
+  if(FFTW_(export_wisdom_to_filename)(filename) == 0)
+    {
+      std::fprintf(stderr, "fftplan::exportWisdom(%s): failed.\n", filename);
+      return false;
+    }
+  return true;
+}
+
+void FV3_(fftplan)::forgetWisdom()
+{
+  std::lock_guard<std::mutex> guard(cacheLock());
+  FFTW_(forget_wisdom)();
+}
+
+#include "freeverb/fv3_ns_end.h"
@@ -0,0 +1,55 @@
+/**
+ *  Process-wide FFTW plan cache
+ *
+ *  Copyright (C) 2006-2018 Teru Kamogashira
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+// The plans are shared by all instances of the same precision and are executed with
+// the new-array execute functions, so the arrays must be FV3_PTR_ALIGN_BYTE aligned
+// and in-place/out-of-place as acquired. All FFTW planner calls of the library go
+// through this class because the planner is not thread-safe.
+class _FV3_(fftplan)
+{
+ public:
+  static _FFTW_(plan) acquire(long n, fftw_r2r_kind kind, unsigned fftflags, bool inplace)
+    ;
+  // out-of-place split complex plan of the real size n (guru split dft interface),
+  // FFTW_R2HC: r2c in[n] -> re[n/2+1], im[n/2+1], FFTW_HC2R: c2r re, im -> out[n]
+  static _FFTW_(plan) acquireSplit(long n, fftw_r2r_kind kind, unsigned fftflags)
+    ;
+  static void release(_FFTW_(plan) plan);
+  // destroy the cached plans which are not acquired
+  static void purge();
+  static long getCachedCount();
+
+  static bool importWisdom(const char * filename);
+  static bool exportWisdom(const char * filename);
+  static void forgetWisdom();
+
+ private:
+  struct entry
+  {
+    long n, refCount;
+    fftw_r2r_kind kind;
+    unsigned fftflags;
+    bool inplace, split;
+    _FFTW_(plan) plan;
+  };
+  static _FFTW_(plan) lookup(long n, fftw_r2r_kind kind, unsigned fftflags, bool inplace, bool split);
+  static std::vector<entry>& cache();
+  static std::mutex& cacheLock();
+};
@@ -20,6 +20,17 @@
 
 #include "freeverb/frag.hpp"
 #include "freeverb/fv3_type_float.h"
+
+// intrinsics kernels are compiled with the target attribute and selected at runtime
+#if defined(ENABLE_X86SIMD)&&defined(__GNUC__)&&(__GNUC__ >= 5||defined(__clang__))
+#include <immintrin.h>
+#define FV3_X86SIMD_INTRINSICS
+#endif
+#if defined(__aarch64__)&&defined(__ARM_NEON)
+#include <arm_neon.h>
+#define FV3_ARMSIMD_NEON
+#endif
+
 #include "freeverb/fv3_ns_start.h"
 
 // class fragfft
@@ -64,17 +75,37 @@ void FV3_(fragfft)::allocFFT(long size, unsigned fftflags)
     }
   freeFFT();
   fftOrig.alloc(2*size, 1);
-  planRevrL = FFTW_(plan_r2r_1d)(2*size, fftOrig.L, fftOrig.L, FFTW_HC2R, fftflags);
-  planOrigL = FFTW_(plan_r2r_1d)(2*size, fftOrig.L, fftOrig.L, FFTW_R2HC, fftflags);
+  if(simdSize == 0)
+    {
+      splitSlot.alloc(size+1, 2);
+      planRevrL = FV3_(fftplan)::acquireSplit(2*size, FFTW_HC2R, fftflags);
+    }
+  else
+    planRevrL = FV3_(fftplan)::acquire(2*size, FFTW_HC2R, fftflags, true);
+  try
+    {
+      if(simdSize == 0)
+        planOrigL = FV3_(fftplan)::acquireSplit(2*size, FFTW_R2HC, fftflags);
+      else
+        planOrigL = FV3_(fftplan)::acquire(2*size, FFTW_R2HC, fftflags, true);
+    }
+  catch(std::bad_alloc)
+    {
+      FV3_(fftplan)::release(planRevrL);
+      fftOrig.free();
+      splitSlot.free();
+      throw;
+    }
   fragmentSize = size;
 }
 
 void FV3_(fragfft)::freeFFT()
 {
   if(fragmentSize == 0) return;
-  FFTW_(destroy_plan)(planRevrL);
-  FFTW_(destroy_plan)(planOrigL);
+  FV3_(fftplan)::release(planRevrL);
+  FV3_(fftplan)::release(planOrigL);
   fftOrig.free();
+  splitSlot.free();
   fragmentSize = 0;
 }
 
@@ -112,7 +143,22 @@ void FV3_(fragfft)::R2HC(const fv3_float_t * iL, fv3_float_t * oL)
   if(fragmentSize == 0) return;
   FV3_(utils)::mute(fftOrig.L+fragmentSize, fragmentSize);
   std::memcpy(fftOrig.L, iL, sizeof(fv3_float_t)*fragmentSize);
-  FFTW_(execute)(planOrigL);
+  if(simdSize == 0)
+    {
+      // [re 0...size (Nyquist)][im 1...size-1]
+      // The real parts are written in place if oL is aligned like the plan. The imaginary
+      // parts are copied, FFTW also writes the zero im 0 and im size which do not fit in oL.
+      if(FFTW_(alignment_of)(oL) == 0)
+        FFTW_(execute_split_dft_r2c)(planOrigL, fftOrig.L, oL, splitSlot.R);
+      else
+        {
+          FFTW_(execute_split_dft_r2c)(planOrigL, fftOrig.L, splitSlot.L, splitSlot.R);
+          std::memcpy(oL, splitSlot.L, sizeof(fv3_float_t)*(fragmentSize+1));
+        }
+      std::memcpy(oL+fragmentSize+1, splitSlot.R+1, sizeof(fv3_float_t)*(fragmentSize-1));
+      return;
+    }
+  FFTW_(execute_r2r)(planOrigL, fftOrig.L, fftOrig.L);
   R2SA(fftOrig.L, oL, fragmentSize*2);
   return;
 }
@@ -151,8 +197,20 @@ void FV3_(fragfft)::SA2R(const fv3_float_t * in, fv3_float_t * out, long n)
 void FV3_(fragfft)::HC2R(const fv3_float_t * iL, fv3_float_t * oL)
 {
   if(fragmentSize == 0) return;
-  SA2R(iL, fftOrig.L, fragmentSize*2);
-  FFTW_(execute)(planRevrL);
+  if(simdSize == 0)
+    {
+      // c2r destroys the input and reads im 0 and im size, so both halves are copied
+      std::memcpy(splitSlot.L, iL, sizeof(fv3_float_t)*(fragmentSize+1));
+      std::memcpy(splitSlot.R+1, iL+fragmentSize+1, sizeof(fv3_float_t)*(fragmentSize-1));
+      splitSlot.R[0] = splitSlot.R[fragmentSize] = 0;
+      FFTW_(execute_split_dft_c2r)(planRevrL, splitSlot.L, splitSlot.R, fftOrig.L);
+    }
+  else
+    {
+      SA2R(iL, fftOrig.L, fragmentSize*2);
+      FFTW_(execute_r2r)(planRevrL, fftOrig.L, fftOrig.L);
+    }
+  // overlap-add, the same for all layouts
   for(long i = 0;i < fragmentSize*2;i ++) oL[i] += fftOrig.L[i];
   return;
 }
@@ -902,6 +960,290 @@ static void MULT_M_D_SSE2(const fv3_float_t * iL, const fv3_float_t * fL, fv3_fl
 #endif
 #endif
 
+// The split array (SA) layout of simdSize S holds S real parts and S imaginary
+// parts in each 2*S block. [0] and [S] of the first block are the DC and the
+// Nyquist frequency, which are real values. The split complex layout
+// (FV3_SIMD_FLAG_SPLIT) is the SA layout of S = n: all the real parts are
+// followed by all the imaginary parts.
+// MULT_SA_* are the kernels of any S (multiple of the vector size),
+// MULT_M_* use the SA layout of the fixed simdSize and MULT_S_* the split layout.
+
+static inline void MULT_SA_VECTOR(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n, long S)
+{
+  fv3_float_t tL0 = oL[0] + iL[0] * fL[0];
+  fv3_float_t tLS = oL[S] + iL[S] * fL[S];
+  for(long b = 0;b < 2*n;b += 2*S)
+    {
+      const fv3_float_t * a = iL+b, * c = fL+b;
+      fv3_float_t * e = oL+b;
+      // no loop carried dependency, the compiler vectorizes this
+      for(long i = 0;i < S;i ++)
+        {
+          fv3_float_t re = a[i]*c[i] - a[S+i]*c[S+i];
+          fv3_float_t im = a[i]*c[S+i] + a[S+i]*c[i];
+          e[i] += re, e[S+i] += im;
+        }
+    }
+  oL[0] = tL0;
+  oL[S] = tLS;
+}
+
+static void MULT_S_VECTOR(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n)
+#ifdef __GNUC__
+  __attribute__((noinline))
+#endif
+  ;
+static void MULT_S_VECTOR(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n)
+{
+  MULT_SA_VECTOR(iL, fL, oL, n, n);
+}
+
+#if defined(LIBFV3_FLOAT)||defined(LIBFV3_DOUBLE)
+static void MULT_M_VECTOR(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n)
+#ifdef __GNUC__
+  __attribute__((noinline))
+#endif
+  ;
+static void MULT_M_VECTOR(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n)
+{
+#ifdef LIBFV3_FLOAT
+  MULT_SA_VECTOR(iL, fL, oL, n, 8);
+#else
+  MULT_SA_VECTOR(iL, fL, oL, n, 4);
+#endif
+}
+#endif
+
+#ifdef FV3_X86SIMD_INTRINSICS
+#ifdef LIBFV3_FLOAT
+static inline void MULT_SA_F_AVX2(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n, long S)
+  __attribute__((always_inline, target("avx2,fma")));
+static inline void MULT_SA_F_AVX2(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n, long S)
+{
+  fv3_float_t tL0 = oL[0] + iL[0] * fL[0];
+  fv3_float_t tLS = oL[S] + iL[S] * fL[S];
+  for(long b = 0;b < 2*n;b += 2*S)
+    {
+      for(long t = b;t < b+S;t += 8)
+        {
+          __m256 A = _mm256_loadu_ps(iL+t), B = _mm256_loadu_ps(iL+t+S);
+          __m256 C = _mm256_loadu_ps(fL+t), D = _mm256_loadu_ps(fL+t+S);
+          __m256 E = _mm256_loadu_ps(oL+t), F = _mm256_loadu_ps(oL+t+S);
+          E = _mm256_fnmadd_ps(B, D, _mm256_fmadd_ps(A, C, E)); // E += A*C-B*D
+          F = _mm256_fmadd_ps(B, C, _mm256_fmadd_ps(A, D, F));  // F += A*D+B*C
+          _mm256_storeu_ps(oL+t, E);
+          _mm256_storeu_ps(oL+t+S, F);
+        }
+    }
+  oL[0] = tL0;
+  oL[S] = tLS;
+}
+
+static void MULT_M_F_AVX2(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n)
+  __attribute__((noinline, target("avx2,fma")));
+static void MULT_M_F_AVX2(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n)
+{
+  MULT_SA_F_AVX2(iL, fL, oL, n, 8);
+}
+
+static void MULT_S_F_AVX2(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n)
+  __attribute__((noinline, target("avx2,fma")));
+static void MULT_S_F_AVX2(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n)
+{
+  MULT_SA_F_AVX2(iL, fL, oL, n, n);
+}
+
+static inline void MULT_SA_F_AVX512F(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n, long S)
+  __attribute__((always_inline, target("avx512f")));
+static inline void MULT_SA_F_AVX512F(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n, long S)
+{
+  fv3_float_t tL0 = oL[0] + iL[0] * fL[0];
+  fv3_float_t tLS = oL[S] + iL[S] * fL[S];
+  for(long b = 0;b < 2*n;b += 2*S)
+    {
+      for(long t = b;t < b+S;t += 16)
+        {
+          __m512 A = _mm512_loadu_ps(iL+t), B = _mm512_loadu_ps(iL+t+S);
+          __m512 C = _mm512_loadu_ps(fL+t), D = _mm512_loadu_ps(fL+t+S);
+          __m512 E = _mm512_loadu_ps(oL+t), F = _mm512_loadu_ps(oL+t+S);
+          E = _mm512_fnmadd_ps(B, D, _mm512_fmadd_ps(A, C, E));
+          F = _mm512_fmadd_ps(B, C, _mm512_fmadd_ps(A, D, F));
+          _mm512_storeu_ps(oL+t, E);
+          _mm512_storeu_ps(oL+t+S, F);
+        }
+    }
+  oL[0] = tL0;
+  oL[S] = tLS;
+}
+
+static void MULT_M_F_AVX512F(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n)
+  __attribute__((noinline, target("avx512f")));
+static void MULT_M_F_AVX512F(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n)
+{
+  MULT_SA_F_AVX512F(iL, fL, oL, n, 16);
+}
+
+static void MULT_S_F_AVX512F(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n)
+  __attribute__((noinline, target("avx512f")));
+static void MULT_S_F_AVX512F(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n)
+{
+  MULT_SA_F_AVX512F(iL, fL, oL, n, n);
+}
+#endif
+
+#ifdef LIBFV3_DOUBLE
+static inline void MULT_SA_D_AVX2(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n, long S)
+  __attribute__((always_inline, target("avx2,fma")));
+static inline void MULT_SA_D_AVX2(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n, long S)
+{
+  fv3_float_t tL0 = oL[0] + iL[0] * fL[0];
+  fv3_float_t tLS = oL[S] + iL[S] * fL[S];
+  for(long b = 0;b < 2*n;b += 2*S)
+    {
+      for(long t = b;t < b+S;t += 4)
+        {
+          __m256d A = _mm256_loadu_pd(iL+t), B = _mm256_loadu_pd(iL+t+S);
+          __m256d C = _mm256_loadu_pd(fL+t), D = _mm256_loadu_pd(fL+t+S);
+          __m256d E = _mm256_loadu_pd(oL+t), F = _mm256_loadu_pd(oL+t+S);
+          E = _mm256_fnmadd_pd(B, D, _mm256_fmadd_pd(A, C, E));
+          F = _mm256_fmadd_pd(B, C, _mm256_fmadd_pd(A, D, F));
+          _mm256_storeu_pd(oL+t, E);
+          _mm256_storeu_pd(oL+t+S, F);
+        }
+    }
+  oL[0] = tL0;
+  oL[S] = tLS;
+}
+
+static void MULT_M_D_AVX2(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n)
+  __attribute__((noinline, target("avx2,fma")));
+static void MULT_M_D_AVX2(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n)
+{
+  MULT_SA_D_AVX2(iL, fL, oL, n, 4);
+}
+
+static void MULT_S_D_AVX2(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n)
+  __attribute__((noinline, target("avx2,fma")));
+static void MULT_S_D_AVX2(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n)
+{
+  MULT_SA_D_AVX2(iL, fL, oL, n, n);
+}
+
+static inline void MULT_SA_D_AVX512F(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n, long S)
+  __attribute__((always_inline, target("avx512f")));
+static inline void MULT_SA_D_AVX512F(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n, long S)
+{
+  fv3_float_t tL0 = oL[0] + iL[0] * fL[0];
+  fv3_float_t tLS = oL[S] + iL[S] * fL[S];
+  for(long b = 0;b < 2*n;b += 2*S)
+    {
+      for(long t = b;t < b+S;t += 8)
+        {
+          __m512d A = _mm512_loadu_pd(iL+t), B = _mm512_loadu_pd(iL+t+S);
+          __m512d C = _mm512_loadu_pd(fL+t), D = _mm512_loadu_pd(fL+t+S);
+          __m512d E = _mm512_loadu_pd(oL+t), F = _mm512_loadu_pd(oL+t+S);
+          E = _mm512_fnmadd_pd(B, D, _mm512_fmadd_pd(A, C, E));
+          F = _mm512_fmadd_pd(B, C, _mm512_fmadd_pd(A, D, F));
+          _mm512_storeu_pd(oL+t, E);
+          _mm512_storeu_pd(oL+t+S, F);
+        }
+    }
+  oL[0] = tL0;
+  oL[S] = tLS;
+}
+
+static void MULT_M_D_AVX512F(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n)
+  __attribute__((noinline, target("avx512f")));
+static void MULT_M_D_AVX512F(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n)
+{
+  MULT_SA_D_AVX512F(iL, fL, oL, n, 8);
+}
+
+static void MULT_S_D_AVX512F(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n)
+  __attribute__((noinline, target("avx512f")));
+static void MULT_S_D_AVX512F(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n)
+{
+  MULT_SA_D_AVX512F(iL, fL, oL, n, n);
+}
+#endif
+#endif
+
+#ifdef FV3_ARMSIMD_NEON
+#ifdef LIBFV3_FLOAT
+static inline void MULT_SA_F_NEON(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n, long S)
+{
+  fv3_float_t tL0 = oL[0] + iL[0] * fL[0];
+  fv3_float_t tLS = oL[S] + iL[S] * fL[S];
+  for(long b = 0;b < 2*n;b += 2*S)
+    {
+      for(long t = b;t < b+S;t += 4)
+        {
+          float32x4_t A = vld1q_f32(iL+t), B = vld1q_f32(iL+t+S);
+          float32x4_t C = vld1q_f32(fL+t), D = vld1q_f32(fL+t+S);
+          float32x4_t E = vld1q_f32(oL+t), F = vld1q_f32(oL+t+S);
+          E = vfmsq_f32(vfmaq_f32(E, A, C), B, D); // E += A*C-B*D
+          F = vfmaq_f32(vfmaq_f32(F, A, D), B, C); // F += A*D+B*C
+          vst1q_f32(oL+t, E);
+          vst1q_f32(oL+t+S, F);
+        }
+    }
+  oL[0] = tL0;
+  oL[S] = tLS;
+}
+
+static void MULT_M_F_NEON(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n)
+  __attribute__((noinline));
+static void MULT_M_F_NEON(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n)
+{
+  MULT_SA_F_NEON(iL, fL, oL, n, 4);
+}
+
+static void MULT_S_F_NEON(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n)
+  __attribute__((noinline));
+static void MULT_S_F_NEON(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n)
+{
+  MULT_SA_F_NEON(iL, fL, oL, n, n);
+}
+#endif
+
+#ifdef LIBFV3_DOUBLE
+static inline void MULT_SA_D_NEON(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n, long S)
+{
+  fv3_float_t tL0 = oL[0] + iL[0] * fL[0];
+  fv3_float_t tLS = oL[S] + iL[S] * fL[S];
+  for(long b = 0;b < 2*n;b += 2*S)
+    {
+      for(long t = b;t < b+S;t += 2)
+        {
+          float64x2_t A = vld1q_f64(iL+t), B = vld1q_f64(iL+t+S);
+          float64x2_t C = vld1q_f64(fL+t), D = vld1q_f64(fL+t+S);
+          float64x2_t E = vld1q_f64(oL+t), F = vld1q_f64(oL+t+S);
+          E = vfmsq_f64(vfmaq_f64(E, A, C), B, D);
+          F = vfmaq_f64(vfmaq_f64(F, A, D), B, C);
+          vst1q_f64(oL+t, E);
+          vst1q_f64(oL+t+S, F);
+        }
+    }
+  oL[0] = tL0;
+  oL[S] = tLS;
+}
+
+static void MULT_M_D_NEON(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n)
+  __attribute__((noinline));
+static void MULT_M_D_NEON(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n)
+{
+  MULT_SA_D_NEON(iL, fL, oL, n, 2);
+}
+
+static void MULT_S_D_NEON(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n)
+  __attribute__((noinline));
+static void MULT_S_D_NEON(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n)
+{
+  MULT_SA_D_NEON(iL, fL, oL, n, n);
+}
+#endif
+#endif
+
 static void MULT_M_FPU(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long n)
 #ifdef __GNUC__
   __attribute__((noinline))
@@ -938,6 +1280,8 @@ uint32_t FV3_(frag)::getSIMD(uint32_t select)
   return 0;
 }
 
+static FV3_(MULT_T) selectMULT(uint32_t simdFlag1, uint32_t simdFlag2, uint32_t * flag1, uint32_t * flag2);
+
 void FV3_(fragfft)::setSIMD(uint32_t flag1, uint32_t flag2)
 {
   // flag1 == NULL or unsupported Instruction -> Autodetect
@@ -953,6 +1297,13 @@ void FV3_(fragfft)::setSIMD(uint32_t flag1, uint32_t flag2)
   simdFlag2 = flag2;
   
   simdSize = 1, flag1 = FV3_X86SIMD_FLAG_FPU, flag2 = FV3_X86SIMD_NULL;
+
+#ifdef LIBFV3_FLOAT
+  if(simdFlag1&FV3_SIMD_FLAG_VECTOR)   simdSize = 8, flag1 = FV3_SIMD_FLAG_VECTOR;
+#endif
+#ifdef LIBFV3_DOUBLE
+  if(simdFlag1&FV3_SIMD_FLAG_VECTOR)   simdSize = 4, flag1 = FV3_SIMD_FLAG_VECTOR;
+#endif
     
 #ifdef LIBFV3_FLOAT
 #ifdef ENABLE_X86SIMD
@@ -962,6 +1313,10 @@ void FV3_(fragfft)::setSIMD(uint32_t flag1, uint32_t flag2)
   if(simdFlag1&FV3_X86SIMD_FLAG_AVX)   simdSize = 8, flag1 = FV3_X86SIMD_FLAG_AVX;
   if(simdFlag1&FV3_X86SIMD_FLAG_FMA3)  simdSize = 8, flag1 = FV3_X86SIMD_FLAG_FMA3;
   if(simdFlag1&FV3_X86SIMD_FLAG_FMA4)  simdSize = 8, flag1 = FV3_X86SIMD_FLAG_FMA4;
+#ifdef FV3_X86SIMD_INTRINSICS
+  if(simdFlag1&FV3_X86SIMD_FLAG_AVX2)   simdSize = 8, flag1 = FV3_X86SIMD_FLAG_AVX2;
+  if(simdFlag1&FV3_X86SIMD_FLAG_AVX512F)simdSize = 16, flag1 = FV3_X86SIMD_FLAG_AVX512F;
+#endif
 
   // override SSE_V1 option
   if((simdFlag1&FV3_X86SIMD_FLAG_SSE)&&(simdFlag2&FV3_X86SIMD_FLAG_SSE_V1))
@@ -976,51 +1331,123 @@ void FV3_(fragfft)::setSIMD(uint32_t flag1, uint32_t flag2)
   if(simdFlag1&FV3_X86SIMD_FLAG_AVX)   simdSize = 4, flag1 = FV3_X86SIMD_FLAG_AVX;
   if(simdFlag1&FV3_X86SIMD_FLAG_FMA3)  simdSize = 4, flag1 = FV3_X86SIMD_FLAG_FMA3;
   if(simdFlag1&FV3_X86SIMD_FLAG_FMA4)  simdSize = 4, flag1 = FV3_X86SIMD_FLAG_FMA4;
+#ifdef FV3_X86SIMD_INTRINSICS
+  if(simdFlag1&FV3_X86SIMD_FLAG_AVX2)   simdSize = 4, flag1 = FV3_X86SIMD_FLAG_AVX2;
+  if(simdFlag1&FV3_X86SIMD_FLAG_AVX512F)simdSize = 8, flag1 = FV3_X86SIMD_FLAG_AVX512F;
 #endif
 #endif
+#endif
+
+#ifdef FV3_ARMSIMD_NEON
+#ifdef LIBFV3_FLOAT
+  if(simdFlag1&FV3_SIMD_FLAG_NEON)      simdSize = 4, flag1 = FV3_SIMD_FLAG_NEON;
+#endif
+#ifdef LIBFV3_DOUBLE
+  if(simdFlag1&FV3_SIMD_FLAG_NEON)      simdSize = 2, flag1 = FV3_SIMD_FLAG_NEON;
+#endif
+#endif
+
+  // split complex spectra
+  if(simdFlag2&FV3_SIMD_FLAG_SPLIT)
+    {
+      selectMULT(simdFlag1, simdFlag2, &flag1, &flag2);
+      simdSize = 0;
+    }
   simdFlag1 = flag1, simdFlag2 = flag2;
 }
 
-void FV3_(frag)::setSIMD(uint32_t flag1, uint32_t flag2)
+static FV3_(MULT_T) selectMULT(uint32_t simdFlag1, uint32_t simdFlag2, uint32_t * flag1, uint32_t * flag2)
 {
-  // flag1 == NULL or unsupported Instruction -> Autodetect
-  if(flag1 == FV3_X86SIMD_NULL)
-    simdFlag1 = FV3_(utils)::getSIMDFlag();
-  else if(!(flag1 & FV3_(utils)::getSIMDFlag()))
-    {
-      std::fprintf(stderr, "frag::setSIMD(%08x): not supported, autodetected.\n", flag1);
-      simdFlag1 = FV3_(utils)::getSIMDFlag();
-    }
-  else
-    simdFlag1 = flag1;
-  simdFlag2 = flag2;
+  FV3_(MULT_T) MULT_M = MULT_M_FPU;
+  *flag1 = FV3_X86SIMD_FLAG_FPU, *flag2 = FV3_X86SIMD_NULL;
 
-  MULT_M = MULT_M_FPU, flag1 = FV3_X86SIMD_FLAG_FPU, flag2 = FV3_X86SIMD_NULL;
+#if defined(LIBFV3_FLOAT)||defined(LIBFV3_DOUBLE)
+  if(simdFlag1&FV3_SIMD_FLAG_VECTOR)   MULT_M = MULT_M_VECTOR,    *flag1 = FV3_SIMD_FLAG_VECTOR;
+#endif
     
 #ifdef LIBFV3_FLOAT
 #ifdef ENABLE_X86SIMD
-  if(simdFlag1&FV3_X86SIMD_FLAG_3DNOWP)MULT_M = MULT_M_F_3DNOW,  flag1 = FV3_X86SIMD_FLAG_3DNOWP;
-  if(simdFlag1&FV3_X86SIMD_FLAG_SSE)   MULT_M = MULT_M_F_SSE_V2, flag1 = FV3_X86SIMD_FLAG_SSE;
-  if(simdFlag1&FV3_X86SIMD_FLAG_SSE3)  MULT_M = MULT_M_F_SSE3,   flag1 = FV3_X86SIMD_FLAG_SSE3;
-  if(simdFlag1&FV3_X86SIMD_FLAG_AVX)   MULT_M = MULT_M_F_AVX,    flag1 = FV3_X86SIMD_FLAG_AVX;
-  if(simdFlag1&FV3_X86SIMD_FLAG_FMA3)  MULT_M = MULT_M_F_FMA3,   flag1 = FV3_X86SIMD_FLAG_FMA3;
-  if(simdFlag1&FV3_X86SIMD_FLAG_FMA4)  MULT_M = MULT_M_F_FMA4,   flag1 = FV3_X86SIMD_FLAG_FMA4;
+  if(simdFlag1&FV3_X86SIMD_FLAG_3DNOWP)MULT_M = MULT_M_F_3DNOW,  *flag1 = FV3_X86SIMD_FLAG_3DNOWP;
+  if(simdFlag1&FV3_X86SIMD_FLAG_SSE)   MULT_M = MULT_M_F_SSE_V2, *flag1 = FV3_X86SIMD_FLAG_SSE;
+  if(simdFlag1&FV3_X86SIMD_FLAG_SSE3)  MULT_M = MULT_M_F_SSE3,   *flag1 = FV3_X86SIMD_FLAG_SSE3;
+  if(simdFlag1&FV3_X86SIMD_FLAG_AVX)   MULT_M = MULT_M_F_AVX,    *flag1 = FV3_X86SIMD_FLAG_AVX;
+  if(simdFlag1&FV3_X86SIMD_FLAG_FMA3)  MULT_M = MULT_M_F_FMA3,   *flag1 = FV3_X86SIMD_FLAG_FMA3;
+  if(simdFlag1&FV3_X86SIMD_FLAG_FMA4)  MULT_M = MULT_M_F_FMA4,   *flag1 = FV3_X86SIMD_FLAG_FMA4;
+#ifdef FV3_X86SIMD_INTRINSICS
+  if(simdFlag1&FV3_X86SIMD_FLAG_AVX2)   MULT_M = MULT_M_F_AVX2,    *flag1 = FV3_X86SIMD_FLAG_AVX2;
+  if(simdFlag1&FV3_X86SIMD_FLAG_AVX512F)MULT_M = MULT_M_F_AVX512F, *flag1 = FV3_X86SIMD_FLAG_AVX512F;
+#endif
 
   // override SSE_V1 option
   if((simdFlag1&FV3_X86SIMD_FLAG_SSE)&&(simdFlag2&FV3_X86SIMD_FLAG_SSE_V1))
-    MULT_M = MULT_M_F_SSE, flag1 = FV3_X86SIMD_FLAG_SSE, flag2 = FV3_X86SIMD_FLAG_SSE_V1;
+    MULT_M = MULT_M_F_SSE, *flag1 = FV3_X86SIMD_FLAG_SSE, *flag2 = FV3_X86SIMD_FLAG_SSE_V1;
 #endif
 #endif
 
 #ifdef LIBFV3_DOUBLE
 #ifdef ENABLE_X86SIMD
-  if(simdFlag1&FV3_X86SIMD_FLAG_SSE2)  MULT_M = MULT_M_D_SSE2, flag1 = FV3_X86SIMD_FLAG_SSE2;
-  if(simdFlag1&FV3_X86SIMD_FLAG_SSE4_1)MULT_M = MULT_M_D_SSE4, flag1 = FV3_X86SIMD_FLAG_SSE4_1;
-  if(simdFlag1&FV3_X86SIMD_FLAG_AVX)   MULT_M = MULT_M_D_AVX,  flag1 = FV3_X86SIMD_FLAG_AVX;
-  if(simdFlag1&FV3_X86SIMD_FLAG_FMA3)  MULT_M = MULT_M_D_FMA3, flag1 = FV3_X86SIMD_FLAG_FMA3;
-  if(simdFlag1&FV3_X86SIMD_FLAG_FMA4)  MULT_M = MULT_M_D_FMA4, flag1 = FV3_X86SIMD_FLAG_FMA4;
+  if(simdFlag1&FV3_X86SIMD_FLAG_SSE2)  MULT_M = MULT_M_D_SSE2, *flag1 = FV3_X86SIMD_FLAG_SSE2;
+  if(simdFlag1&FV3_X86SIMD_FLAG_SSE4_1)MULT_M = MULT_M_D_SSE4, *flag1 = FV3_X86SIMD_FLAG_SSE4_1;
+  if(simdFlag1&FV3_X86SIMD_FLAG_AVX)   MULT_M = MULT_M_D_AVX,  *flag1 = FV3_X86SIMD_FLAG_AVX;
+  if(simdFlag1&FV3_X86SIMD_FLAG_FMA3)  MULT_M = MULT_M_D_FMA3, *flag1 = FV3_X86SIMD_FLAG_FMA3;
+  if(simdFlag1&FV3_X86SIMD_FLAG_FMA4)  MULT_M = MULT_M_D_FMA4, *flag1 = FV3_X86SIMD_FLAG_FMA4;
+#ifdef FV3_X86SIMD_INTRINSICS
+  if(simdFlag1&FV3_X86SIMD_FLAG_AVX2)   MULT_M = MULT_M_D_AVX2,    *flag1 = FV3_X86SIMD_FLAG_AVX2;
+  if(simdFlag1&FV3_X86SIMD_FLAG_AVX512F)MULT_M = MULT_M_D_AVX512F, *flag1 = FV3_X86SIMD_FLAG_AVX512F;
+#endif
+#endif
+#endif
+
+#ifdef FV3_ARMSIMD_NEON
+#ifdef LIBFV3_FLOAT
+  if(simdFlag1&FV3_SIMD_FLAG_NEON)      MULT_M = MULT_M_F_NEON,    *flag1 = FV3_SIMD_FLAG_NEON;
+#endif
+#ifdef LIBFV3_DOUBLE
+  if(simdFlag1&FV3_SIMD_FLAG_NEON)      MULT_M = MULT_M_D_NEON,    *flag1 = FV3_SIMD_FLAG_NEON;
+#endif
+#endif
+
+  if(simdFlag2&FV3_SIMD_FLAG_SPLIT)
+    {
+      MULT_M = MULT_S_VECTOR, *flag2 = FV3_SIMD_FLAG_SPLIT;
+      *flag1 = (simdFlag1&FV3_SIMD_FLAG_VECTOR) ? FV3_SIMD_FLAG_VECTOR : FV3_X86SIMD_FLAG_FPU;
+#ifdef FV3_X86SIMD_INTRINSICS
+#ifdef LIBFV3_FLOAT
+      if(simdFlag1&FV3_X86SIMD_FLAG_AVX2)   MULT_M = MULT_S_F_AVX2,    *flag1 = FV3_X86SIMD_FLAG_AVX2;
+      if(simdFlag1&FV3_X86SIMD_FLAG_AVX512F)MULT_M = MULT_S_F_AVX512F, *flag1 = FV3_X86SIMD_FLAG_AVX512F;
+#endif
+#ifdef LIBFV3_DOUBLE
+      if(simdFlag1&FV3_X86SIMD_FLAG_AVX2)   MULT_M = MULT_S_D_AVX2,    *flag1 = FV3_X86SIMD_FLAG_AVX2;
+      if(simdFlag1&FV3_X86SIMD_FLAG_AVX512F)MULT_M = MULT_S_D_AVX512F, *flag1 = FV3_X86SIMD_FLAG_AVX512F;
+#endif
 #endif
+#ifdef FV3_ARMSIMD_NEON
+#ifdef LIBFV3_FLOAT
+      if(simdFlag1&FV3_SIMD_FLAG_NEON)      MULT_M = MULT_S_F_NEON,    *flag1 = FV3_SIMD_FLAG_NEON;
+#endif
+#ifdef LIBFV3_DOUBLE
+      if(simdFlag1&FV3_SIMD_FLAG_NEON)      MULT_M = MULT_S_D_NEON,    *flag1 = FV3_SIMD_FLAG_NEON;
 #endif
+#endif
+    }
+  return MULT_M;
+}
+
+void FV3_(frag)::setSIMD(uint32_t flag1, uint32_t flag2)
+{
+  // flag1 == NULL or unsupported Instruction -> Autodetect
+  if(flag1 == FV3_X86SIMD_NULL)
+    simdFlag1 = FV3_(utils)::getSIMDFlag();
+  else if(!(flag1 & FV3_(utils)::getSIMDFlag()))
+    {
+      std::fprintf(stderr, "frag::setSIMD(%08x): not supported, autodetected.\n", flag1);
+      simdFlag1 = FV3_(utils)::getSIMDFlag();
+    }
+  else
+    simdFlag1 = flag1;
+  simdFlag2 = flag2;
+
+  MULT_M = selectMULT(simdFlag1, simdFlag2, &flag1, &flag2);
   simdFlag1 = flag1, simdFlag2 = flag2;
 }
 
@@ -1042,4 +1469,268 @@ long FV3_(frag)::getFragmentSize()
   return fragmentSize;
 }
 
+// class fragfdl
+
+FV3_(fragfdl)::FV3_(fragfdl)()
+{
+  fragmentSize = fragmentCount = blockSize = blockCount = cur = 0;
+  simdSize = 1;
+  impulseL = NULL;
+  delayLine = this;
+  setSpectra(NULL, 0, 0, 0);
+  setSIMD(0,0);
+}
+
+FV3_(fragfdl)::FV3_(~fragfdl)()
+{
+  unloadImpulse();
+}
+
+void FV3_(fragfdl)::setSIMD(uint32_t flag1, uint32_t flag2)
+{
+  // The layout of the spectra follows fragfft.
+  FV3_(fragfft) fragFFT;
+  fragFFT.setSIMD(flag1, flag2);
+  simdSize = fragFFT.getSIMDSize();
+  MULT_M = selectMULT(fragFFT.getSIMD(0), fragFFT.getSIMD(1), &simdFlag1, &simdFlag2);
+}
+
+uint32_t FV3_(fragfdl)::getSIMD(uint32_t select)
+{
+  if(select == 0) return simdFlag1;
+  if(select == 1) return simdFlag2;
+  return 0;
+}
+
+void FV3_(fragfdl)::loadImpulse(const fv3_float_t * L, long size, long limit, unsigned fftflags)
+{
+#ifdef DEBUG
+  std::fprintf(stderr, "fragfdl::loadImpulse(f=%ld,l=%ld)\n", size, limit);
+#endif
+  if(FV3_IR_Min_FragmentSize > size)
+    {
+      std::fprintf(stderr, "fragfdl::loadImpulse(f=%ld,l=%ld): fragmentSize(>%d) is too small.\n", size, limit, FV3_IR_Min_FragmentSize);
+      throw std::bad_alloc();
+    }
+  if(size != FV3_(utils)::checkPow2(size))
+    {
+      std::fprintf(stderr, "fragfdl::loadImpulse(f=%ld,l=%ld): fragmentSize must be 2^n.\n", size, limit);
+      throw std::bad_alloc();
+    }
+  unloadImpulse();
+  if(limit <= 0) return;
+  long count = limit/size + (limit%size != 0 ? 1 : 0);
+  // the split complex spectra are not divided into bin blocks
+  long bsize = (simdSize == 0||2*size < FV3_FDL_BlockSize) ? 2*size : FV3_FDL_BlockSize;
+  if(spectraL != NULL&&spectraSize == size&&spectraCount == count&&spectraSIMD == simdSize)
+    {
+      try
+        {
+          delayBlock.alloc(2*size*count, 1);
+        }
+      catch(std::bad_alloc)
+        {
+          std::fprintf(stderr, "fragfdl::loadImpulse(f=%ld,l=%ld) bad_alloc\n", size, limit);
+          unloadImpulse();
+          throw;
+        }
+      fragmentSize = size, fragmentCount = count;
+      blockSize = bsize, blockCount = 2*size/bsize;
+      impulseL = spectraL;
+      mute();
+      return;
+    }
+  FV3_(fragfft) fragFFT;
+  fragFFT.setSIMD(simdFlag1, simdFlag2);
+  FV3_(slot) impulse, spectrum;
+  try
+    {
+      fragFFT.allocFFT(size, fftflags);
+      impulse.alloc(size, 1);
+      spectrum.alloc(2*size, 1);
+      impulseBlock.alloc(2*size*count, 1);
+      delayBlock.alloc(2*size*count, 1);
+    }
+  catch(std::bad_alloc)
+    {
+      std::fprintf(stderr, "fragfdl::loadImpulse(f=%ld,l=%ld) bad_alloc\n", size, limit);
+      unloadImpulse();
+      throw;
+    }
+  fragmentSize = size, fragmentCount = count;
+  blockSize = bsize, blockCount = 2*size/bsize;
+  impulseL = impulseBlock.L;
+  for(long i = 0;i < count;i ++)
+    {
+      long n = limit - size*i < size ? limit - size*i : size;
+      impulse.mute();
+      for(long t = 0;t < n;t ++){ impulse.L[t] = L[size*i+t] / (fv3_float_t)(size*2); }
+      fragFFT.R2HC(impulse.L, spectrum.L);
+      for(long b = 0;b < blockCount;b ++)
+        std::memcpy(impulseBlock.L+(b*fragmentCount+i)*blockSize, spectrum.L+b*blockSize, sizeof(fv3_float_t)*blockSize);
+    }
+  mute();
+}
+
+void FV3_(fragfdl)::setSpectra(const fv3_float_t * block, long size, long count, long simd)
+{
+  spectraL = block;
+  spectraSize = size, spectraCount = count, spectraSIMD = simd;
+}
+
+void FV3_(fragfdl)::unloadImpulse()
+{
+  delayLine = this;
+  if(fragmentSize == 0) return;
+  impulseBlock.free();
+  delayBlock.free();
+  impulseL = NULL;
+  fragmentSize = fragmentCount = blockSize = blockCount = cur = 0;
+}
+
+void FV3_(fragfdl)::mute()
+{
+  if(delayLine != this) return;
+  delayBlock.mute();
+  cur = 0;
+}
+
+long FV3_(fragfdl)::getFragmentSize()
+{
+  return fragmentSize;
+}
+
+long FV3_(fragfdl)::getFragmentCount()
+{
+  return fragmentCount;
+}
+
+long FV3_(fragfdl)::getBlockCount()
+{
+  return blockCount;
+}
+
+long FV3_(fragfdl)::getSIMDSize()
+{
+  return simdSize;
+}
+
+const fv3_float_t * FV3_(fragfdl)::getImpulseBlock()
+{
+  return impulseL;
+}
+
+long FV3_(fragfdl)::getImpulseBlockSize()
+{
+  return 2*fragmentSize*fragmentCount;
+}
+
+void FV3_(fragfdl)::push(const fv3_float_t * iL)
+{
+  if(fragmentCount == 0||delayLine != this) return;
+  cur = (cur + 1) % fragmentCount;
+  for(long b = 0;b < blockCount;b ++)
+    std::memcpy(delayBlock.L+(b*fragmentCount+cur)*blockSize, iL+b*blockSize, sizeof(fv3_float_t)*blockSize);
+}
+
+void FV3_(fragfdl)::MULT_B(const fv3_float_t * iL, const fv3_float_t * fL, fv3_float_t * oL, long block)
+{
+  // MULT_M treats [0] and [simdSize] as the DC and the Nyquist frequency,
+  // which are the normal complex values except in the first block.
+  if(block == 0)
+    {
+      MULT_M(iL, fL, oL, blockSize/2);
+      return;
+    }
+  fv3_float_t o0 = oL[0], os = oL[simdSize];
+  MULT_M(iL, fL, oL, blockSize/2);
+  oL[0] = o0 + iL[0]*fL[0] - iL[simdSize]*fL[simdSize];
+  oL[simdSize] = os + iL[0]*fL[simdSize] + iL[simdSize]*fL[0];
+}
+
+void FV3_(fragfdl)::MULT(long begin, long end, long shift, fv3_float_t * oL)
+{
+  MULT(begin, end, shift, oL, 0, blockCount);
+}
+
+void FV3_(fragfdl)::MULT(long begin, long end, long shift, fv3_float_t * oL, long blockBegin, long blockEnd)
+{
+  if(begin < 0) begin = 0;
+  if(end > fragmentCount) end = fragmentCount;
+  if(blockBegin < 0) blockBegin = 0;
+  if(blockEnd > blockCount) blockEnd = blockCount;
+  if(begin >= end) return;
+  for(long b = blockBegin;b < blockEnd;b ++)
+    {
+      const fv3_float_t * fL = impulseL+b*fragmentCount*blockSize;
+      const fv3_float_t * dL = delayLine->delayBlock.L+b*fragmentCount*blockSize;
+      fv3_float_t * bL = oL+b*blockSize;
+      long slot = (delayLine->cur + fragmentCount*2 - begin + shift) % fragmentCount;
+      for(long i = begin;i < end;i ++)
+        {
+          MULT_B(dL+slot*blockSize, fL+i*blockSize, bL, b);
+          slot = (slot == 0 ? fragmentCount - 1 : slot - 1);
+        }
+    }
+}
+
+void FV3_(fragfdl)::MULT(FV3_(fragfdl) ** fdl, long count, long begin, long end, long shift, fv3_float_t ** oL)
+{
+  if(count <= 0) return;
+  FV3_(fragfdl) * lead = fdl[0];
+  for(long k = 1;k < count;k ++)
+    {
+      if(fdl[k]->impulseL != lead->impulseL||fdl[k]->fragmentCount != lead->fragmentCount||fdl[k]->blockSize != lead->blockSize)
+        {
+          // the impulse is not shared
+          for(long j = 0;j < count;j ++) fdl[j]->MULT(begin, end, shift, oL[j]);
+          return;
+        }
+    }
+  long fragmentCount = lead->fragmentCount, blockSize = lead->blockSize;
+  if(begin < 0) begin = 0;
+  if(end > fragmentCount) end = fragmentCount;
+  if(begin >= end) return;
+  for(long b = 0;b < lead->blockCount;b ++)
+    {
+      const fv3_float_t * fL = lead->impulseL+b*fragmentCount*blockSize;
+      for(long i = begin;i < end;i ++)
+        {
+          for(long k = 0;k < count;k ++)
+            {
+              FV3_(fragfdl) * line = fdl[k]->delayLine;
+              long slot = (line->cur + fragmentCount*2 - i + shift) % fragmentCount;
+              fdl[k]->MULT_B(line->delayBlock.L+(b*fragmentCount+slot)*blockSize, fL+i*blockSize, oL[k]+b*blockSize, b);
+            }
+        }
+    }
+}
+
+void FV3_(fragfdl)::MULT(long i, const fv3_float_t * iL, fv3_float_t * oL)
+{
+  if(i < 0||i >= fragmentCount) return;
+  for(long b = 0;b < blockCount;b ++)
+    MULT_B(iL+b*blockSize, impulseL+(b*fragmentCount+i)*blockSize, oL+b*blockSize, b);
+}
+
+bool FV3_(fragfdl)::shareDelay(FV3_(fragfdl) * source)
+  
+{
+  if(source == this) source = NULL;
+  if(source == NULL)
+    {
+      if(delayLine == this) return true;
+      std::memcpy(delayBlock.L, delayLine->delayBlock.L, sizeof(fv3_float_t)*2*fragmentSize*fragmentCount);
+      cur = delayLine->cur;
+      delayLine = this;
+      return true;
+    }
+  if(source->delayLine != source||source->fragmentSize != fragmentSize||source->fragmentCount != fragmentCount||
+     source->blockSize != blockSize) return false;
+  // nothing to share
+  if(fragmentCount == 0) return true;
+  delayLine = source;
+  return true;
+}
+
 #include "freeverb/fv3_ns_end.h"
@@ -31,6 +31,7 @@
 
 #include "freeverb/slot.hpp"
 #include "freeverb/utils.hpp"
+#include "freeverb/fftplan.hpp"
 #include "freeverb/fv3_defs.h"
 
 namespace fv3
@@ -25,6 +25,7 @@ class _FV3_(fragfft)
   _FV3_(~fragfft)();
   void setSIMD(uint32_t flag1, uint32_t flag2);
   uint32_t getSIMD(uint32_t select);
+  // 0: split complex spectra (FV3_SIMD_FLAG_SPLIT)
   long getSIMDSize();
   void allocFFT(long size, unsigned fftflags) ;
   void freeFFT();
@@ -44,7 +45,7 @@ class _FV3_(fragfft)
   long fragmentSize, simdSize;
   uint32_t simdFlag1, simdFlag2;
   _FFTW_(plan) planRevrL, planOrigL;
-  _FV3_(slot) fftOrig;
+  _FV3_(slot) fftOrig, splitSlot;
 };
 
 typedef void (_FV3_(*MULT_T))(const _fv3_float_t *, const _fv3_float_t *, _fv3_float_t *, long);
@@ -78,3 +79,63 @@ private:
   _FV3_(slot) fftImpulse;
   uint32_t simdFlag1, simdFlag2;
 };
+
+// Frequency-domain delay line.
+// All fragment spectra and the input spectrum history are stored interleaved
+// by bin blocks ([block][fragment][blockSize]) so that the complex
+// multiply-accumulate over all fragments is done in one cache-blocked pass.
+class _FV3_(fragfdl)
+{
+ public:
+  _FV3_(fragfdl)();
+  _FV3_(~fragfdl)();
+  void setSIMD(uint32_t flag1, uint32_t flag2);
+  uint32_t getSIMD(uint32_t select);
+  // L[0...limit] is divided into the fragments of the size
+  void loadImpulse(const _fv3_float_t * L, long size, long limit, unsigned fftflags)
+    ;
+  // The next loadImpulse() of the same size and fragment count uses these spectra
+  // (getImpulseBlock() layout) without copying instead of L. NULL clears them.
+  // The block must stay valid and FV3_PTR_ALIGN_BYTE aligned until unloadImpulse().
+  void setSpectra(const _fv3_float_t * block, long size, long count, long simd);
+  void unloadImpulse();
+  void mute();
+  long getFragmentSize();
+  long getFragmentCount();
+  long getSIMDSize();
+  // the spectra are processed in getBlockCount() independent bin blocks
+  long getBlockCount();
+  // [bin block][fragment][blockSize], getImpulseBlockSize() values
+  const _fv3_float_t * getImpulseBlock();
+  long getImpulseBlockSize();
+  // push size*2 into the delay line
+  void push(const _fv3_float_t * iL);
+  // add size*2, fragment[i] x (the spectrum pushed (i-shift) blocks before), begin <= i < end
+  void MULT(long begin, long end, long shift, _fv3_float_t * oL);
+  // same as above, only the bin blocks blockBegin <= b < blockEnd
+  void MULT(long begin, long end, long shift, _fv3_float_t * oL, long blockBegin, long blockEnd);
+  // add size*2, fragment[i] x iL
+  void MULT(long i, const _fv3_float_t * iL, _fv3_float_t * oL);
+  // MULT(begin, end, shift, oL[k]) of count delay lines sharing one impulse block.
+  // Each spectrum block of the impulse is loaded once and applied to all the lines.
+  static void MULT(_FV3_(fragfdl) ** fdl, long count, long begin, long end, long shift, _fv3_float_t ** oL);
+  // MULT() reads the delay line of source, which is pushed and muted only by source,
+  // and the own one is kept so that nothing is allocated or freed here. The sizes must be
+  // the same, false = not shared. NULL takes over a copy of the shared delay line.
+  // loadImpulse() and unloadImpulse() also stop sharing.
+  bool shareDelay(_FV3_(fragfdl) * source)
+    ;
+
+ private:
+  _FV3_(fragfdl)(const _FV3_(fragfdl)& x);
+  _FV3_(fragfdl)& operator=(const _FV3_(fragfdl)& x);
+  void MULT_B(const _fv3_float_t * iL, const _fv3_float_t * fL, _fv3_float_t * oL, long block);
+  _FV3_(MULT_T) MULT_M;
+  long fragmentSize, fragmentCount, blockSize, blockCount, simdSize, cur;
+  uint32_t simdFlag1, simdFlag2;
+  _FV3_(slot) impulseBlock, delayBlock;
+  // this or the shareDelay() source
+  _FV3_(fragfdl) * delayLine;
+  const _fv3_float_t * impulseL, * spectraL;
+  long spectraSize, spectraCount, spectraSIMD;
+};
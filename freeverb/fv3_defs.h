@@ -77,6 +77,12 @@
 #define FV3_X86SIMD_CPUID_XOP         0x00000800 // ecx/eax=0x80000001
 #define FV3_X86SIMD_CPUID_FMA4        0x00010000 // ecx/eax=0x80000001
 
+#define FV3_X86SIMD_CPUID_AVX2        0x00000020 // ebx/eax=7,ecx=0
+#define FV3_X86SIMD_CPUID_AVX512F     0x00010000 // ebx/eax=7,ecx=0
+
+#define FV3_X86SIMD_XCR0_AVX          0x00000006 // XMM YMM
+#define FV3_X86SIMD_XCR0_AVX512       0x000000E6 // XMM YMM opmask ZMM
+
 // SIMD code select, size div (X:depreciated F:float D:double L:long double)
 #define FV3_X86SIMD_FLAG_NULL         0x00000000
 #define FV3_X86SIMD_FLAG_FPU          0x00000001 //  -    FDL
@@ -89,10 +95,17 @@
 #define FV3_X86SIMD_FLAG_FMA3         0x00000080 // 16/8  FD  Not AVX2
 #define FV3_X86SIMD_FLAG_3DNOWP       0x00000100 //  2   XF   AMD 3DNow! with prefetch, depreciated: Bulldozer/Bobcat~ no-support
 #define FV3_X86SIMD_FLAG_FMA4         0x00000200 // 16/8 XFD  AMD, depreciated: Ryzen~ no-support
+#define FV3_X86SIMD_FLAG_AVX2         0x00000400 //  8/4  FD  AVX2 FMA3 intrinsics
+#define FV3_X86SIMD_FLAG_AVX512F      0x00000800 // 16/8  FD  AVX-512F intrinsics
+// non-x86 codes share the flag bits
+#define FV3_SIMD_FLAG_NEON            0x00001000 //  4/2  FD  aarch64 Advanced SIMD intrinsics
+#define FV3_SIMD_FLAG_VECTOR          0x00002000 //  8/4  FD  portable SA code vectorized by the compiler
+#define FV3_SIMD_FLAG_SPLIT           0x00004000 //  -    FDL split complex spectra, use as flag2 with any flag1
 
 #define FV3_X86SIMD_MXCSR_FZ          0x00008000 // Flush To Zero
 #define FV3_X86SIMD_MXCSR_DAZ         0x00000040 // Denormals Are Zero
 #define FV3_X86SIMD_MXCSR_EMASK_ALL   0x00001F80 // All Exceptions Masks
+#define FV3_ARMSIMD_FPCR_FZ           0x01000000 // Flush To Zero (aarch64 FPCR, ARMv7 FPSCR)
 
 // for maximum support
 // AVX FMA3 FMA4
@@ -110,11 +123,50 @@
 #define FV3_IR_SKIP_INIT   (1U << 5)
 #define FV3_IR_SWAP_LR     (1U << 6)
 
+/* impulse hot-swap state */
+#define FV3_IR_SWAP_IDLE      0
+#define FV3_IR_SWAP_PREPARING 1
+#define FV3_IR_SWAP_READY     2
+#define FV3_IR_SWAP_FADING    3
+#define FV3_IR_SWAP_DONE      4
+#define FV3_IR_DCrossfadeLength 4096
+
+/* preprocessed impulse spectra file */
+#define FV3_SPECTRA_MAGIC "FV3SPEC"
+#define FV3_SPECTRA_VERSION 1
+#define FV3_SPECTRA_BYTEORDER 0x01020304U
+#define FV3_SPECTRA_ALIGN 64
+
+/* polyphase oversampler */
+#define FV3_POLYPHASE_DEFAULT_TAPS 48 // taps per phase, the round trip latency is (taps-1) samples
+#define FV3_POLYPHASE_ATTENUATION  96 // stopband attenuation dB of the prototype filter
+#define FV3_POLYPHASE_BLOCK      1024 // base rate samples processed at once
+
+/* fork/join of the channel lanes */
+#define FV3_LANES_Max 4 // lanes run in parallel, the rest run in the caller thread
+#define FV3_LANES_DThreshold 256 // smaller blocks are run in the caller thread
+
 /* SIMD size */
 #define FV3_IR_Min_FragmentSize 16
+/* bin block size of the frequency-domain delay line */
+#define FV3_FDL_BlockSize 512
+#define FV3_IR_BatchSize 32
+/* samples of the dry/wet output stage processed at once */
+#define FV3_IR_DryWetChunk 256
 #define FV3_IR2_DFragmentSize 16384
 #define FV3_IR3_DFragmentSize 1024
 #define FV3_IR3_DefaultFactor 16
+#define FV3_IR4_DFragmentSize 64
+#define FV3_IR4_DefaultFactor 4
+#define FV3_IR4_DMaxFragmentSize 16384
+#define FV3_IR5_DFragmentSize 256
+#define FV3_IR5_MaxFragmentSize 4096
+// irmodel5m cost model, relative to one multiply-add of the time domain head
+// FFTCost: one point and one stage of a real FFT, MACCost: one complex bin of one partition
+#define FV3_IR5_FFTCost 1.25
+#define FV3_IR5_MACCost 4.0
+// outputs computed per pass of the time domain head
+#define FV3_IR5_HeadBlock 8
 
 #define FV3_3BS_IR2_DFragmentSize 1024
 #define FV3_3BS_IR3_DFragmentSize 256
@@ -140,7 +192,15 @@
 #define FV3_EARLYREF_PRESET_21 21
 #define FV3_EARLYREF_PRESET_22 22
 
+// earlyref tap processing
+#define FV3_EARLYREF_TAP_AUTO   0
+#define FV3_EARLYREF_TAP_DIRECT 1
+#define FV3_EARLYREF_TAP_FFT    2
+#define FV3_EARLYREF_BlockSize 256
+
 #define FV3_REVBASE_DEFAULT_FS 48000
+/* samples of the strided input/output gathered at once */
+#define FV3_REVBASE_StrideChunk 256
 #define FV3_REVTYPE_SELF    0
 #define FV3_REVTYPE_PROG   30
 #define FV3_REVTYPE_PROG2  31
@@ -190,6 +250,7 @@ extern "C" {
       FV3_SRC_SINC_SLOW_MEDIUM_QUALITY =  11,
       FV3_SRC_LPF_IIR_1                = 100,
       FV3_SRC_LPF_IIR_2                = 101,
+      FV3_SRC_POLYPHASE                = 102,
     };
 #ifdef __cplusplus
 }
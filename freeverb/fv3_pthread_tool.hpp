@@ -22,6 +22,23 @@
 #define _fv3_pthread_tool_hpp
 
 #include <pthread.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <time.h>
+#include <sched.h>
+#include <limits.h>
+#include <vector>
+#include <queue>
+#include <atomic>
+#include <cstring>
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+#include "freeverb/fv3_defs.h"
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
 
 class PthreadEvent
 {
@@ -61,4 +78,343 @@ private:
   pthread_mutex_t mutex;
 };
 
+// Wait on a 32bit atomic word without a mutex (futex on Linux).
+class PthreadFutex
+{
+public:
+  static void wait(std::atomic<uint32_t> * word, uint32_t value)
+  {
+#ifdef __linux__
+    syscall(SYS_futex, (uint32_t*)word, FUTEX_WAIT_PRIVATE, value, NULL, NULL, 0);
+#else
+    if(word->load() == value) sched_yield();
+#endif
+  }
+  static void wake(std::atomic<uint32_t> * word, int count)
+  {
+#ifdef __linux__
+    syscall(SYS_futex, (uint32_t*)word, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+#else
+    (void)word; (void)count;
+#endif
+  }
+  static void pause()
+  {
+#if defined(__GNUC__)&&(defined(__i386__)||defined(__x86_64__))
+    __builtin_ia32_pause();
+#endif
+  }
+};
+
+#define FV3_PTHREAD_SPIN_COUNT 2048
+#define FV3_PTHREAD_QUEUE_SIZE 1024
+
+// A job which is run by PthreadScheduler.
+// The state is handed over between the submitter and the workers only by atomic operations.
+class PthreadJob
+{
+public:
+  enum { DONE = 0, QUEUED = 1, RUNNING = 2, WAITING = 4 };
+  PthreadJob()
+  { deadline = 0; state.store(DONE); }
+  PthreadJob(const PthreadJob & x)
+  { deadline = x.deadline; state.store(DONE); }
+  PthreadJob & operator=(const PthreadJob & x)
+  { deadline = x.deadline; return *this; }
+  virtual ~PthreadJob()
+  {}
+  virtual void run() = 0;
+  bool finished()
+  { return state.load(std::memory_order_acquire) == DONE; }
+  // absolute deadline in PthreadScheduler::now() time
+  uint64_t deadline;
+private:
+  friend class PthreadScheduler;
+  bool claim()
+  { uint32_t q = QUEUED; return state.compare_exchange_strong(q, RUNNING, std::memory_order_acq_rel); }
+  std::atomic<uint32_t> state;
+};
+
+// Process-wide worker pool shared by all parallel engines.
+// Jobs are run in the earliest deadline first order.
+// submit(), wait() and finished() never take a mutex, they are safe to call from the real-time thread.
+class PthreadScheduler
+{
+public:
+  static PthreadScheduler & instance()
+  {
+    // never destroyed, engines may still wait for their jobs during the static destruction.
+    static PthreadScheduler * scheduler = new PthreadScheduler();
+    return *scheduler;
+  }
+  // monotonic clock [ns]
+  static uint64_t now()
+  {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec*1000000000ULL + (uint64_t)ts.tv_nsec;
+  }
+  // 0 = the number of the online processors
+  void setThreadCount(long count)
+  {
+    if(count <= 0) count = onlineCPUs();
+    pthread_mutex_lock(&control);
+    if(count != threadCount){ stopThreads(); threadCount = count; startThreads(); }
+    pthread_mutex_unlock(&control);
+  }
+  long getThreadCount()
+  { return threadCount; }
+  // worker i is bound to cpus[i % cpus.size()], empty = no affinity
+  void setAffinity(const std::vector<int> & cpus)
+  {
+    pthread_mutex_lock(&control);
+    stopThreads();
+    affinity = cpus;
+    startThreads();
+    pthread_mutex_unlock(&control);
+  }
+  void submit(PthreadJob * job)
+  {
+    job->state.store(PthreadJob::QUEUED, std::memory_order_release);
+    if(!running.load(std::memory_order_acquire)||!enqueue(job))
+      {
+        // no worker or the queue is full, run in the caller thread.
+        if(job->claim()){ job->run(); finish(job); }
+        return;
+      }
+    wakeSeq.fetch_add(1);
+    if(sleeping.load() > 0) PthreadFutex::wake(&wakeSeq, 1);
+  }
+  // wait until the job is finished, a job which is not started yet is run in the caller thread.
+  // The job may be destroyed as soon as this returns.
+  void wait(PthreadJob * job)
+  {
+    for(long i = 0;i < FV3_PTHREAD_SPIN_COUNT;i ++)
+      {
+        uint32_t s = job->state.load(std::memory_order_acquire);
+        if(s == PthreadJob::DONE) return;
+        if(s == PthreadJob::QUEUED&&job->claim()){ job->run(); finish(job); return; }
+        PthreadFutex::pause();
+      }
+    while(1)
+      {
+        // the sleepers wait on doneSeq, the finisher never touches the job after it is DONE.
+        uint32_t seq = doneSeq.load();
+        uint32_t s = job->state.load(std::memory_order_acquire);
+        if(s == PthreadJob::DONE) return;
+        if(s == PthreadJob::QUEUED)
+          {
+            if(job->claim()){ job->run(); finish(job); return; }
+            continue;
+          }
+        if(s == PthreadJob::RUNNING&&!job->state.compare_exchange_strong(s, PthreadJob::RUNNING|PthreadJob::WAITING)) continue;
+        PthreadFutex::wait(&doneSeq, seq);
+      }
+  }
+  // Remove the stale queue entries of the finished job before the job is destroyed.
+  // Must not be called from the real-time thread.
+  void retire(PthreadJob * job)
+  {
+    wait(job);
+    Entry entry;
+    pthread_mutex_lock(&mutex);
+    // wait for the producers which are still publishing their entries
+    while(enqueuePos.load() != dequeuePos.load()){ if(!dequeue(&entry)) PthreadFutex::pause(); else heap.push(entry); }
+    std::vector<Entry> keep;
+    while(!heap.empty()){ if(heap.top().job != job) keep.push_back(heap.top()); heap.pop(); }
+    for(size_t i = 0;i < keep.size();i ++) heap.push(keep[i]);
+    pthread_mutex_unlock(&mutex);
+  }
+private:
+  struct Entry
+  {
+    uint64_t deadline, serial;
+    PthreadJob * job;
+  };
+  struct Cell
+  {
+    std::atomic<size_t> seq;
+    Entry entry;
+  };
+  struct LaterDeadline
+  {
+    bool operator()(const Entry & a, const Entry & b) const
+    { return a.deadline != b.deadline ? a.deadline > b.deadline : a.serial > b.serial; }
+  };
+  PthreadScheduler()
+  {
+    pthread_mutex_init(&control, NULL); pthread_mutex_init(&mutex, NULL);
+    for(size_t i = 0;i < FV3_PTHREAD_QUEUE_SIZE;i ++) cells[i].seq.store(i);
+    enqueuePos.store(0); dequeuePos.store(0); serial.store(0); wakeSeq.store(0); sleeping.store(0); doneSeq.store(0);
+    running.store(false); exiting.store(false);
+    threadCount = onlineCPUs();
+    startThreads();
+  }
+  ~PthreadScheduler()
+  {
+    pthread_mutex_lock(&control); stopThreads(); pthread_mutex_unlock(&control);
+    pthread_mutex_destroy(&mutex); pthread_mutex_destroy(&control);
+  }
+  PthreadScheduler(const PthreadScheduler &);
+  PthreadScheduler & operator=(const PthreadScheduler &);
+  // the waiters are woken on doneSeq which the scheduler owns, the job may be freed by them at once.
+  void finish(PthreadJob * job)
+  {
+    if(job->state.exchange(PthreadJob::DONE, std::memory_order_acq_rel) & PthreadJob::WAITING)
+      {
+        doneSeq.fetch_add(1);
+        PthreadFutex::wake(&doneSeq, INT_MAX);
+      }
+  }
+  static long onlineCPUs()
+  { long n = sysconf(_SC_NPROCESSORS_ONLN); return n > 0 ? n : 1; }
+  // bounded multi-producer multi-consumer queue
+  bool enqueue(PthreadJob * job)
+  {
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Cell * cell;
+    while(1)
+      {
+        cell = &cells[pos & (FV3_PTHREAD_QUEUE_SIZE-1)];
+        intptr_t diff = (intptr_t)cell->seq.load(std::memory_order_acquire) - (intptr_t)pos;
+        if(diff == 0){ if(enqueuePos.compare_exchange_weak(pos, pos+1, std::memory_order_relaxed)) break; }
+        else if(diff < 0) return false;
+        else pos = enqueuePos.load(std::memory_order_relaxed);
+      }
+    cell->entry.deadline = job->deadline;
+    cell->entry.serial = serial.fetch_add(1, std::memory_order_relaxed);
+    cell->entry.job = job;
+    cell->seq.store(pos+1, std::memory_order_release);
+    return true;
+  }
+  bool dequeue(Entry * entry)
+  {
+    size_t pos = dequeuePos.load(std::memory_order_relaxed);
+    Cell * cell;
+    while(1)
+      {
+        cell = &cells[pos & (FV3_PTHREAD_QUEUE_SIZE-1)];
+        intptr_t diff = (intptr_t)cell->seq.load(std::memory_order_acquire) - (intptr_t)(pos+1);
+        if(diff == 0){ if(dequeuePos.compare_exchange_weak(pos, pos+1, std::memory_order_relaxed)) break; }
+        else if(diff < 0) return false;
+        else pos = dequeuePos.load(std::memory_order_relaxed);
+      }
+    *entry = cell->entry;
+    cell->seq.store(pos+FV3_PTHREAD_QUEUE_SIZE, std::memory_order_release);
+    return true;
+  }
+  // mutex must be locked
+  void drain()
+  {
+    Entry entry;
+    while(dequeue(&entry)) heap.push(entry);
+  }
+  // The flush to zero mode of denormalguard is per thread, the workers keep it for their lifetime.
+  static void flushDenormals()
+  {
+#if defined(__GNUC__)&&(defined(__x86_64__)||(defined(__i386__)&&defined(ENABLE_X86SIMD)))
+#if !defined(__x86_64__)
+    if(!__builtin_cpu_supports("sse")) return;
+#endif
+    // DAZ only if MXCSR_MASK has it (see utils::getMXCSR_MASK())
+    unsigned char fxsave_s[512] __attribute__((aligned(16)));
+    uint32_t mxcsr, mxcsr_mask;
+    std::memset(fxsave_s, 0, sizeof(fxsave_s));
+    __asm__ __volatile__ ("fxsave %0" : "=m" (fxsave_s));
+    std::memcpy(&mxcsr_mask, fxsave_s+28, 4);
+    if(mxcsr_mask == 0) mxcsr_mask = 0xFFBF;
+    __asm__ __volatile__ ("stmxcsr %0" : "=m" (mxcsr));
+    mxcsr |= (FV3_X86SIMD_MXCSR_FZ|FV3_X86SIMD_MXCSR_DAZ) & mxcsr_mask;
+    __asm__ __volatile__ ("ldmxcsr %0" : : "m" (mxcsr));
+#elif defined(__SSE__)
+    _mm_setcsr(_mm_getcsr()|FV3_X86SIMD_MXCSR_FZ);
+#elif defined(__aarch64__)
+    uint64_t fpcr;
+    __asm__ __volatile__ ("mrs %0, fpcr" : "=r" (fpcr));
+    fpcr |= FV3_ARMSIMD_FPCR_FZ;
+    __asm__ __volatile__ ("msr fpcr, %0" : : "r" (fpcr));
+#elif defined(__arm__)&&defined(__VFP_FP__)&&!defined(__SOFTFP__)
+    uint32_t fpscr;
+    __asm__ __volatile__ ("vmrs %0, fpscr" : "=r" (fpscr));
+    fpscr |= FV3_ARMSIMD_FPCR_FZ;
+    __asm__ __volatile__ ("vmsr fpscr, %0" : : "r" (fpscr));
+#endif
+  }
+  // Entries of the jobs which were stolen by wait() or resubmitted are skipped by claim().
+  static void * worker(void * vdParam)
+  {
+    PthreadScheduler * s = (PthreadScheduler*)vdParam;
+    flushDenormals();
+    while(1)
+      {
+        uint32_t seq = s->wakeSeq.load();
+        PthreadJob * job = NULL;
+        pthread_mutex_lock(&s->mutex);
+        s->drain();
+        while(!s->heap.empty())
+          {
+            Entry entry = s->heap.top();
+            s->heap.pop();
+            if(entry.job->claim()){ job = entry.job; break; }
+          }
+        pthread_mutex_unlock(&s->mutex);
+        if(job != NULL)
+          {
+            job->run();
+            s->finish(job);
+            continue;
+          }
+        if(s->exiting.load()) break;
+        for(long i = 0;i < FV3_PTHREAD_SPIN_COUNT&&s->wakeSeq.load() == seq;i ++) PthreadFutex::pause();
+        if(s->wakeSeq.load() != seq) continue;
+        s->sleeping.fetch_add(1);
+        PthreadFutex::wait(&s->wakeSeq, seq);
+        s->sleeping.fetch_sub(1);
+      }
+    return NULL;
+  }
+  // control must be locked
+  void startThreads()
+  {
+    exiting.store(false);
+    for(long i = 0;i < threadCount;i ++)
+      {
+        pthread_t t;
+        if(pthread_create(&t, NULL, worker, this) != 0) break;
+#ifdef __linux__
+        if(affinity.size() > 0)
+          {
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            CPU_SET(affinity[i % affinity.size()], &cpuset);
+            pthread_setaffinity_np(t, sizeof(cpu_set_t), &cpuset);
+          }
+#endif
+        threads.push_back(t);
+      }
+    running.store(threads.size() > 0);
+  }
+  // control must be locked, the queued jobs are finished before the threads exit.
+  void stopThreads()
+  {
+    if(threads.size() == 0) return;
+    running.store(false);
+    exiting.store(true);
+    wakeSeq.fetch_add(1);
+    PthreadFutex::wake(&wakeSeq, INT_MAX);
+    for(size_t i = 0;i < threads.size();i ++) pthread_join(threads[i], NULL);
+    threads.clear();
+  }
+  pthread_mutex_t control, mutex;
+  Cell cells[FV3_PTHREAD_QUEUE_SIZE];
+  std::atomic<size_t> enqueuePos, dequeuePos;
+  std::atomic<uint64_t> serial;
+  std::atomic<uint32_t> wakeSeq, sleeping, doneSeq;
+  std::atomic<bool> running, exiting;
+  std::priority_queue<Entry, std::vector<Entry>, LaterDeadline> heap;
+  std::vector<pthread_t> threads;
+  std::vector<int> affinity;
+  long threadCount;
+};
+
 #endif
@@ -19,6 +19,12 @@
  */
 
 #include "freeverb/irbase.hpp"
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 #include "freeverb/fv3_type_float.h"
 #include "freeverb/fv3_ns_start.h"
 
@@ -77,6 +83,288 @@ long FV3_(irbasem)::getLatency()
 void FV3_(irbasem)::resume(){;}
 void FV3_(irbasem)::suspend(){;}
 
+FV3_(irbasem) * FV3_(irbasem)::clone()
+{
+  return NULL;
+}
+
+void FV3_(irbasem)::cloneConfig(FV3_(irbasem) * to)
+{
+  to->setFFTFlags(fftflags);
+  to->setSIMD(simdFlag1, simdFlag2);
+}
+
+long FV3_(irbasem)::getFDLCount()
+{
+  return 0;
+}
+
+FV3_(fragfdl) * FV3_(irbasem)::getFDL(long i)
+{
+  return NULL;
+}
+
+// irprepared
+
+static inline long spectraAlign(long offset)
+{
+  return (offset + FV3_SPECTRA_ALIGN - 1)/FV3_SPECTRA_ALIGN*FV3_SPECTRA_ALIGN;
+}
+
+FV3_(irprepared)::FV3_(irprepared)()
+{
+  data = NULL;
+  dataSize = 0;
+  mapped = false;
+  refCount.store(1);
+}
+
+FV3_(irprepared)::FV3_(~irprepared)()
+{
+  if(data == NULL) return;
+#ifndef _WIN32
+  if(mapped)
+    {
+      munmap(data, dataSize);
+      return;
+    }
+#endif
+  FV3_(utils)::aligned_free(data);
+}
+
+FV3_(irprepared) * FV3_(irprepared)::create(FV3_(irbase) * ir, const fv3_float_t * inputL, const fv3_float_t * inputR, long size, long sampleRate)
+  
+{
+  if(ir == NULL||size <= 0) return NULL;
+  ir->loadImpulse(inputL, inputR, size);
+  FV3_(irbasem) * irm[2] = { ir->irmL, ir->irmR };
+  long fdlCount = irm[0] != NULL&&irm[1] != NULL ? irm[0]->getFDLCount() : 0;
+  // [header][fdl table L...R...] [impulse L][impulse R] [spectra L...R...], every data FV3_SPECTRA_ALIGN aligned
+  long impulseOffset = spectraAlign(sizeof(header)+sizeof(fdlEntry)*2*fdlCount);
+  long impulseBytes = spectraAlign(sizeof(fv3_float_t)*size);
+  long offset = impulseOffset + 2*impulseBytes;
+  for(long i = 0;i < 2*fdlCount;i ++)
+    offset = spectraAlign(offset + sizeof(fv3_float_t)*irm[i/fdlCount]->getFDL(i%fdlCount)->getImpulseBlockSize());
+
+  FV3_(irprepared) * impulse = new FV3_(irprepared);
+  impulse->data = (char*)FV3_(utils)::aligned_malloc(offset, FV3_SPECTRA_ALIGN);
+  if(impulse->data == NULL)
+    {
+      std::fprintf(stderr, "irprepared::create(%ld) bad_alloc\n", size);
+      delete impulse;
+      throw std::bad_alloc();
+    }
+  impulse->dataSize = offset;
+  std::memset(impulse->data, 0, offset);
+  header * h = impulse->getHeader();
+  std::memcpy(h->magic, FV3_SPECTRA_MAGIC, sizeof(FV3_SPECTRA_MAGIC));
+  h->byteOrder = FV3_SPECTRA_BYTEORDER;
+  h->version = FV3_SPECTRA_VERSION;
+  h->floatSize = sizeof(fv3_float_t);
+  h->simdSize = fdlCount > 0 ? irm[0]->getFDL(0)->getSIMDSize() : 0;
+  h->fdlBlockSize = FV3_FDL_BlockSize;
+  h->fdlCount = fdlCount;
+  h->sampleRate = sampleRate;
+  h->impulseSize = size;
+  h->impulseOffset = impulseOffset;
+  std::memcpy(impulse->data+impulseOffset, inputL, sizeof(fv3_float_t)*size);
+  std::memcpy(impulse->data+impulseOffset+impulseBytes, inputR, sizeof(fv3_float_t)*size);
+  fdlEntry * fdls = impulse->getFDLs();
+  offset = impulseOffset + 2*impulseBytes;
+  for(long i = 0;i < 2*fdlCount;i ++)
+    {
+      FV3_(fragfdl) * fdl = irm[i/fdlCount]->getFDL(i%fdlCount);
+      fdls[i].fragmentSize = fdl->getFragmentSize();
+      fdls[i].fragmentCount = fdl->getFragmentCount();
+      fdls[i].offset = offset;
+      if(fdl->getImpulseBlockSize() > 0)
+        std::memcpy(impulse->data+offset, fdl->getImpulseBlock(), sizeof(fv3_float_t)*fdl->getImpulseBlockSize());
+      offset = spectraAlign(offset + sizeof(fv3_float_t)*fdl->getImpulseBlockSize());
+    }
+  // ir drops its own copy of the spectra.
+  try
+    {
+      ir->bindImpulse(impulse);
+    }
+  catch(std::bad_alloc)
+    {
+      impulse->release();
+      throw;
+    }
+  return impulse;
+}
+
+FV3_(irprepared) * FV3_(irprepared)::open(const char * filename, long sampleRate)
+{
+  FV3_(irprepared) * impulse = NULL;
+  try
+    {
+      impulse = new FV3_(irprepared);
+    }
+  catch(std::bad_alloc)
+    {
+      return NULL;
+    }
+#ifndef _WIN32
+  int fd = ::open(filename, O_RDONLY);
+  struct stat st;
+  if(fd < 0||fstat(fd, &st) != 0||st.st_size <= 0)
+    {
+      std::fprintf(stderr, "irprepared::open(%s): open failed.\n", filename);
+      if(fd >= 0) close(fd);
+      delete impulse;
+      return NULL;
+    }
+  void * map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(map == MAP_FAILED)
+    {
+      std::fprintf(stderr, "irprepared::open(%s): mmap failed.\n", filename);
+      delete impulse;
+      return NULL;
+    }
+  impulse->data = (char*)map, impulse->dataSize = st.st_size, impulse->mapped = true;
+#else
+  // no mmap, read into an aligned buffer.
+  std::FILE * fp = std::fopen(filename, "rb");
+  if(fp == NULL)
+    {
+      std::fprintf(stderr, "irprepared::open(%s): fopen failed.\n", filename);
+      delete impulse;
+      return NULL;
+    }
+  std::fseek(fp, 0, SEEK_END);
+  long size = std::ftell(fp);
+  std::fseek(fp, 0, SEEK_SET);
+  impulse->data = size > 0 ? (char*)FV3_(utils)::aligned_malloc(size, FV3_SPECTRA_ALIGN) : NULL;
+  impulse->dataSize = size;
+  if(impulse->data == NULL||std::fread(impulse->data, 1, size, fp) != (size_t)size)
+    {
+      std::fprintf(stderr, "irprepared::open(%s): read failed.\n", filename);
+      std::fclose(fp);
+      delete impulse;
+      return NULL;
+    }
+  std::fclose(fp);
+#endif
+  const char * error = impulse->validate(sampleRate);
+  if(error != NULL)
+    {
+      std::fprintf(stderr, "irprepared::open(%s): %s.\n", filename, error);
+      delete impulse;
+      return NULL;
+    }
+  return impulse;
+}
+
+const char * FV3_(irprepared)::validate(long sampleRate)
+{
+  const header * h = getHeader();
+  if(dataSize < sizeof(header)||std::memcmp(h->magic, FV3_SPECTRA_MAGIC, sizeof(FV3_SPECTRA_MAGIC)) != 0)
+    return "not a spectra file";
+  if(h->byteOrder != FV3_SPECTRA_BYTEORDER||h->version != FV3_SPECTRA_VERSION)
+    return "unsupported version or byte order";
+  if(h->floatSize != sizeof(fv3_float_t))
+    return "precision mismatch";
+  if(sampleRate > 0&&h->sampleRate > 0&&h->sampleRate != sampleRate)
+    return "sample rate mismatch";
+  if(h->impulseSize <= 0||h->impulseOffset < (int64_t)(sizeof(header)+sizeof(fdlEntry)*2*h->fdlCount)
+     ||h->impulseOffset+2*spectraAlign(sizeof(fv3_float_t)*h->impulseSize) > (int64_t)dataSize)
+    return "broken file";
+  const fdlEntry * fdls = getFDLs();
+  for(long i = 0;i < 2*(long)h->fdlCount;i ++)
+    {
+      if(fdls[i].fragmentSize < 0||fdls[i].fragmentCount < 0||fdls[i].offset < 0||fdls[i].offset%FV3_SPECTRA_ALIGN != 0
+         ||fdls[i].offset+(int64_t)sizeof(fv3_float_t)*2*fdls[i].fragmentSize*fdls[i].fragmentCount > (int64_t)dataSize)
+        return "broken file";
+    }
+  return NULL;
+}
+
+bool FV3_(irprepared)::save(const char * filename)
+{
+  std::FILE * fp = std::fopen(filename, "wb");
+  if(fp == NULL)
+    {
+      std::fprintf(stderr, "irprepared::save(%s): fopen failed.\n", filename);
+      return false;
+    }
+  bool ok = std::fwrite(data, 1, dataSize, fp) == dataSize;
+  if(std::fclose(fp) != 0) ok = false;
+  if(!ok) std::fprintf(stderr, "irprepared::save(%s): write failed.\n", filename);
+  return ok;
+}
+
+void FV3_(irprepared)::retain()
+{
+  refCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FV3_(irprepared)::release()
+{
+  if(refCount.fetch_sub(1, std::memory_order_acq_rel) == 1) delete this;
+}
+
+long FV3_(irprepared)::getRefCount()
+{
+  return refCount.load();
+}
+
+long FV3_(irprepared)::getImpulseSize()
+{
+  return getHeader()->impulseSize;
+}
+
+long FV3_(irprepared)::getSampleRate()
+{
+  return getHeader()->sampleRate;
+}
+
+const fv3_float_t * FV3_(irprepared)::getImpulse(long ch)
+{
+  return (const fv3_float_t*)(data+getHeader()->impulseOffset+(ch == 0 ? 0 : spectraAlign(sizeof(fv3_float_t)*getImpulseSize())));
+}
+
+long FV3_(irprepared)::getSIMDSize()
+{
+  return getHeader()->simdSize;
+}
+
+long FV3_(irprepared)::getFDLBlockSize()
+{
+  return getHeader()->fdlBlockSize;
+}
+
+long FV3_(irprepared)::getFDLCount()
+{
+  return getHeader()->fdlCount;
+}
+
+long FV3_(irprepared)::getFragmentSize(long ch, long i)
+{
+  return getFDLs()[ch*getFDLCount()+i].fragmentSize;
+}
+
+long FV3_(irprepared)::getFragmentCount(long ch, long i)
+{
+  return getFDLs()[ch*getFDLCount()+i].fragmentCount;
+}
+
+const fv3_float_t * FV3_(irprepared)::getSpectra(long ch, long i)
+{
+  return (const fv3_float_t*)(data+getFDLs()[ch*getFDLCount()+i].offset);
+}
+
+FV3_(irprepared)::header * FV3_(irprepared)::getHeader()
+{
+  return (header*)data;
+}
+
+FV3_(irprepared)::fdlEntry * FV3_(irprepared)::getFDLs()
+{
+  return (fdlEntry*)(data+sizeof(header));
+}
+
 // irbase
 
 FV3_(irbase)::FV3_(irbase)()
@@ -89,11 +377,20 @@ FV3_(irbase)::FV3_(irbase)()
   setInitialDelay(0);
   processoptions = FV3_IR_DEFAULT;
   irmL = irmR = NULL;
+  swapL = swapR = NULL;
+  swapSize = swapFadeLength = crossfadeCursor = 0;
+  crossfadeLength = FV3_IR_DCrossfadeLength;
+  swapState.store(FV3_IR_SWAP_IDLE);
+  prepared = NULL;
 }
 
 FV3_(irbase)::FV3_(~irbase)()
 {
+  freeSwap();
   unloadImpulse();
+  delete irmL;
+  delete irmR;
+  releasePrepared();
 }
 
 void FV3_(irbase)::unloadImpulse()
@@ -288,33 +585,107 @@ void FV3_(irbase)::setprocessoptions(unsigned options)
   processoptions = options;
 }
 
-void FV3_(irbase)::processdrywetout(const fv3_float_t *dL, const fv3_float_t *dR, fv3_float_t *wL, fv3_float_t *wR, fv3_float_t *oL, fv3_float_t *oR, long numsamples)
+void FV3_(irbase)::processstrided(const fv3_float_t *inputL, const fv3_float_t *inputR, long inputStride,
+                                  fv3_float_t *outputL, fv3_float_t *outputR, long outputStride, long numsamples)
 {
-  if((processoptions & FV3_IR_SKIP_FILTER) == 0)
+  if(numsamples <= 0) return;
+  if(inputStride < 1||outputStride < 1)
     {
-      for(long i = 0;i < numsamples;i ++){ wL[i] = filter.processL(wL[i]), wR[i] = filter.processR(wR[i]); } 
+      std::fprintf(stderr, "irbase::processstrided(%ld,%ld) invalid stride\n", inputStride, outputStride);
+      return;
     }
-  for(long i = 0;i < numsamples;i ++)
+  // the models which can not read the strided buffers directly process them chunk by chunk
+  bool init = (processoptions & FV3_IR_SKIP_INIT) == 0;
+  fv3_float_t iL[FV3_IR_DryWetChunk], iR[FV3_IR_DryWetChunk], oL[FV3_IR_DryWetChunk], oR[FV3_IR_DryWetChunk];
+  for(long pos = 0;pos < numsamples;pos += FV3_IR_DryWetChunk)
     {
-      wL[i] = delayWL.process(wL[i]), wR[i] = delayWR.process(wR[i]);
+      long n = numsamples - pos < FV3_IR_DryWetChunk ? numsamples - pos : FV3_IR_DryWetChunk;
+      const fv3_float_t *ciL = inputL+pos*inputStride, *ciR = inputR+pos*inputStride;
+      fv3_float_t *coL = outputL+pos*outputStride, *coR = outputR+pos*outputStride;
+      for(long i = 0;i < n;i ++){ iL[i] = ciL[i*inputStride], iR[i] = ciR[i*inputStride]; }
+      if(!init)
+        {
+          for(long i = 0;i < n;i ++){ oL[i] = coL[i*outputStride], oR[i] = coR[i*outputStride]; }
+        }
+      processreplace(iL, iR, oL, oR, n);
+      for(long i = 0;i < n;i ++){ coL[i*outputStride] = oL[i], coR[i*outputStride] = oR[i]; }
     }
+}
+
+void FV3_(irbase)::processstrided(const fv3_float_t *inputL, const fv3_float_t *inputR, long inputStride,
+                                  fv3_float_t *outputL, fv3_float_t *outputR, long outputStride, long numsamples, unsigned options)
+{
+  setprocessoptions(options);
+  processstrided(inputL, inputR, inputStride, outputL, outputR, outputStride, numsamples);
+}
+
+void FV3_(irbase)::processdrywetout(const fv3_float_t *dL, const fv3_float_t *dR, fv3_float_t *wL, fv3_float_t *wR, fv3_float_t *oL, fv3_float_t *oR, long numsamples)
+{
+  processdrywetout(dL, dR, 1, wL, wR, oL, oR, 1, numsamples);
+}
+
+void FV3_(irbase)::processdrywetout(const fv3_float_t *dL, const fv3_float_t *dR, long dStride, fv3_float_t *wL, fv3_float_t *wR,
+                                    fv3_float_t *oL, fv3_float_t *oR, long oStride, long numsamples)
+{
+  bool filtered = (processoptions & FV3_IR_SKIP_FILTER) == 0, init = (processoptions & FV3_IR_SKIP_INIT) == 0;
+  bool wetOn = (processoptions & FV3_IR_MUTE_WET) == 0, dryOn = (processoptions & FV3_IR_MUTE_DRY) == 0;
   if((processoptions & FV3_IR_SWAP_LR) != 0)
     {
       fv3_float_t * sT = oL; oL = oR; oR = sT;
     }
-  if((processoptions & FV3_IR_SKIP_INIT) == 0)
-    {
-      FV3_(utils)::mute(oL, numsamples), FV3_(utils)::mute(oR, numsamples);
-    }
-  if((processoptions & FV3_IR_MUTE_WET) == 0)
+  // All the stages run on a chunk which stays in the cache, the mix loops are selected by the options.
+  // The dry chunk is read before the output chunk is written, so the outputs may be the dry inputs.
+  // The strided outputs are mixed in the chunk and scattered at once.
+  fv3_float_t ddL[FV3_IR_DryWetChunk], ddR[FV3_IR_DryWetChunk], ooL[FV3_IR_DryWetChunk], ooR[FV3_IR_DryWetChunk];
+  for(long pos = 0;pos < numsamples;pos += FV3_IR_DryWetChunk)
     {
-      for(long i = 0;i < numsamples;i ++) oL[i] += wL[i]*wet1L + wR[i]*wet2L;
-      for(long i = 0;i < numsamples;i ++) oR[i] += wR[i]*wet1R + wL[i]*wet2R;
-    }
-  if((processoptions & FV3_IR_MUTE_DRY) == 0)
-    {
-      for(long i = 0;i < numsamples;i ++) oL[i] += delayDL.process(dL[i])*dry;
-      for(long i = 0;i < numsamples;i ++) oR[i] += delayDR.process(dR[i])*dry;
+      long n = numsamples - pos < FV3_IR_DryWetChunk ? numsamples - pos : FV3_IR_DryWetChunk;
+      fv3_float_t *cwL = wL+pos, *cwR = wR+pos, *coL = oL+pos*oStride, *coR = oR+pos*oStride;
+      if(filtered)
+        {
+          for(long i = 0;i < n;i ++){ cwL[i] = filter.processL(cwL[i]), cwR[i] = filter.processR(cwR[i]); }
+        }
+      delayWL.process(cwL, cwL, n), delayWR.process(cwR, cwR, n);
+      if(dryOn&&dStride == 1) delayDL.process(dL+pos, ddL, n), delayDR.process(dR+pos, ddR, n);
+      if(dryOn&&dStride != 1)
+        {
+          const fv3_float_t *cdL = dL+pos*dStride, *cdR = dR+pos*dStride;
+          for(long i = 0;i < n;i ++){ ddL[i] = cdL[i*dStride], ddR[i] = cdR[i*dStride]; }
+          delayDL.process(ddL, ddL, n), delayDR.process(ddR, ddR, n);
+        }
+      if(oStride != 1)
+        {
+          if(!init)
+            {
+              for(long i = 0;i < n;i ++){ ooL[i] = coL[i*oStride], ooR[i] = coR[i*oStride]; }
+            }
+          coL = ooL, coR = ooR;
+        }
+      if(init) FV3_(utils)::mute(coL, n), FV3_(utils)::mute(coR, n);
+      if(wetOn&&dryOn)
+        {
+          for(long i = 0;i < n;i ++)
+            {
+              fv3_float_t l = coL[i] + (cwL[i]*wet1L + cwR[i]*wet2L), r = coR[i] + (cwR[i]*wet1R + cwL[i]*wet2R);
+              coL[i] = l + ddL[i]*dry, coR[i] = r + ddR[i]*dry;
+            }
+        }
+      else if(wetOn)
+        {
+          for(long i = 0;i < n;i ++)
+            {
+              coL[i] += cwL[i]*wet1L + cwR[i]*wet2L, coR[i] += cwR[i]*wet1R + cwL[i]*wet2R;
+            }
+        }
+      else if(dryOn)
+        {
+          for(long i = 0;i < n;i ++){ coL[i] += ddL[i]*dry, coR[i] += ddR[i]*dry; }
+        }
+      if(oStride != 1)
+        {
+          fv3_float_t *soL = oL+pos*oStride, *soR = oR+pos*oStride;
+          for(long i = 0;i < n;i ++){ soL[i*oStride] = ooL[i], soR[i*oStride] = ooR[i]; }
+        }
     }
 }
 
@@ -330,6 +701,242 @@ void FV3_(irbase)::mute()
   filter.mute();
 }
 
+void FV3_(irbase)::prepareImpulse(const fv3_float_t * inputL, const fv3_float_t * inputR, long size)
+  
+{
+  if(size <= 0) return;
+  if(impulseSize == 0)
+    {
+      // loadImpulse() would race with processreplace(), there is nothing to fade from anyway.
+      std::fprintf(stderr, "irbase::prepareImpulse(%ld): no impulse is loaded, use loadImpulse().\n", size);
+      return;
+    }
+  if(getSwapBlockSize() <= 0||irmL == NULL||irmR == NULL)
+    {
+      std::fprintf(stderr, "irbase::prepareImpulse(%ld): not supported, use loadImpulse().\n", size);
+      return;
+    }
+  // A prepared swap which is not taken yet is replaced, the finished one is freed.
+  int state = swapState.load();
+  while(1)
+    {
+      if(state == FV3_IR_SWAP_PREPARING||state == FV3_IR_SWAP_FADING)
+        {
+          std::fprintf(stderr, "irbase::prepareImpulse(%ld): the previous swap is not finished.\n", size);
+          return;
+        }
+      if(swapState.compare_exchange_weak(state, FV3_IR_SWAP_PREPARING)) break;
+    }
+  delete swapL, swapL = NULL;
+  delete swapR, swapR = NULL;
+  FV3_(irbasem) *newL = NULL, *newR = NULL;
+  try
+    {
+      newL = irmL->clone(), newR = irmR->clone();
+      if(newL == NULL||newR == NULL)
+        {
+          std::fprintf(stderr, "irbase::prepareImpulse(%ld): not supported, use loadImpulse().\n", size);
+          delete newL; delete newR;
+          swapState.store(FV3_IR_SWAP_IDLE);
+          return;
+        }
+      newL->loadImpulse(inputL, size), newR->loadImpulse(inputR, size);
+      newL->mute(), newR->mute();
+      swapW.alloc(getSwapBlockSize(), 2);
+      // equal-power crossfade gains, L = the new engines, R = the old engines
+      swapFadeLength = crossfadeLength;
+      swapGain.free();
+      if(swapFadeLength > 0) swapGain.alloc(swapFadeLength, 2);
+      for(long i = 0;i < swapFadeLength;i ++)
+        {
+          fv3_float_t t = (fv3_float_t)i/(fv3_float_t)swapFadeLength;
+          swapGain.L[i] = std::sin(t*M_PI_2), swapGain.R[i] = std::cos(t*M_PI_2);
+        }
+    }
+  catch(std::bad_alloc)
+    {
+      std::fprintf(stderr, "irbase::prepareImpulse(%ld) bad_alloc\n", size);
+      delete newL; delete newR;
+      swapState.store(FV3_IR_SWAP_IDLE);
+      throw;
+    }
+  if(newL->getLatency() != irmL->getLatency())
+    {
+      // The dry signal delay can not be changed while running.
+      std::fprintf(stderr, "irbase::prepareImpulse(%ld): the latency must not be changed (%ld->%ld), use loadImpulse().\n",
+                   size, irmL->getLatency(), newL->getLatency());
+      delete newL; delete newR;
+      swapState.store(FV3_IR_SWAP_IDLE);
+      return;
+    }
+  swapL = newL, swapR = newR, swapSize = size;
+  swapState.store(FV3_IR_SWAP_READY);
+}
+
+int FV3_(irbase)::getSwapState()
+{
+  return swapState.load();
+}
+
+void FV3_(irbase)::setCrossfadeLength(long numsamples)
+{
+  if(numsamples < 0) numsamples = 0;
+  crossfadeLength = numsamples;
+}
+
+long FV3_(irbase)::getCrossfadeLength()
+{
+  return crossfadeLength;
+}
+
+void FV3_(irbase)::setParallelThreshold(long size)
+{
+  lanes.setThreshold(size);
+}
+
+long FV3_(irbase)::getParallelThreshold()
+{
+  return lanes.getThreshold();
+}
+
+void FV3_(irbase)::attachEngines(){;}
+
+long FV3_(irbase)::getSwapBlockSize()
+{
+  return 0;
+}
+
+void FV3_(irbase)::processSwapIn(const fv3_float_t *wL, const fv3_float_t *wR, long numsamples)
+{
+  if(swapState.load(std::memory_order_acquire) == FV3_IR_SWAP_READY)
+    {
+      // block boundary: the new engines take over, the old ones are faded out.
+      FV3_(irbasem) *oldL = irmL, *oldR = irmR;
+      irmL = swapL, irmR = swapR;
+      swapL = oldL, swapR = oldR;
+      impulseSize = swapSize;
+      attachEngines();
+      crossfadeCursor = 0;
+      swapState.store(FV3_IR_SWAP_FADING, std::memory_order_release);
+    }
+  if(swapState.load(std::memory_order_relaxed) != FV3_IR_SWAP_FADING) return;
+  std::memcpy(swapW.L, wL, sizeof(fv3_float_t)*numsamples);
+  std::memcpy(swapW.R, wR, sizeof(fv3_float_t)*numsamples);
+  processSwapEngines(swapW.L, swapW.R, numsamples);
+}
+
+void FV3_(irbase)::processSwapEngines(fv3_float_t *wL, fv3_float_t *wR, long numsamples)
+{
+  swapL->processreplace(wL, numsamples);
+  swapR->processreplace(wR, numsamples);
+}
+
+void FV3_(irbase)::processSwapOut(fv3_float_t *wL, fv3_float_t *wR, long numsamples)
+{
+  if(swapState.load(std::memory_order_relaxed) != FV3_IR_SWAP_FADING) return;
+  // the gains of prepareImpulse(), the new engines only after the end of the crossfade
+  long fade = swapFadeLength - crossfadeCursor;
+  if(fade > numsamples) fade = numsamples;
+  const fv3_float_t *gNew = swapGain.L + crossfadeCursor, *gOld = swapGain.R + crossfadeCursor;
+  for(long i = 0;i < fade;i ++)
+    {
+      wL[i] = wL[i]*gNew[i] + swapW.L[i]*gOld[i];
+      wR[i] = wR[i]*gNew[i] + swapW.R[i]*gOld[i];
+    }
+  crossfadeCursor += numsamples;
+  if(crossfadeCursor >= swapFadeLength) swapState.store(FV3_IR_SWAP_DONE, std::memory_order_release);
+}
+
+void FV3_(irbase)::freeSwap()
+{
+  int state = swapState.load(std::memory_order_acquire);
+  if(state == FV3_IR_SWAP_PREPARING) return;
+  delete swapL, swapL = NULL;
+  delete swapR, swapR = NULL;
+  swapW.free();
+  swapGain.free();
+  swapState.store(FV3_IR_SWAP_IDLE);
+}
+
+void FV3_(irbase)::bindImpulse(FV3_(irprepared) * impulse)
+  
+{
+  if(impulse == NULL) return;
+  impulse->retain();
+  // The fragment delay lines take the spectra if their configuration matches.
+  bool useSpectra = irmL != NULL&&irmR != NULL&&impulse->getFDLBlockSize() == FV3_FDL_BlockSize
+    &&irmL->getFDLCount() == impulse->getFDLCount()&&irmR->getFDLCount() == impulse->getFDLCount();
+  if(useSpectra) setSpectra(impulse);
+  try
+    {
+      loadImpulse(impulse->getImpulse(0), impulse->getImpulse(1), impulse->getImpulseSize());
+    }
+  catch(std::bad_alloc)
+    {
+      if(useSpectra) setSpectra(NULL);
+      impulse->release();
+      throw;
+    }
+  if(useSpectra) setSpectra(NULL);
+  // the previous spectra are not referred any more.
+  releasePrepared();
+  prepared = impulse;
+}
+
+FV3_(irprepared) * FV3_(irbase)::getPrepared()
+{
+  return prepared;
+}
+
+bool FV3_(irbase)::saveSpectra(const char * filename, const fv3_float_t * inputL, const fv3_float_t * inputR, long size, long sampleRate)
+  
+{
+  FV3_(irprepared) * impulse = FV3_(irprepared)::create(this, inputL, inputR, size, sampleRate);
+  if(impulse == NULL) return false;
+  bool ok = impulse->save(filename);
+  impulse->release();
+  return ok;
+}
+
+bool FV3_(irbase)::loadSpectra(const char * filename, long sampleRate)
+  
+{
+  FV3_(irprepared) * impulse = FV3_(irprepared)::open(filename, sampleRate);
+  if(impulse == NULL) return false;
+  try
+    {
+      bindImpulse(impulse);
+    }
+  catch(std::bad_alloc)
+    {
+      impulse->release();
+      throw;
+    }
+  impulse->release();
+  return true;
+}
+
+void FV3_(irbase)::setSpectra(FV3_(irprepared) * impulse)
+{
+  long fdlCount = irmL->getFDLCount();
+  for(long i = 0;i < 2*fdlCount;i ++)
+    {
+      long ch = i < fdlCount ? 0 : 1, f = i%fdlCount;
+      FV3_(fragfdl) * fdl = ch == 0 ? irmL->getFDL(f) : irmR->getFDL(f);
+      if(impulse == NULL)
+        fdl->setSpectra(NULL, 0, 0, 0);
+      else
+        fdl->setSpectra(impulse->getSpectra(ch, f), impulse->getFragmentSize(ch, f), impulse->getFragmentCount(ch, f), impulse->getSIMDSize());
+    }
+}
+
+void FV3_(irbase)::releasePrepared()
+{
+  if(prepared == NULL) return;
+  prepared->release();
+  prepared = NULL;
+}
+
 void FV3_(irbase)::resume()
 {
   irmL->resume();
@@ -22,16 +22,21 @@
 #define _FV3_IRBASE_HPP
 
 #include <cstdio>
+#include <stdint.h>
 #include <cstdlib>
 #include <cstring>
 #include <cmath>
 #include <new>
+#include <atomic>
 
 #include <fftw3.h>
 
 #include "freeverb/delay.hpp"
 #include "freeverb/efilter.hpp"
 #include "freeverb/utils.hpp"
+#include "freeverb/slot.hpp"
+#include "freeverb/frag.hpp"
+#include "freeverb/lanes.hpp"
 
 namespace fv3
 {
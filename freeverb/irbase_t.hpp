@@ -37,8 +37,14 @@ class _FV3_(irbasem)
   virtual void suspend();
   virtual void mute() = 0;
   virtual void processreplace(_fv3_float_t *inputL, long numsamples) = 0;
+  // a new engine of the same type and configuration without the impulse, NULL = not supported
+  virtual _FV3_(irbasem) * clone();
+  // the frequency-domain delay lines which hold the impulse spectra, 0 = none
+  virtual long getFDLCount();
+  virtual _FV3_(fragfdl) * getFDL(long i);
   
  protected:
+  void cloneConfig(_FV3_(irbasem) * to);
   long impulseSize, latency;
   unsigned fftflags;
   uint32_t simdFlag1, simdFlag2;
@@ -48,8 +54,62 @@ class _FV3_(irbasem)
   _FV3_(irbasem)& operator=(const _FV3_(irbasem)& x);
 };
 
+class _FV3_(irbase);
+
+// An immutable impulse with the partitioned spectra of an engine configuration.
+// Many irbase instances can bind it, they only allocate their own delay lines.
+// The layout is also the spectra file format of irbase::saveSpectra().
+class _FV3_(irprepared)
+{
+ public:
+  // load the impulse into ir, copy its spectra and bind ir to them, refcount = 1
+  static _FV3_(irprepared) * create(_FV3_(irbase) * ir, const _fv3_float_t * inputL, const _fv3_float_t * inputR, long size, long sampleRate)
+    ;
+  // memory-map a spectra file, sampleRate 0 = not checked, NULL = failed, refcount = 1
+  static _FV3_(irprepared) * open(const char * filename, long sampleRate);
+  bool save(const char * filename);
+  void retain();
+  // deleted when the last reference is released
+  void release();
+  long getRefCount();
+
+  long getImpulseSize();
+  long getSampleRate();
+  const _fv3_float_t * getImpulse(long ch);
+  long getSIMDSize();
+  long getFDLBlockSize();
+  long getFDLCount();
+  long getFragmentSize(long ch, long i);
+  long getFragmentCount(long ch, long i);
+  const _fv3_float_t * getSpectra(long ch, long i);
+
+ private:
+  _FV3_(irprepared)();
+  _FV3_(~irprepared)();
+  _FV3_(irprepared)(const _FV3_(irprepared)& x);
+  _FV3_(irprepared)& operator=(const _FV3_(irprepared)& x);
+  struct header
+  {
+    char magic[8];
+    uint32_t byteOrder, version, floatSize, simdSize, fdlBlockSize, fdlCount;
+    int64_t sampleRate, impulseSize, impulseOffset;
+  };
+  struct fdlEntry
+  {
+    int64_t fragmentSize, fragmentCount, offset;
+  };
+  header * getHeader();
+  fdlEntry * getFDLs();
+  const char * validate(long sampleRate);
+  char * data;
+  size_t dataSize;
+  bool mapped;
+  std::atomic<long> refCount;
+};
+
 class _FV3_(irbase)
 {
+  friend class _FV3_(irprepared);
  public:
   _FV3_(irbase)();
   virtual _FV3_(~irbase)();
@@ -72,7 +132,16 @@ class _FV3_(irbase)
   virtual void mute();
   virtual void processreplace(const _fv3_float_t *inputL, const _fv3_float_t *inputR, _fv3_float_t *outputL, _fv3_float_t *outputR, long numsamples) = 0;
   virtual void processreplace(const _fv3_float_t *inputL, const _fv3_float_t *inputR, _fv3_float_t *outputL, _fv3_float_t *outputR, long numsamples, unsigned options);
+  // Strided buffers, the i-th sample of a channel is at [i*stride], stride >= 1.
+  // processstrided(LR, LR+1, 2, LR, LR+1, 2, numsamples) processes the interleaved LR in place.
+  // Each output must be the same as an input or must not overlap the inputs.
+  virtual void processstrided(const _fv3_float_t *inputL, const _fv3_float_t *inputR, long inputStride,
+                              _fv3_float_t *outputL, _fv3_float_t *outputR, long outputStride, long numsamples);
+  virtual void processstrided(const _fv3_float_t *inputL, const _fv3_float_t *inputR, long inputStride,
+                              _fv3_float_t *outputL, _fv3_float_t *outputR, long outputStride, long numsamples, unsigned options);
   virtual void processdrywetout(const _fv3_float_t *dL, const _fv3_float_t *dR, _fv3_float_t *wL, _fv3_float_t *wR, _fv3_float_t *oL, _fv3_float_t *oR, long numsamples);
+  virtual void processdrywetout(const _fv3_float_t *dL, const _fv3_float_t *dR, long dStride, _fv3_float_t *wL, _fv3_float_t *wR,
+                                _fv3_float_t *oL, _fv3_float_t *oR, long oStride, long numsamples);
   virtual void setwet(_fv3_float_t db);
   virtual _fv3_float_t getwet();
   virtual void setwetr(_fv3_float_t value);
@@ -89,8 +158,52 @@ class _FV3_(irbase)
   virtual _fv3_float_t getHPF();
   virtual void setLRBalance(_fv3_float_t value);
   virtual _fv3_float_t getLRBalance();
+
+  // Load the impulse into the new engines without touching the running ones.
+  // This may be called from a background thread while processreplace() is running.
+  // An impulse must be loaded by loadImpulse() first, which must not overlap with processreplace().
+  // The new engines are swapped in at the next block with an equal-power crossfade.
+  virtual void prepareImpulse(const _fv3_float_t * inputL, const _fv3_float_t * inputR, long size)
+    ;
+  // FV3_IR_SWAP_*
+  int getSwapState();
+  // taken by the next prepareImpulse()
+  void setCrossfadeLength(long numsamples);
+  long getCrossfadeLength();
+
+  // The channels of the blocks of numsamples >= size are processed in parallel
+  // by the persistent worker threads, 0 = always, < 0 = never (see lanes).
+  void setParallelThreshold(long size);
+  long getParallelThreshold();
+
+  // Load the prepared impulse. Its spectra are used without copying when the fragment sizes
+  // and the SIMD layout match the engines, otherwise the stored impulse is transformed as
+  // loadImpulse(). The impulse is retained until the next load or unload.
+  virtual void bindImpulse(_FV3_(irprepared) * impulse)
+    ;
+  _FV3_(irprepared) * getPrepared();
+  // Load the impulse and save it with the partitioned spectra of the current engine
+  // configuration. sampleRate is only stored for loadSpectra().
+  virtual bool saveSpectra(const char * filename, const _fv3_float_t * inputL, const _fv3_float_t * inputR, long size, long sampleRate)
+    ;
+  // bindImpulse() of the memory-mapped file of saveSpectra(), sampleRate 0 = not checked.
+  virtual bool loadSpectra(const char * filename, long sampleRate)
+    ;
   
  protected:
+  // called after irmL/irmR were replaced by the swap
+  virtual void attachEngines();
+  // the maximum numsamples of processSwapIn/Out, 0 = the hot-swap is not supported
+  virtual long getSwapBlockSize();
+  // called by the processreplace thread before and after irmL/irmR process the wet signal
+  void processSwapIn(const _fv3_float_t *wL, const _fv3_float_t *wR, long numsamples);
+  void processSwapOut(_fv3_float_t *wL, _fv3_float_t *wR, long numsamples);
+  // process the wet input wL/wR by the old engines swapL/swapR while they are faded out
+  virtual void processSwapEngines(_fv3_float_t *wL, _fv3_float_t *wR, long numsamples);
+  // delete the engines which are not used any more, must not be called while processreplace() is running
+  void freeSwap();
+  // drop the reference of bindImpulse(), the engines must not refer to it any more
+  void releasePrepared();
   void update();
   _fv3_float_t wet, wetdB, dry, drydB, width, lrbalance, wet1, wet2, wet1L, wet2L, wet1R, wet2R;
   _FV3_(delay) delayDL, delayDR, delayWL, delayWR;
@@ -99,8 +212,15 @@ class _FV3_(irbase)
   unsigned fftflags, processoptions;
   uint32_t simdFlag1, simdFlag2;
   _FV3_(irbasem) *irmL, *irmR;
+  _FV3_(irbasem) *swapL, *swapR;
+  _FV3_(slot) swapW, swapGain;
+  long swapSize, swapFadeLength, crossfadeLength, crossfadeCursor;
+  _FV3_(lanes) lanes;
+  std::atomic<int> swapState;
+  _FV3_(irprepared) * prepared;
   
  private:
+  void setSpectra(_FV3_(irprepared) * impulse);
   _FV3_(irbase)(const _FV3_(irbase)& x);
   _FV3_(irbase)& operator=(const _FV3_(irbase)& x);
 };
@@ -27,6 +27,7 @@
 FV3_(irmodel1m)::FV3_(irmodel1m)()
 {
   impulseSize = fragmentSize = current = 0;
+  planRevrL = planOrigL = NULL;
 }
 
 FV3_(irmodel1m)::FV3_(~irmodel1m)()
@@ -54,17 +55,13 @@ void FV3_(irmodel1m)::loadImpulse(const fv3_float_t * inputL, long size)
 	  fifo.alloc(3*impulseSize, 1);
 	  delayline.alloc(2*impulseSize, 1);
 	  
-	  FV3_(slot) impulse; // normalize impulse with fragment length
-	  impulse.alloc(2*fragmentSize, 1);
-	  for(long i = 0;i < size;i ++){ impulse.L[i] = inputL[i]/(fv3_float_t)(fragmentSize*2); }
-	  FFTW_(plan) planL; // DFT 2^n impulse
-	  planL = FFTW_(plan_r2r_1d)(2*fragmentSize, impulse.L, fftImpl.L, FFTW_R2HC, FFTW_ESTIMATE);
-	  FFTW_(execute)(planL);
-	  FFTW_(destroy_plan)(planL);
-	  
 	  fftRevr.alloc(2*fragmentSize, 1); // input signal processing plans
-	  planRevrL = FFTW_(plan_r2r_1d)(fragmentSize*2, fftRevr.L, fftRevr.L, FFTW_HC2R, fftflags);
-	  planOrigL = FFTW_(plan_r2r_1d)(fragmentSize*2, fftRevr.L, fftRevr.L, FFTW_R2HC, fftflags);
+	  planRevrL = FV3_(fftplan)::acquire(fragmentSize*2, FFTW_HC2R, fftflags, true);
+	  planOrigL = FV3_(fftplan)::acquire(fragmentSize*2, FFTW_R2HC, fftflags, true);
+	  
+	  // normalize impulse with fragment length, DFT 2^n impulse
+	  for(long i = 0;i < size;i ++){ fftImpl.L[i] = inputL[i]/(fv3_float_t)(fragmentSize*2); }
+	  FFTW_(execute_r2r)(planOrigL, fftImpl.L, fftImpl.L);
 
       latency = impulseSize;
       mute();
@@ -85,8 +82,9 @@ void FV3_(irmodel1m)::unloadImpulse()
   delayline.free();
   fftImpl.free();
   fftRevr.free();
-  FFTW_(destroy_plan)(planRevrL);
-  FFTW_(destroy_plan)(planOrigL);
+  FV3_(fftplan)::release(planRevrL);
+  FV3_(fftplan)::release(planOrigL);
+  planRevrL = planOrigL = NULL;
 }
 
 void FV3_(irmodel1m)::mute()
@@ -96,6 +94,13 @@ void FV3_(irmodel1m)::mute()
   fifo.mute();
 }
 
+FV3_(irbasem) * FV3_(irmodel1m)::clone()
+{
+  FV3_(irmodel1m) *ir = new FV3_(irmodel1m);
+  cloneConfig(ir);
+  return ir;
+}
+
 long FV3_(irmodel1m)::getFragmentSize()
 {
   if(impulseSize == 0) return 0;
@@ -128,7 +133,7 @@ void FV3_(irmodel1m)::processSquareReplace(fv3_float_t *inputL)
 {
   fftRevr.mute();
   std::memcpy(fftRevr.L, inputL, sizeof(fv3_float_t)*impulseSize);
-  FFTW_(execute)(planOrigL); // inputL -DFT(replace)-> fftRevr
+  FFTW_(execute_r2r)(planOrigL, fftRevr.L, fftRevr.L); // inputL -DFT(replace)-> fftRevr
   fftRevr.L[0] *= fftImpl.L[0];
   fftRevr.L[fragmentSize] *= fftImpl.L[fragmentSize];
   for(long i = 1;i < fragmentSize;i ++)
@@ -142,7 +147,7 @@ void FV3_(irmodel1m)::processSquareReplace(fv3_float_t *inputL)
 		fftRevr.L[2*fragmentSize-i] = e*g + f*d;
       }
     }
-  FFTW_(execute)(planRevrL);
+  FFTW_(execute_r2r)(planRevrL, fftRevr.L, fftRevr.L);
   
   // XXXXOOOO // sigma
   // OXXXXOOO
@@ -174,7 +179,9 @@ void FV3_(irmodel1m)::processSquareReplace(fv3_float_t *inputL)
 
 FV3_(irmodel1)::FV3_(irmodel1)()
 {
-  fragmentSize = 0;
+  fragmentSize = laneSamples = stereoTail = 0;
+  dryL = dryR = NULL;
+  dryStride = 1;
   try
     {
       irmL = new FV3_(irmodel1m);
@@ -221,7 +228,9 @@ void FV3_(irmodel1)::loadImpulse(const fv3_float_t * inputL, const fv3_float_t *
 void FV3_(irmodel1)::unloadImpulse()
 {
   impulseSize = 0;
+  freeSwap();
   irmL->unloadImpulse(), irmR->unloadImpulse();
+  releasePrepared();
   inputW.free();
   inputD.free();
 }
@@ -232,6 +241,7 @@ void FV3_(irmodel1)::mute()
   irmL->mute(), irmR->mute();
   inputW.mute();
   inputD.mute();
+  stereoTail = 0;
 }
 
 long FV3_(irmodel1)::getFragmentSize()
@@ -240,45 +250,124 @@ long FV3_(irmodel1)::getFragmentSize()
   return fragmentSize;
 }
 
+long FV3_(irmodel1)::getSwapBlockSize()
+{
+  return inputW.getsize();
+}
+
 void FV3_(irmodel1)::processreplace(const fv3_float_t *inputL, const fv3_float_t *inputR, fv3_float_t *outputL, fv3_float_t *outputR, long numsamples)
 {
+  FV3_(denormalguard) guard;
   if(numsamples <= 0||impulseSize <= 0) return;
   long div = numsamples/impulseSize;
   for(long i = 0;i < div;i ++) processreplaceS(inputL+i*impulseSize, inputR+i*impulseSize, outputL+i*impulseSize, outputR+i*impulseSize, impulseSize);
   processreplaceS(inputL+div*impulseSize, inputR+div*impulseSize, outputL+div*impulseSize, outputR+div*impulseSize, numsamples%impulseSize);
 }
 
-void FV3_(irmodel1)::processreplaceS(const fv3_float_t *inputL, const fv3_float_t *inputR, fv3_float_t *outputL, fv3_float_t *outputR, long numsamples)
+void FV3_(irmodel1)::processstrided(const fv3_float_t *inputL, const fv3_float_t *inputR, long inputStride,
+                                    fv3_float_t *outputL, fv3_float_t *outputR, long outputStride, long numsamples)
 {
+  FV3_(denormalguard) guard;
   if(numsamples <= 0||impulseSize <= 0) return;
-  
+  if(inputStride < 1||outputStride < 1)
+    {
+      std::fprintf(stderr, "irmodel1::processstrided(%ld,%ld) invalid stride\n", inputStride, outputStride);
+      return;
+    }
+  while(numsamples > 0)
+    {
+      long n = getNextBlockSize();
+      if(n <= 0||n > numsamples) n = numsamples;
+      processreplaceS(inputL, inputR, inputStride, outputL, outputR, outputStride, n);
+      inputL += n*inputStride, inputR += n*inputStride;
+      outputL += n*outputStride, outputR += n*outputStride;
+      numsamples -= n;
+    }
+}
+
+long FV3_(irmodel1)::getNextBlockSize()
+{
+  return impulseSize;
+}
+
+bool FV3_(irmodel1)::isOverlapped(const fv3_float_t *input, long inputStride, const fv3_float_t *output, long outputStride, long numsamples)
+{
+  if(numsamples <= 0||(input == output&&inputStride == outputStride)) return false;
+  if(output+(numsamples-1)*outputStride < input||input+(numsamples-1)*inputStride < output) return false;
+  // the interleaved channels never hit the samples of each other
+  if(inputStride == outputStride&&(output-input)%inputStride != 0) return false;
+  return true;
+}
+
+void FV3_(irmodel1)::processInput(const fv3_float_t *inputL, const fv3_float_t *inputR, long inputStride,
+                                  const fv3_float_t *outputL, const fv3_float_t *outputR, long outputStride, long numsamples)
+{
   if((processoptions & FV3_IR_MONO2STEREO) != 0)
     {
-      for(long i = 0;i < numsamples;i ++) inputW.L[i] = inputW.R[i] = (inputL[i] + inputR[i])/2.0;
+      for(long i = 0;i < numsamples;i ++) inputW.L[i] = inputW.R[i] = (inputL[i*inputStride] + inputR[i*inputStride])/2.0;
     }
-  else
+  else if(inputStride == 1)
     {
       std::memcpy(inputW.L, inputL, sizeof(fv3_float_t)*numsamples);
       std::memcpy(inputW.R, inputR, sizeof(fv3_float_t)*numsamples);
     }
-  std::memcpy(inputD.L, inputL, sizeof(fv3_float_t)*numsamples);
-  std::memcpy(inputD.R, inputR, sizeof(fv3_float_t)*numsamples);
+  else
+    {
+      for(long i = 0;i < numsamples;i ++){ inputW.L[i] = inputL[i*inputStride], inputW.R[i] = inputR[i*inputStride]; }
+    }
+
+  // processdrywetout() reads the dry chunk before it writes the output chunk
+  dryL = inputL, dryR = inputR, dryStride = inputStride;
+  if((processoptions & FV3_IR_MUTE_DRY) != 0) return;
+  if(isOverlapped(inputL, inputStride, outputL, outputStride, numsamples)||isOverlapped(inputL, inputStride, outputR, outputStride, numsamples)||
+     isOverlapped(inputR, inputStride, outputL, outputStride, numsamples)||isOverlapped(inputR, inputStride, outputR, outputStride, numsamples))
+    {
+      for(long i = 0;i < numsamples;i ++){ inputD.L[i] = inputL[i*inputStride], inputD.R[i] = inputR[i*inputStride]; }
+      dryL = inputD.L, dryR = inputD.R, dryStride = 1;
+    }
+}
+
+bool FV3_(irmodel1)::shareInput(bool share)
+{
+  return false;
+}
+
+void FV3_(irmodel1)::processShared(fv3_float_t *wL, fv3_float_t *wR, long numsamples){;}
+
+void FV3_(irmodel1)::processLane(void * arg, long lane)
+{
+  FV3_(irmodel1) * ir = (FV3_(irmodel1)*)arg;
+  if(lane == 0) ir->irmL->processreplace(ir->inputW.L, ir->laneSamples);
+  else ir->irmR->processreplace(ir->inputW.R, ir->laneSamples);
+}
+
+void FV3_(irmodel1)::processreplaceS(const fv3_float_t *inputL, const fv3_float_t *inputR, fv3_float_t *outputL, fv3_float_t *outputR, long numsamples)
+{
+  processreplaceS(inputL, inputR, 1, outputL, outputR, 1, numsamples);
+}
+
+void FV3_(irmodel1)::processreplaceS(const fv3_float_t *inputL, const fv3_float_t *inputR, long inputStride,
+                                     fv3_float_t *outputL, fv3_float_t *outputR, long outputStride, long numsamples)
+{
+  if(numsamples <= 0||impulseSize <= 0) return;
+  
+  processInput(inputL, inputR, inputStride, outputL, outputR, outputStride, numsamples);
+  processSwapIn(inputW.L, inputW.R, numsamples);
   
-#pragma omp parallel
-#pragma omp sections
-  {
-#pragma omp section
+  if(shareInput((processoptions & FV3_IR_MONO2STEREO) != 0))
     {
-      irmL->processreplace(inputW.L, numsamples);
+      // the same input is transformed only once
+      processShared(inputW.L, inputW.R, numsamples);
     }
-#pragma omp section
+  else
     {
-      irmR->processreplace(inputW.R, numsamples);
+      laneSamples = numsamples;
+      lanes.run(processLane, this, 2, numsamples);
     }
-  }
-#pragma omp barrier
+  stereoTail -= numsamples;
+  processSwapOut(inputW.L, inputW.R, numsamples);
 
-  processdrywetout(inputD.L, inputD.R, inputW.L, inputW.R, outputL, outputR, numsamples);
+  processdrywetout(dryL, dryR, dryStride, inputW.L, inputW.R, outputL, outputR, outputStride, numsamples);
 }
 
 #include "freeverb/fv3_ns_end.h"
@@ -31,6 +31,7 @@
 #include "freeverb/delay.hpp"
 #include "freeverb/efilter.hpp"
 #include "freeverb/slot.hpp"
+#include "freeverb/fftplan.hpp"
 #include "freeverb/irbase.hpp"
 #include "freeverb/fv3_defs.h"
 
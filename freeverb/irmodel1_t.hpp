@@ -28,6 +28,7 @@ class _FV3_(irmodel1m) : public _FV3_(irbasem)
   virtual void unloadImpulse();
   virtual void processreplace(_fv3_float_t *inputL, long numsamples);
   virtual void mute();
+  virtual _FV3_(irbasem) * clone();
   
   long getFragmentSize();
   
@@ -50,14 +51,40 @@ class _FV3_(irmodel1) : public _FV3_(irbase)
   virtual void unloadImpulse();
   using _FV3_(irbase)::processreplace;
   virtual void processreplace(const _fv3_float_t *inputL, const _fv3_float_t *inputR, _fv3_float_t *outputL, _fv3_float_t *outputR, long numsamples);
+  using _FV3_(irbase)::processstrided;
+  virtual void processstrided(const _fv3_float_t *inputL, const _fv3_float_t *inputR, long inputStride,
+                              _fv3_float_t *outputL, _fv3_float_t *outputR, long outputStride, long numsamples);
+  // forwards to the strided processreplaceS() with the stride 1
   virtual void processreplaceS(const _fv3_float_t *inputL, const _fv3_float_t *inputR, _fv3_float_t *outputL, _fv3_float_t *outputR, long numsamples);
+  virtual void processreplaceS(const _fv3_float_t *inputL, const _fv3_float_t *inputR, long inputStride,
+                               _fv3_float_t *outputL, _fv3_float_t *outputR, long outputStride, long numsamples);
   virtual void mute();
   
   virtual long getFragmentSize();
 
  protected:
-  long fragmentSize;
+  virtual long getSwapBlockSize();
+  // the maximum numsamples of the next processreplaceS() of processstrided()
+  virtual long getNextBlockSize();
+  // gather the input into inputW and select the dry input of processdrywetout(),
+  // inputD is used only if the outputs overwrite the input before it is read
+  void processInput(const _fv3_float_t *inputL, const _fv3_float_t *inputR, long inputStride,
+                    const _fv3_float_t *outputL, const _fv3_float_t *outputR, long outputStride, long numsamples);
+  static bool isOverlapped(const _fv3_float_t *input, long inputStride, const _fv3_float_t *output, long outputStride, long numsamples);
+  // FV3_IR_MONO2STEREO: irmR takes the input spectra of irmL, false = not supported.
+  // false also stops the sharing.
+  virtual bool shareInput(bool share);
+  // process the mono wet signal wL into wL and wR while shareInput() is true
+  virtual void processShared(_fv3_float_t *wL, _fv3_float_t *wR, long numsamples);
+  // lane 0 = irmL, 1 = irmR, laneSamples of inputW
+  static void processLane(void * arg, long lane);
+  long fragmentSize, laneSamples;
+  // > 0 while the stereo input is still in the engines
+  long stereoTail;
   _FV3_(slot) inputW, inputD;
+  // the dry input of processdrywetout() set by processInput()
+  const _fv3_float_t *dryL, *dryR;
+  long dryStride;
 
  private:
   _FV3_(irmodel1)(const _FV3_(irmodel1)& x);
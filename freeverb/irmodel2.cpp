@@ -29,6 +29,7 @@ FV3_(irmodel2m)::FV3_(irmodel2m)()
 {
   setFragmentSize(FV3_IR2_DFragmentSize);
   fifoSize = 0;
+  inputLead = NULL;
 }
 
 FV3_(irmodel2m)::FV3_(~irmodel2m)()
@@ -44,8 +45,6 @@ void FV3_(irmodel2m)::loadImpulse(const fv3_float_t * inputL, long size)
   
   // For optimization, fragmentSize should be overriden if fragmentSize >>> impulsesize:
   // if(FV3_(utils)::checkPow2(impulsesize)/2 < size) fragmentSize = FV3_(utils)::checkPow2(size)/2;
-  long fragment_num = size / fragmentSize;
-  long fragment_mod = size % fragmentSize;
   try
     {
       fifoSlot.alloc(3*fragmentSize, 1);
@@ -58,26 +57,13 @@ void FV3_(irmodel2m)::loadImpulse(const fv3_float_t * inputL, long size)
       fragFFT.allocFFT(fragmentSize, fftflags);
       setSIMD(fragFFT.getSIMD(0),fragFFT.getSIMD(1));
       
-      for(long i = 0;i < fragment_num;i ++)
-		{
-		  FV3_(frag) * f = new FV3_(frag);
-		  fragments.push_back(f);
-		  f->setSIMD(simdFlag1, simdFlag2);
-		  f->loadImpulse(inputL+fragmentSize*i, fragmentSize, fragmentSize, fftflags);
-		}
-      if(fragment_mod != 0)
-		{
-		  FV3_(frag) * f = new FV3_(frag);
-		  fragments.push_back(f);
-		  f->setSIMD(simdFlag1, simdFlag2);
-		  f->loadImpulse(inputL+fragmentSize*fragment_num, fragmentSize, fragment_mod, fftflags);
-		}
-      blkdelayDL.setBlock(fragmentSize*2, (long)fragments.size());
+      fragmentsFDL.setSIMD(simdFlag1, simdFlag2);
+      fragmentsFDL.loadImpulse(inputL, fragmentSize, size, fftflags);
       impulseSize = size;
       latency = fragmentSize;
       mute();
 #ifdef DEBUG
-      std::fprintf(stderr, "irmodel2m::loadImpulse(): {%ldx%ld+%ld}\n", fragmentSize, fragment_num, fragment_mod);
+      std::fprintf(stderr, "irmodel2m::loadImpulse(): {%ldx%ld+%ld}\n", fragmentSize, size / fragmentSize, size % fragmentSize);
 #endif
     }
   catch(std::bad_alloc)
@@ -90,6 +76,7 @@ void FV3_(irmodel2m)::loadImpulse(const fv3_float_t * inputL, long size)
 
 void FV3_(irmodel2m)::unloadImpulse()
 {
+  inputLead = NULL;
   if(impulseSize == 0) return;
   impulseSize = 0;
   fifoSlot.free();
@@ -98,8 +85,7 @@ void FV3_(irmodel2m)::unloadImpulse()
   swapSlot.free();
   restSlot.free();
   fragFFT.freeFFT();
-  for(std::vector<FV3_(frag)*>::iterator i = fragments.begin();i != fragments.end();i ++) delete *i;
-  fragments.clear();
+  fragmentsFDL.unloadImpulse();
 }
 
 void FV3_(irmodel2m)::processreplace(fv3_float_t *inputL, long numsamples)
@@ -113,18 +99,139 @@ void FV3_(irmodel2m)::processreplace(fv3_float_t *inputL, long numsamples)
       return;
     }
 
-  std::memcpy(fifoSlot.L+fifoSize+fragmentSize, inputL, sizeof(fv3_float_t)*numsamples);
-  if(fifoSize+numsamples >= fragmentSize)
+  if(pushFIFO(inputL, numsamples))
+    {
+      fragmentsFDL.MULT(0, fragmentsFDL.getFragmentCount(), 0, swapSlot.L);
+      inverseFIFO();
+    }
+  popFIFO(inputL, numsamples);
+}
+
+void FV3_(irmodel2m)::processbatch(FV3_(irmodel2m) ** ir, fv3_float_t ** inputL, long count, long numsamples)
+{
+  FV3_(denormalguard) guard;
+  if(numsamples <= 0) return;
+  FV3_(irmodel2m) * group[FV3_IR_BatchSize];
+  fv3_float_t * groupL[FV3_IR_BatchSize];
+  FV3_(fragfdl) * groupFDL[FV3_IR_BatchSize];
+  fv3_float_t * groupO[FV3_IR_BatchSize];
+  long done = 0;
+  while(done < count)
+    {
+      // Collect the streams which can run in lockstep with the first one.
+      // Derived models, different states or impulses are processed one by one.
+      long n = 0;
+      for(;done < count&&n < FV3_IR_BatchSize;done ++)
+        {
+          FV3_(irmodel2m) * m = ir[done];
+          if(typeid(*m) != typeid(FV3_(irmodel2m))||m->impulseSize <= 0||
+             (n > 0&&(m->fragmentSize != group[0]->fragmentSize||m->fifoSize != group[0]->fifoSize||
+                      m->fragmentsFDL.getImpulseBlock() != group[0]->fragmentsFDL.getImpulseBlock())))
+            {
+              if(n > 0) break;
+              m->processreplace(inputL[done], numsamples);
+              continue;
+            }
+          group[n] = m, groupL[n] = inputL[done];
+          groupFDL[n] = &m->fragmentsFDL, groupO[n] = m->swapSlot.L, n ++;
+        }
+      if(n == 0) continue;
+      long fragmentSize = group[0]->fragmentSize;
+      for(long pos = 0;pos < numsamples;)
+        {
+          long len = numsamples - pos < fragmentSize ? numsamples - pos : fragmentSize;
+          // the FIFOs of the group are in the same state
+          bool full = false;
+          for(long k = 0;k < n;k ++) full = group[k]->pushFIFO(groupL[k]+pos, len);
+          if(full)
+            {
+              FV3_(fragfdl)::MULT(groupFDL, n, 0, groupFDL[0]->getFragmentCount(), 0, groupO);
+              for(long k = 0;k < n;k ++) group[k]->inverseFIFO();
+            }
+          for(long k = 0;k < n;k ++) group[k]->popFIFO(groupL[k]+pos, len);
+          pos += len;
+        }
+    }
+}
+
+bool FV3_(irmodel2m)::shareInput(FV3_(irmodel2m) * lead)
+  
+{
+  if(lead == this) lead = NULL;
+  if(lead == inputLead) return true;
+  if(lead == NULL)
+    {
+      fragmentsFDL.shareDelay(NULL);
+      inputLead = NULL;
+      return true;
+    }
+  if(typeid(*this) != typeid(FV3_(irmodel2m))||typeid(*lead) != typeid(FV3_(irmodel2m))||
+     impulseSize <= 0||lead->impulseSize <= 0||lead->inputLead != NULL||
+     lead->fragmentSize != fragmentSize||lead->fifoSize != fifoSize) return false;
+  if(inputLead != NULL) shareInput(NULL);
+  if(!fragmentsFDL.shareDelay(&lead->fragmentsFDL)) return false;
+  inputLead = lead;
+  return true;
+}
+
+FV3_(irmodel2m) * FV3_(irmodel2m)::getInputLead()
+{
+  return inputLead;
+}
+
+void FV3_(irmodel2m)::processshared(FV3_(irmodel2m) * lead, FV3_(irmodel2m) * follow, fv3_float_t *inputL, fv3_float_t *outputR, long numsamples,
+                                    FV3_(lanes) * lanes)
+{
+  if(numsamples <= 0||lead->impulseSize <= 0) return;
+  long fragmentSize = lead->fragmentSize;
+  for(long pos = 0;pos < numsamples;)
     {
-      fragFFT.R2HC(fifoSlot.L+fragmentSize, ifftSlot.L);
-      swapSlot.mute();
-      for(long i = 0;i < (long)fragments.size();i ++){ fragments[i]->MULT(blkdelayDL.at(ifftSlot.L, i), swapSlot.L); }
-      fragFFT.HC2R(swapSlot.L, reverseSlot.L);
-      std::memcpy(fifoSlot.L+fragmentSize, reverseSlot.L, sizeof(fv3_float_t)*fragmentSize);
-      std::memcpy(reverseSlot.L, reverseSlot.L+fragmentSize, sizeof(fv3_float_t)*(fragmentSize-1));
-      reverseSlot.mute(fragmentSize-1, fragmentSize+1);
+      long len = numsamples - pos < fragmentSize ? numsamples - pos : fragmentSize;
+      // the lead pushes the spectrum before the follower reads it
+      bool full = lead->pushFIFO(inputL+pos, len);
+      follow->pushFIFO(inputL+pos, len);
+      if(full)
+        {
+          FV3_(irmodel2m) * ir[2] = { lead, follow, };
+          if(lanes != NULL) lanes->run(inverseLane, ir, 2, lead->impulseSize);
+          else inverseLane(ir, 0), inverseLane(ir, 1);
+        }
+      follow->popFIFO(outputR+pos, len);
+      lead->popFIFO(inputL+pos, len);
+      pos += len;
     }
-  std::memcpy(inputL, fifoSlot.L+fifoSize, sizeof(fv3_float_t)*numsamples);  
+}
+
+void FV3_(irmodel2m)::inverseLane(void * arg, long lane)
+{
+  FV3_(irmodel2m) * ir = ((FV3_(irmodel2m)**)arg)[lane];
+  ir->fragmentsFDL.MULT(0, ir->fragmentsFDL.getFragmentCount(), 0, ir->swapSlot.L);
+  ir->inverseFIFO();
+}
+
+bool FV3_(irmodel2m)::pushFIFO(const fv3_float_t *inputL, long numsamples)
+{
+  // numsamples <= fragmentSize
+  std::memcpy(fifoSlot.L+fifoSize+fragmentSize, inputL, sizeof(fv3_float_t)*numsamples);
+  if(fifoSize+numsamples < fragmentSize) return false;
+  // the spectrum is pushed into the shared delay line by the lead
+  if(inputLead == NULL) fragFFT.R2HC(fifoSlot.L+fragmentSize, ifftSlot.L);
+  swapSlot.mute();
+  fragmentsFDL.push(ifftSlot.L);
+  return true;
+}
+
+void FV3_(irmodel2m)::inverseFIFO()
+{
+  fragFFT.HC2R(swapSlot.L, reverseSlot.L);
+  std::memcpy(fifoSlot.L+fragmentSize, reverseSlot.L, sizeof(fv3_float_t)*fragmentSize);
+  std::memcpy(reverseSlot.L, reverseSlot.L+fragmentSize, sizeof(fv3_float_t)*(fragmentSize-1));
+  reverseSlot.mute(fragmentSize-1, fragmentSize+1);
+}
+
+void FV3_(irmodel2m)::popFIFO(fv3_float_t *outputL, long numsamples)
+{
+  std::memcpy(outputL, fifoSlot.L+fifoSize, sizeof(fv3_float_t)*numsamples);  
   fifoSize += numsamples;
   if(fifoSize >= fragmentSize)
     {
@@ -151,8 +258,7 @@ void FV3_(irmodel2m)::setFragmentSize(long size)
 void FV3_(irmodel2m)::mute()
 {
   fifoSize = fragmentSize;
-  blkdelayDL.mute();
-  blkdelayDR.mute();
+  fragmentsFDL.mute();
   fifoSlot.mute();
   reverseSlot.mute();
   ifftSlot.mute();
@@ -160,6 +266,24 @@ void FV3_(irmodel2m)::mute()
   swapSlot.mute();
 }
 
+FV3_(irbasem) * FV3_(irmodel2m)::clone()
+{
+  FV3_(irmodel2m) *ir = new FV3_(irmodel2m);
+  cloneConfig(ir);
+  ir->setFragmentSize(fragmentSize);
+  return ir;
+}
+
+long FV3_(irmodel2m)::getFDLCount()
+{
+  return 1;
+}
+
+FV3_(fragfdl) * FV3_(irmodel2m)::getFDL(long i)
+{
+  return i == 0 ? &fragmentsFDL : NULL;
+}
+
 // irmodel2
 
 FV3_(irmodel2)::FV3_(irmodel2)()
@@ -190,6 +314,51 @@ FV3_(irmodel2)::FV3_(~irmodel2)()
   FV3_(irmodel2)::unloadImpulse();
 }
 
+long FV3_(irmodel2)::getNextBlockSize()
+{
+  return fragmentSize;
+}
+
+void FV3_(irmodel2)::attachEngines()
+{
+  ir2mL = static_cast<FV3_(irmodel2m)*>(irmL);
+  ir2mR = static_cast<FV3_(irmodel2m)*>(irmR);
+}
+
+bool FV3_(irmodel2)::shareInput(bool share)
+{
+  if(!share)
+    {
+      // the delay line of irmR holds the stereo input for the impulse and the frame
+      stereoTail = impulseSize + 2*fragmentSize;
+      ir2mR->shareInput(NULL);
+      return false;
+    }
+  if(stereoTail > 0) return false;
+  return ir2mR->shareInput(ir2mL);
+}
+
+void FV3_(irmodel2)::processShared(fv3_float_t *wL, fv3_float_t *wR, long numsamples)
+{
+  FV3_(irmodel2m)::processshared(ir2mL, ir2mR, wL, wR, numsamples, &lanes);
+}
+
+void FV3_(irmodel2)::processSwapEngines(fv3_float_t *wL, fv3_float_t *wR, long numsamples)
+{
+  FV3_(irmodel2m) *oldL = static_cast<FV3_(irmodel2m)*>(swapL), *oldR = static_cast<FV3_(irmodel2m)*>(swapR);
+  if(oldR->getInputLead() == oldL)
+    {
+      // the old engines keep sharing the mono input, nothing is unshared at the swap
+      if((processoptions & FV3_IR_MONO2STEREO) != 0)
+        {
+          FV3_(irmodel2m)::processshared(oldL, oldR, wL, wR, numsamples, &lanes);
+          return;
+        }
+      oldR->shareInput(NULL);
+    }
+  FV3_(irbase)::processSwapEngines(wL, wR, numsamples);
+}
+
 void FV3_(irmodel2)::setFragmentSize(long size)
 {
   if(size <= 0||size < FV3_IR_Min_FragmentSize||size != FV3_(utils)::checkPow2(size))
@@ -231,6 +400,7 @@ void FV3_(irmodel2)::loadImpulse(const fv3_float_t * inputL, const fv3_float_t *
 
 void FV3_(irmodel2)::processreplace(const fv3_float_t *inputL, const fv3_float_t *inputR, fv3_float_t *outputL, fv3_float_t *outputR, long numsamples)
 {
+  FV3_(denormalguard) guard;
   if(numsamples <= 0||impulseSize <= 0) return;
   long div = numsamples/fragmentSize;
   for(long i = 0;i < div;i ++)
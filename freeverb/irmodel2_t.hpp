@@ -28,16 +28,43 @@ class _FV3_(irmodel2m) : public _FV3_(irbasem)
   virtual void unloadImpulse();
   virtual void processreplace(_fv3_float_t *inputL, long numsamples);
   virtual void mute();
+  virtual _FV3_(irbasem) * clone();
+  virtual long getFDLCount();
+  virtual _FV3_(fragfdl) * getFDL(long i);
   
   long getFragmentSize();
   void setFragmentSize(long size);
 
+  // Process count independent streams in place. Streams of irmodel2m instances
+  // sharing one impulse (irbase::bindImpulse() or fragfdl::setSpectra()) and the
+  // same state are computed together: each spectrum of the impulse is multiplied
+  // with all of them in one pass.
+  static void processbatch(_FV3_(irmodel2m) ** ir, _fv3_float_t ** inputL, long count, long numsamples);
+
+  // Use the input spectra and the delay line of lead instead of computing them.
+  // lead must be loaded with the same size and state, and both must be processed
+  // by processshared() with the same input. NULL = compute them again.
+  bool shareInput(_FV3_(irmodel2m) * lead)
+    ;
+  // the shareInput() lead, NULL = not shared
+  _FV3_(irmodel2m) * getInputLead();
+  // inputL is processed by lead into inputL and by follow (shareInput(lead)) into outputR.
+  // The engines run on the lanes, NULL = in this thread.
+  static void processshared(_FV3_(irmodel2m) * lead, _FV3_(irmodel2m) * follow, _fv3_float_t *inputL, _fv3_float_t *outputR, long numsamples,
+                            _FV3_(lanes) * lanes);
+
  protected:
+  bool pushFIFO(const _fv3_float_t *inputL, long numsamples);
+  void inverseFIFO();
+  void popFIFO(_fv3_float_t *outputL, long numsamples);
+  // MULT() and inverseFIFO() of ((irmodel2m**)arg)[lane]
+  static void inverseLane(void * arg, long lane);
+
   long fragmentSize;
-  std::vector<_FV3_(frag)*> fragments;
+  _FV3_(fragfdl) fragmentsFDL;
   _FV3_(fragfft) fragFFT;
-  _FV3_(blockDelay) blkdelayDL, blkdelayDR;
   long fifoSize;
+  _FV3_(irmodel2m) * inputLead;
   _FV3_(slot) fifoSlot, reverseSlot, ifftSlot, swapSlot, restSlot;
 
  private:
@@ -58,6 +85,11 @@ class _FV3_(irmodel2) : public _FV3_(irmodel1)
   virtual void setFragmentSize(long size);
 
  protected:
+    virtual void attachEngines();
+    virtual long getNextBlockSize();
+    virtual bool shareInput(bool share);
+    virtual void processShared(_fv3_float_t *wL, _fv3_float_t *wR, long numsamples);
+    virtual void processSwapEngines(_fv3_float_t *wL, _fv3_float_t *wR, long numsamples);
     _FV3_(irmodel2m) *ir2mL, *ir2mR;
 
  private:
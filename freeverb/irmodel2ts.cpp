@@ -0,0 +1,201 @@
+/**
+ *  Impulse Response Processor model implementation
+ *  True Stereo Version
+ *
+ *  Copyright (C) 2006-2018 Teru Kamogashira
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "freeverb/irmodel2ts.hpp"
+#include "freeverb/fv3_type_float.h"
+#include "freeverb/fv3_ns_start.h"
+
+// irmodel2tsm
+
+FV3_(irmodel2tsm)::FV3_(irmodel2tsm)()
+{
+  crossLoaded = false;
+}
+
+FV3_(irmodel2tsm)::FV3_(~irmodel2tsm)()
+{
+  unloadCross();
+}
+
+void FV3_(irmodel2tsm)::loadCross(const fv3_float_t * inputX, long size)
+  
+{
+  unloadCross();
+  if(inputX == NULL||size <= 0||impulseSize <= 0) return;
+  try
+    {
+      // same layout as the spectra of fragFFT which are pushed into it
+      crossFDL.setSIMD(simdFlag1, simdFlag2);
+      crossFDL.loadImpulse(inputX, fragmentSize, size, fftflags);
+      crossLoaded = true;
+      mute();
+    }
+  catch(std::bad_alloc)
+    {
+      std::fprintf(stderr, "irmodel2tsm::loadCross(%ld) bad_alloc\n", size);
+      unloadCross();
+      throw;
+    }
+}
+
+void FV3_(irmodel2tsm)::unloadCross()
+{
+  if(!crossLoaded) return;
+  crossLoaded = false;
+  crossFDL.unloadImpulse();
+}
+
+void FV3_(irmodel2tsm)::unloadImpulse()
+{
+  unloadCross();
+  FV3_(irmodel2m)::unloadImpulse();
+}
+
+void FV3_(irmodel2tsm)::mute()
+{
+  FV3_(irmodel2m)::mute();
+  if(crossLoaded) crossFDL.mute();
+}
+
+FV3_(irbasem) * FV3_(irmodel2tsm)::clone()
+{
+  return NULL;
+}
+
+void FV3_(irmodel2tsm)::processpair(FV3_(irmodel2tsm) * a, FV3_(irmodel2tsm) * b, fv3_float_t *inputA, fv3_float_t *inputB, long numsamples,
+                                     FV3_(lanes) * lanes)
+{
+  if(numsamples <= 0||a->impulseSize <= 0||b->impulseSize <= 0) return;
+  long fragmentSize = a->fragmentSize;
+  if(numsamples > fragmentSize) // divide into fragmentSize pieces
+    {
+      long div = numsamples/fragmentSize;
+      for(long i = 0;i < div;i ++){ processpair(a, b, inputA+i*fragmentSize, inputB+i*fragmentSize, fragmentSize, lanes); }
+      processpair(a, b, inputA+div*fragmentSize, inputB+div*fragmentSize, numsamples%fragmentSize, lanes);
+      return;
+    }
+
+  // the FIFOs of the pair are in the same state
+  bool full = a->pushFIFO(inputA, numsamples);
+  b->pushFIFO(inputB, numsamples);
+  if(full)
+    {
+      FV3_(irmodel2tsm) * pair[2] = {a, b,};
+      if(lanes != NULL) lanes->run(pairLane, pair, 2, a->impulseSize);
+      else pairLane(pair, 0), pairLane(pair, 1);
+    }
+  a->popFIFO(inputA, numsamples);
+  b->popFIFO(inputB, numsamples);
+}
+
+void FV3_(irmodel2tsm)::pairLane(void * arg, long lane)
+{
+  FV3_(irmodel2tsm) ** pair = (FV3_(irmodel2tsm)**)arg;
+  FV3_(irmodel2tsm) * m = pair[lane], * x = pair[1-lane];
+  m->fragmentsFDL.MULT(0, m->fragmentsFDL.getFragmentCount(), 0, m->swapSlot.L);
+  if(m->crossLoaded)
+    {
+      // the spectrum of the other input, computed by its pushFIFO()
+      m->crossFDL.push(x->ifftSlot.L);
+      m->crossFDL.MULT(0, m->crossFDL.getFragmentCount(), 0, m->swapSlot.L);
+    }
+  m->inverseFIFO();
+}
+
+// irmodel2ts
+
+FV3_(irmodel2ts)::FV3_(irmodel2ts)()
+{
+  delete irmL, irmL = NULL;
+  delete irmR, irmR = NULL;
+  try
+    {
+      ir2tsmL = new FV3_(irmodel2tsm);
+      ir2tsmR = new FV3_(irmodel2tsm);
+      irmL = ir2mL = ir2tsmL;
+      irmR = ir2mR = ir2tsmR;
+    }
+  catch(std::bad_alloc)
+    {
+      delete irmL;
+      delete irmR;
+      throw;
+    }
+}
+
+FV3_(irmodel2ts)::FV3_(~irmodel2ts)()
+{
+  ;
+}
+
+void FV3_(irmodel2ts)::attachEngines()
+{
+  FV3_(irmodel2)::attachEngines();
+  ir2tsmL = static_cast<FV3_(irmodel2tsm)*>(irmL);
+  ir2tsmR = static_cast<FV3_(irmodel2tsm)*>(irmR);
+}
+
+long FV3_(irmodel2ts)::getSwapBlockSize()
+{
+  return 0;
+}
+
+void FV3_(irmodel2ts)::loadImpulse(const fv3_float_t * inputL, const fv3_float_t * inputR, long size)
+  
+{
+  loadImpulse(inputL, NULL, NULL, inputR, size);
+}
+
+void FV3_(irmodel2ts)::loadImpulse(const fv3_float_t * inputLL, const fv3_float_t * inputLR,
+                                   const fv3_float_t * inputRL, const fv3_float_t * inputRR, long size)
+  
+{
+  if(size <= 0||fragmentSize < FV3_IR_Min_FragmentSize) return;
+  unloadImpulse();
+  try
+    {
+      // the direct paths are always convolved, a NULL one is a silent impulse
+      FV3_(slot) silent;
+      if(inputLL == NULL||inputRR == NULL) silent.alloc(size, 1);
+      FV3_(irmodel2)::loadImpulse(inputLL != NULL ? inputLL : silent.L, inputRR != NULL ? inputRR : silent.L, size);
+      ir2tsmL->loadCross(inputRL, size);
+      ir2tsmR->loadCross(inputLR, size);
+      mute();
+    }
+  catch(std::bad_alloc)
+    {
+      std::fprintf(stderr, "irmodel2ts::loadImpulse(%ld) bad_alloc\n", size);
+      unloadImpulse();
+      throw;
+    }
+}
+
+void FV3_(irmodel2ts)::processreplaceS(const fv3_float_t *inputL, const fv3_float_t *inputR, long inputStride,
+                                       fv3_float_t *outputL, fv3_float_t *outputR, long outputStride, long numsamples)
+{
+  if(numsamples <= 0||impulseSize <= 0) return;
+  
+  processInput(inputL, inputR, inputStride, outputL, outputR, outputStride, numsamples);
+  FV3_(irmodel2tsm)::processpair(ir2tsmL, ir2tsmR, inputW.L, inputW.R, numsamples, &lanes);
+  processdrywetout(dryL, dryR, dryStride, inputW.L, inputW.R, outputL, outputR, outputStride, numsamples);
+}
+
+#include "freeverb/fv3_ns_end.h"
@@ -0,0 +1,81 @@
+/**
+ *  Impulse Response Processor model implementation
+ *  True Stereo Version
+ *
+ *  Copyright (C) 2006-2018 Teru Kamogashira
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+// One true stereo output channel: input x impulse + the other input x the cross impulse.
+// The input spectra of a pair are computed once and shared by both outputs.
+class _FV3_(irmodel2tsm) : public _FV3_(irmodel2m)
+{
+ public:
+  _FV3_(irmodel2tsm)();
+  virtual _FV3_(~irmodel2tsm)();
+  // the impulse from the other input channel to this output, loadImpulse() first
+  void loadCross(const _fv3_float_t * inputX, long size)
+    ;
+  void unloadCross();
+  virtual void unloadImpulse();
+  virtual void mute();
+  // the cross impulse is not a part of the hot-swap
+  virtual _FV3_(irbasem) * clone();
+
+  // Process the outputs of a loaded pair in place, a = inputA x impulse(a) + inputB x cross(a).
+  // The engines run on the lanes, NULL = in this thread.
+  static void processpair(_FV3_(irmodel2tsm) * a, _FV3_(irmodel2tsm) * b, _fv3_float_t *inputA, _fv3_float_t *inputB, long numsamples,
+                          _FV3_(lanes) * lanes);
+
+ protected:
+  // the direct and the cross MULT() and inverseFIFO() of ((irmodel2tsm**)arg)[lane]
+  static void pairLane(void * arg, long lane);
+  _FV3_(fragfdl) crossFDL;
+  bool crossLoaded;
+
+ private:
+  _FV3_(irmodel2tsm)(const _FV3_(irmodel2tsm)& x);
+  _FV3_(irmodel2tsm)& operator=(const _FV3_(irmodel2tsm)& x);
+};
+
+// True stereo (4 channel) convolution. The forward FFT of each input and the inverse FFT
+// of each output are done once per fragment, which is half of the FFTs of two irmodel2.
+class _FV3_(irmodel2ts) : public _FV3_(irmodel2)
+{
+ public:
+  _FV3_(irmodel2ts)();
+  virtual _FV3_(~irmodel2ts)();
+  // inputXY = the impulse from the input X to the output Y.
+  // NULL inputLR/inputRL skip the cross paths, NULL inputLL/inputRR are loaded as silent impulses.
+  virtual void loadImpulse(const _fv3_float_t * inputLL, const _fv3_float_t * inputLR,
+                           const _fv3_float_t * inputRL, const _fv3_float_t * inputRR, long size)
+    ;
+  // stereo impulse without the cross paths
+  virtual void loadImpulse(const _fv3_float_t * inputL, const _fv3_float_t * inputR, long size)
+    ;
+  using _FV3_(irmodel1)::processreplaceS;
+  virtual void processreplaceS(const _fv3_float_t *inputL, const _fv3_float_t *inputR, long inputStride,
+                               _fv3_float_t *outputL, _fv3_float_t *outputR, long outputStride, long numsamples);
+
+ protected:
+  virtual void attachEngines();
+  virtual long getSwapBlockSize();
+  _FV3_(irmodel2tsm) *ir2tsmL, *ir2tsmR;
+
+ private:
+  _FV3_(irmodel2ts)(const _FV3_(irmodel2ts)& x);
+  _FV3_(irmodel2ts)& operator=(const _FV3_(irmodel2ts)& x);
+};
@@ -98,14 +98,15 @@ void FV3_(irmodel2zlm)::processZL(fv3_float_t *inputL, fv3_float_t *outputL, lon
       zlFrameSlot.mute();
       reverseSlot.mute(fragmentSize-1, fragmentSize+1);
       swapSlot.mute();
-      for(long i = 1;i < (long)fragments.size();i ++){ fragments[i]->MULT(blkdelayDL.at(ifftSlot.L, i-1), swapSlot.L); }
+      fragmentsFDL.push(ifftSlot.L);
+      fragmentsFDL.MULT(1, fragmentsFDL.getFragmentCount(), 1, swapSlot.L);
     }
   zlOnlySlot.mute();
   std::memcpy(zlFrameSlot.L+ZLstart, inputL, sizeof(fv3_float_t)*numsamples);
   std::memcpy(zlOnlySlot.L+ZLstart, inputL, sizeof(fv3_float_t)*numsamples);
   
   fragFFT.R2HC(zlOnlySlot.L, ifftSlot.L);
-  fragments[0]->MULT(ifftSlot.L, swapSlot.L);
+  fragmentsFDL.MULT(0, ifftSlot.L, swapSlot.L);
   reverseSlot.mute();
   fragFFT.HC2R(swapSlot.L, reverseSlot.L);
   
@@ -127,6 +128,14 @@ void FV3_(irmodel2zlm)::mute()
   zlOnlySlot.mute();
 }
 
+FV3_(irbasem) * FV3_(irmodel2zlm)::clone()
+{
+  FV3_(irmodel2zlm) *ir = new FV3_(irmodel2zlm);
+  cloneConfig(ir);
+  ir->setFragmentSize(fragmentSize);
+  return ir;
+}
+
 // irmodel2zl
 
 FV3_(irmodel2zl)::FV3_(irmodel2zl)()
@@ -28,6 +28,7 @@ class _FV3_(irmodel2zlm) : public _FV3_(irmodel2m)
   virtual void unloadImpulse();
   virtual void processreplace(_fv3_float_t *inputL, long numsamples);
   virtual void mute();
+  virtual _FV3_(irbasem) * clone();
 
  protected:
   void processZL(_fv3_float_t *inputL, _fv3_float_t *outputL, long numsamples);
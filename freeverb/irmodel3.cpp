@@ -29,6 +29,7 @@ FV3_(irmodel3m)::FV3_(irmodel3m)()
 {
   setFragmentSize(FV3_IR3_DFragmentSize, FV3_IR3_DefaultFactor);
   Scursor = Lcursor = Lstep = 0;
+  inputLead = NULL;
 }
 
 FV3_(irmodel3m)::FV3_(~irmodel3m)()
@@ -43,6 +44,7 @@ void FV3_(irmodel3m)::loadImpulse(const fv3_float_t * inputL, long size)
   FV3_(irmodel3m)::unloadImpulse();
   
   impulseSize = size;
+#ifdef DEBUG
   long sFragmentNum = 0, lFragmentNum = 0, sFragmentMod = 0, lFragmentMod = 0;
   if(size <= lFragmentSize)
     {
@@ -57,8 +59,6 @@ void FV3_(irmodel3m)::loadImpulse(const fv3_float_t * inputL, long size)
       lFragmentNum = size / lFragmentSize - 1;
       lFragmentMod = size % lFragmentSize;
     }
-  
-#ifdef DEBUG  
   std::fprintf(stderr, "irmodel3::loadImpulse(): {L%ldx%ld+%ld/S%ldx%ld+%ld}\n", lFragmentSize, lFragmentNum, lFragmentMod,sFragmentSize, sFragmentNum, sFragmentMod);
 #endif
 
@@ -72,15 +72,13 @@ void FV3_(irmodel3m)::loadImpulse(const fv3_float_t * inputL, long size)
 
       setSIMD(sFragmentsFFT.getSIMD(0),sFragmentsFFT.getSIMD(1));
 
-      sImpulseFFTBlock.alloc(sFragmentSize*2*(sFragmentNum+1), 1);
-      lImpulseFFTBlock.alloc(lFragmentSize*2*(lFragmentNum+1), 1);
-      allocFrags(&sFragments, inputL, sFragmentSize, sFragmentNum, sFragmentMod, fftflags, sImpulseFFTBlock.L);
+      sFragmentsFDL.setSIMD(simdFlag1, simdFlag2);
+      sFragmentsFDL.loadImpulse(inputL, sFragmentSize, size <= lFragmentSize ? size : lFragmentSize, fftflags);
+      lFragmentsFDL.setSIMD(simdFlag1, simdFlag2);
       if(size > lFragmentSize)
         {
-          allocFrags(&lFragments, inputL+lFragmentSize, lFragmentSize, lFragmentNum, lFragmentMod, fftflags, lImpulseFFTBlock.L);
+          lFragmentsFDL.loadImpulse(inputL+lFragmentSize, lFragmentSize, size-lFragmentSize, fftflags);
         }
-      sBlockDelayL.setBlock(sFragmentSize*2, (long)sFragments.size());
-      lBlockDelayL.setBlock(lFragmentSize*2, (long)lFragments.size());
       latency = 0;
     }
   catch(std::bad_alloc)
@@ -94,49 +92,14 @@ void FV3_(irmodel3m)::loadImpulse(const fv3_float_t * inputL, long size)
 
 void FV3_(irmodel3m)::unloadImpulse()
 {
+  inputLead = NULL;
   if(impulseSize == 0) return;
   impulseSize = 0;
-  freeFrags(&sFragments);
-  freeFrags(&lFragments);
+  sFragmentsFDL.unloadImpulse();
+  lFragmentsFDL.unloadImpulse();
   freeSlots();
   sFragmentsFFT.freeFFT();
   lFragmentsFFT.freeFFT();
-  sImpulseFFTBlock.free();
-  lImpulseFFTBlock.free();
-}
-
-void FV3_(irmodel3m)::allocFrags(std::vector<FV3_(frag)*> *to, const fv3_float_t *inputL, long fragSize, long num, long mod, unsigned fftflags, fv3_float_t * preAllocL)
-  
-{
-  try
-    {
-      for(long i = 0;i < num;i ++)
-        {
-          FV3_(frag) * f = new FV3_(frag);
-          to->push_back(f);
-          f->setSIMD(simdFlag1, simdFlag2);
-          f->loadImpulse(inputL+fragSize*i, fragSize, fragSize, fftflags, preAllocL+fragSize*2*i);
-        }
-      if(mod != 0)
-        {
-          FV3_(frag) * f = new FV3_(frag);
-          to->push_back(f);
-          f->setSIMD(simdFlag1, simdFlag2);
-          f->loadImpulse(inputL+fragSize*num, fragSize, mod, fftflags, preAllocL+fragSize*2*num);
-        }
-    }
-  catch(std::bad_alloc)
-    {
-      std::fprintf(stderr, "irmodel3::allocFrags(%ld) bad_alloc\n", fragSize);
-      freeFrags(to);
-      throw;
-    }
-}
-
-void FV3_(irmodel3m)::freeFrags(std::vector<FV3_(frag)*> *v)
-{
-  for(std::vector<FV3_(frag)*>::iterator i = v->begin();i != v->end();i ++) delete *i;
-  v->clear();
 }
 
 void FV3_(irmodel3m)::allocSlots(long ssize, long lsize)
@@ -181,20 +144,170 @@ void FV3_(irmodel3m)::processreplace(fv3_float_t *inputL, long numsamples)
       for(long i = 0;i < div;i ++)
         processreplace(inputL+cursor+i*sFragmentSize, sFragmentSize);
       processreplace(inputL+cursor+div*sFragmentSize, mod);
+      return;
     }
 
   processZL(inputL, numsamples);
 }
 
+void FV3_(irmodel3m)::processbatch(FV3_(irmodel3m) ** ir, fv3_float_t ** inputL, long count, long numsamples)
+{
+  FV3_(denormalguard) guard;
+  if(numsamples <= 0) return;
+  FV3_(irmodel3m) * group[FV3_IR_BatchSize];
+  fv3_float_t * groupL[FV3_IR_BatchSize];
+  FV3_(fragfdl) * sFDL[FV3_IR_BatchSize], * lFDL[FV3_IR_BatchSize];
+  fv3_float_t * sO[FV3_IR_BatchSize], * lO[FV3_IR_BatchSize];
+  long done = 0;
+  while(done < count)
+    {
+      // Collect the streams which can run in lockstep with the first one.
+      // Derived models, different states or impulses are processed one by one.
+      long n = 0;
+      for(;done < count&&n < FV3_IR_BatchSize;done ++)
+        {
+          FV3_(irmodel3m) * m = ir[done];
+          if(typeid(*m) != typeid(FV3_(irmodel3m))||m->impulseSize <= 0||
+             (n > 0&&(m->sFragmentSize != group[0]->sFragmentSize||m->lFragmentSize != group[0]->lFragmentSize||
+                      m->Scursor != group[0]->Scursor||m->Lcursor != group[0]->Lcursor||m->Lstep != group[0]->Lstep||
+                      m->sFragmentsFDL.getImpulseBlock() != group[0]->sFragmentsFDL.getImpulseBlock()||
+                      m->lFragmentsFDL.getImpulseBlock() != group[0]->lFragmentsFDL.getImpulseBlock())))
+            {
+              if(n > 0) break;
+              m->processreplace(inputL[done], numsamples);
+              continue;
+            }
+          group[n] = m, groupL[n] = inputL[done];
+          sFDL[n] = &m->sFragmentsFDL, sO[n] = m->sSwapSlot.L;
+          lFDL[n] = &m->lFragmentsFDL, lO[n] = m->lSwapSlot.L, n ++;
+        }
+      if(n == 0) continue;
+      FV3_(irmodel3m) * lead = group[0];
+      for(long pos = 0;pos < numsamples;)
+        {
+          long len = lead->sFragmentSize - lead->Scursor;
+          if(len > numsamples - pos) len = numsamples - pos;
+          // the same steps as processZL()
+          bool sPushed = lead->Scursor == 0;
+          for(long k = 0;k < n;k ++) group[k]->processZLBegin();
+          if(sPushed) FV3_(fragfdl)::MULT(sFDL, n, 1, sFDL[0]->getFragmentCount(), 1, sO);
+          for(long k = 0;k < n;k ++) group[k]->processZLMiddle(groupL[k]+pos, len);
+          long Lstep = lead->Lstep, Ltarget = lead->getLtarget();
+          if(Ltarget > Lstep)
+            {
+              FV3_(fragfdl)::MULT(lFDL, n, Lstep+1, Ltarget+1, 1, lO);
+              for(long k = 0;k < n;k ++) group[k]->Lstep = Ltarget;
+            }
+          for(long k = 0;k < n;k ++) group[k]->processZLEnd();
+          pos += len;
+        }
+    }
+}
+
+bool FV3_(irmodel3m)::shareInput(FV3_(irmodel3m) * lead)
+  
+{
+  if(lead == this) lead = NULL;
+  if(lead == inputLead) return true;
+  if(lead == NULL)
+    {
+      // continue with the spectra which the lead has computed
+      sFragmentsFDL.shareDelay(NULL), lFragmentsFDL.shareDelay(NULL);
+      std::memcpy(sIFFTSlot.L, inputLead->sIFFTSlot.L, sizeof(fv3_float_t)*2*sFragmentSize);
+      std::memcpy(lIFFTSlot.L, inputLead->lIFFTSlot.L, sizeof(fv3_float_t)*2*lFragmentSize);
+      inputLead = NULL;
+      return true;
+    }
+  if(typeid(*this) != typeid(FV3_(irmodel3m))||typeid(*lead) != typeid(FV3_(irmodel3m))||
+     impulseSize <= 0||lead->impulseSize != impulseSize||lead->inputLead != NULL||
+     lead->sFragmentSize != sFragmentSize||lead->lFragmentSize != lFragmentSize||
+     lead->Scursor != Scursor||lead->Lcursor != Lcursor||lead->Lstep != Lstep) return false;
+  if(inputLead != NULL) shareInput(NULL);
+  if(!sFragmentsFDL.shareDelay(&lead->sFragmentsFDL)) return false;
+  if(!lFragmentsFDL.shareDelay(&lead->lFragmentsFDL))
+    {
+      sFragmentsFDL.shareDelay(NULL);
+      return false;
+    }
+  inputLead = lead;
+  return true;
+}
+
+FV3_(irmodel3m) * FV3_(irmodel3m)::getInputLead()
+{
+  return inputLead;
+}
+
+void FV3_(irmodel3m)::processshared(FV3_(irmodel3m) * lead, FV3_(irmodel3m) * follow, fv3_float_t *inputL, fv3_float_t *outputR, long numsamples,
+                                    FV3_(lanes) * lanes)
+{
+  if(numsamples <= 0||lead->impulseSize <= 0) return;
+  std::memcpy(outputR, inputL, sizeof(fv3_float_t)*numsamples);
+  FV3_(irmodel3m) * ir[2] = { lead, follow, };
+  fv3_float_t * io[2] = { inputL, outputR, };
+  for(long pos = 0;pos < numsamples;)
+    {
+      long len = lead->sFragmentSize - lead->Scursor;
+      if(len > numsamples - pos) len = numsamples - pos;
+      // the same steps as processZL(), the lead computes the spectra before the follower reads them
+      bool sPushed = lead->Scursor == 0;
+      for(long k = 0;k < 2;k ++) ir[k]->processZLBegin();
+      if(sPushed)
+        {
+          if(lanes != NULL) lanes->run(sMULTLane, ir, 2, lead->lFragmentSize);
+          else sMULTLane(ir, 0), sMULTLane(ir, 1);
+        }
+      for(long k = 0;k < 2;k ++) ir[k]->processZLMiddle(io[k]+pos, len);
+      long Ltarget = lead->getLtarget();
+      if(Ltarget > lead->Lstep)
+        {
+          if(lanes != NULL) lanes->run(lMULTLane, ir, 2, (Ltarget-lead->Lstep)*lead->lFragmentSize);
+          else lMULTLane(ir, 0), lMULTLane(ir, 1);
+        }
+      for(long k = 0;k < 2;k ++) ir[k]->processZLEnd();
+      pos += len;
+    }
+}
+
+void FV3_(irmodel3m)::sMULTLane(void * arg, long lane)
+{
+  FV3_(irmodel3m) * ir = ((FV3_(irmodel3m)**)arg)[lane];
+  ir->sFragmentsFDL.MULT(1, ir->sFragmentsFDL.getFragmentCount(), 1, ir->sSwapSlot.L);
+}
+
+void FV3_(irmodel3m)::lMULTLane(void * arg, long lane)
+{
+  FV3_(irmodel3m) * ir = ((FV3_(irmodel3m)**)arg)[lane];
+  long Ltarget = ir->getLtarget();
+  ir->lFragmentsFDL.MULT(ir->Lstep+1, Ltarget+1, 1, ir->lSwapSlot.L);
+  ir->Lstep = Ltarget;
+}
+
 void FV3_(irmodel3m)::processZL(fv3_float_t *inputL, long numsamples)
 {
   // numsamples <= sFragmentSize - Scursor
-  if(Lcursor == 0&&lFragments.size() > 0)
+  bool sPushed = Scursor == 0;
+  processZLBegin();
+  if(sPushed) sFragmentsFDL.MULT(1, sFragmentsFDL.getFragmentCount(), 1, sSwapSlot.L);
+  processZLMiddle(inputL, numsamples);
+  // [LVECTOR] large fragment vector multiplier
+  long Ltarget = getLtarget();
+  if(Ltarget > Lstep)
+    {
+      lFragmentsFDL.MULT(Lstep+1, Ltarget+1, 1, lSwapSlot.L);
+      Lstep = Ltarget;
+    }
+  processZLEnd();
+}
+
+void FV3_(irmodel3m)::processZLBegin()
+{
+  if(Lcursor == 0&&lFragmentsFDL.getFragmentCount() > 0)
     {
       lFrameSlot.mute();
       lReverseSlot.mute(lFragmentSize-1, lFragmentSize+1);
-      lBlockDelayL.push(lIFFTSlot.L);
-      lFragments[0]->MULT(lBlockDelayL.get(0), lSwapSlot.L);
+      lFragmentsFDL.push(lIFFTSlot.L);
+      lFragmentsFDL.MULT(0, inputLead != NULL ? inputLead->lIFFTSlot.L : lIFFTSlot.L, lSwapSlot.L);
       lFragmentsFFT.HC2R(lSwapSlot.L, lReverseSlot.L);
       lSwapSlot.mute();
       // The calculation of the large fragment vector was moved from here to [LVECTOR] to reduce CPU load spike.
@@ -204,23 +317,28 @@ void FV3_(irmodel3m)::processZL(fv3_float_t *inputL, long numsamples)
     {
       sFramePointerL = lFrameSlot.L+Lcursor;
       sSwapSlot.mute();
-      sBlockDelayL.push(sIFFTSlot.L);
-      for(long i = 1;i < (long)sFragments.size();i ++){ sFragments[i]->MULT(sBlockDelayL.get(i-1), sSwapSlot.L); }
+      sFragmentsFDL.push(sIFFTSlot.L);
+      // sFragmentsFDL.MULT(1, ...) follows
     }
+}
+
+void FV3_(irmodel3m)::processZLMiddle(fv3_float_t *inputL, long numsamples)
+{
   sOnlySlot.mute();
   
   std::memcpy(lFrameSlot.L+Lcursor, inputL, sizeof(fv3_float_t)*numsamples);
   std::memcpy(sOnlySlot.L+Scursor, inputL, sizeof(fv3_float_t)*numsamples);
   
-  if(sFragments.size() > 0)
+  if(sFragmentsFDL.getFragmentCount() > 0)
     {
-      sFragmentsFFT.R2HC(sOnlySlot.L, sIFFTSlot.L);
-      sFragments[0]->MULT(sIFFTSlot.L, sSwapSlot.L);
+      // the lead has transformed the same input
+      if(inputLead == NULL) sFragmentsFFT.R2HC(sOnlySlot.L, sIFFTSlot.L);
+      sFragmentsFDL.MULT(0, inputLead != NULL ? inputLead->sIFFTSlot.L : sIFFTSlot.L, sSwapSlot.L);
       sReverseSlot.mute();
       sFragmentsFFT.HC2R(sSwapSlot.L, sReverseSlot.L);
     }
   
-  if(lFragments.size() > 0)
+  if(lFragmentsFDL.getFragmentCount() > 0)
     {
       for(long i = 0;i < numsamples;i ++){ inputL[i] = (sReverseSlot.L+Scursor)[i] + (restSlot.L+Scursor)[i] + (lReverseSlot.L+Lcursor)[i]; }
     }
@@ -230,26 +348,27 @@ void FV3_(irmodel3m)::processZL(fv3_float_t *inputL, long numsamples)
     }
   
   Scursor += numsamples, Lcursor += numsamples;
-  
-  // [LVECTOR] large fragment vector multiplier
-  for(long i = Lstep;i < (((long)lFragments.size())-1)*Lcursor/lFragmentSize;i ++)
-    {
-      if(((long)lFragments.size()) > i + 1){ lFragments[i+1]->MULT(lBlockDelayL.get(i), lSwapSlot.L); }
-      Lstep ++;
-    }
-  
-  if(Scursor == sFragmentSize&&sFragments.size() > 0)
+}
+
+long FV3_(irmodel3m)::getLtarget()
+{
+  return (lFragmentsFDL.getFragmentCount()-1)*Lcursor/lFragmentSize;
+}
+
+void FV3_(irmodel3m)::processZLEnd()
+{
+  if(Scursor == sFragmentSize&&sFragmentsFDL.getFragmentCount() > 0)
     {
-      sFragmentsFFT.R2HC(sFramePointerL, sIFFTSlot.L);
+      if(inputLead == NULL) sFragmentsFFT.R2HC(sFramePointerL, sIFFTSlot.L);
       std::memcpy(restSlot.L, sReverseSlot.L+sFragmentSize, sizeof(fv3_float_t)*(sFragmentSize-1));
       Scursor = 0;
     }
   
   if(Lcursor == lFragmentSize)
     {
-      if(lFragments.size() > 0)
+      if(lFragmentsFDL.getFragmentCount() > 0)
         {
-          lFragmentsFFT.R2HC(lFrameSlot.L, lIFFTSlot.L);
+          if(inputLead == NULL) lFragmentsFFT.R2HC(lFrameSlot.L, lIFFTSlot.L);
           std::memcpy(lReverseSlot.L, lReverseSlot.L+lFragmentSize, sizeof(fv3_float_t)*(lFragmentSize-1));
         }
       Lcursor = Lstep = 0;
@@ -260,8 +379,8 @@ void FV3_(irmodel3m)::mute()
 {
   if(impulseSize == 0) return;
   Scursor = Lcursor = Lstep = 0;
-  sBlockDelayL.mute();
-  lBlockDelayL.mute();
+  sFragmentsFDL.mute();
+  lFragmentsFDL.mute();
   sReverseSlot.mute();
   lReverseSlot.mute();
   sIFFTSlot.mute();
@@ -274,6 +393,26 @@ void FV3_(irmodel3m)::mute()
   sOnlySlot.mute();
 }
 
+FV3_(irbasem) * FV3_(irmodel3m)::clone()
+{
+  FV3_(irmodel3m) *ir = new FV3_(irmodel3m);
+  cloneConfig(ir);
+  if(sFragmentSize > 0) ir->setFragmentSize(sFragmentSize, lFragmentSize/sFragmentSize);
+  return ir;
+}
+
+long FV3_(irmodel3m)::getFDLCount()
+{
+  return 2;
+}
+
+FV3_(fragfdl) * FV3_(irmodel3m)::getFDL(long i)
+{
+  if(i == 0) return &sFragmentsFDL;
+  if(i == 1) return &lFragmentsFDL;
+  return NULL;
+}
+
 void FV3_(irmodel3m)::setFragmentSize(long size, long factor)
 {
   if(size <= 0||factor <= 0||size < FV3_IR_Min_FragmentSize||size != FV3_(utils)::checkPow2(size)||factor != FV3_(utils)::checkPow2(factor))
@@ -291,8 +430,8 @@ void FV3_(irmodel3m)::setFragmentSize(long size, long factor)
 
 long FV3_(irmodel3m)::getSFragmentSize(){ return sFragmentSize; }
 long FV3_(irmodel3m)::getLFragmentSize(){ return lFragmentSize; }
-long FV3_(irmodel3m)::getSFragmentCount(){ return (long)sFragments.size(); }
-long FV3_(irmodel3m)::getLFragmentCount(){ return (long)lFragments.size(); }
+long FV3_(irmodel3m)::getSFragmentCount(){ return sFragmentsFDL.getFragmentCount(); }
+long FV3_(irmodel3m)::getLFragmentCount(){ return lFragmentsFDL.getFragmentCount(); }
 long FV3_(irmodel3m)::getScursor(){ return Scursor; }
 
 // irmodel3
@@ -364,6 +503,7 @@ void FV3_(irmodel3)::setFragmentSize(long size, long factor)
 
 void FV3_(irmodel3)::processreplace(const fv3_float_t *inputL, const fv3_float_t *inputR, fv3_float_t *outputL, fv3_float_t *outputR, long numsamples)
 {
+  FV3_(denormalguard) guard;
   if(numsamples <= 0||impulseSize <= 0) return;
   long sFragmentSize = getSFragmentSize();
   long cursor = sFragmentSize - ir3mL->getScursor();  
@@ -382,6 +522,51 @@ void FV3_(irmodel3)::processreplace(const fv3_float_t *inputL, const fv3_float_t
     }
 }
 
+long FV3_(irmodel3)::getNextBlockSize()
+{
+  return getSFragmentSize() - ir3mL->getScursor();
+}
+
+void FV3_(irmodel3)::attachEngines()
+{
+  ir3mL = static_cast<FV3_(irmodel3m)*>(irmL);
+  ir3mR = static_cast<FV3_(irmodel3m)*>(irmR);
+}
+
+bool FV3_(irmodel3)::shareInput(bool share)
+{
+  if(!share)
+    {
+      // the delay line of irmR holds the stereo input for the impulse and the frame
+      stereoTail = impulseSize + 2*getLFragmentSize();
+      ir3mR->shareInput(NULL);
+      return false;
+    }
+  if(stereoTail > 0) return false;
+  return ir3mR->shareInput(ir3mL);
+}
+
+void FV3_(irmodel3)::processShared(fv3_float_t *wL, fv3_float_t *wR, long numsamples)
+{
+  FV3_(irmodel3m)::processshared(ir3mL, ir3mR, wL, wR, numsamples, &lanes);
+}
+
+void FV3_(irmodel3)::processSwapEngines(fv3_float_t *wL, fv3_float_t *wR, long numsamples)
+{
+  FV3_(irmodel3m) *oldL = static_cast<FV3_(irmodel3m)*>(swapL), *oldR = static_cast<FV3_(irmodel3m)*>(swapR);
+  if(oldR->getInputLead() == oldL)
+    {
+      // the old engines keep sharing the mono input, nothing is unshared at the swap
+      if((processoptions & FV3_IR_MONO2STEREO) != 0)
+        {
+          FV3_(irmodel3m)::processshared(oldL, oldR, wL, wR, numsamples, &lanes);
+          return;
+        }
+      oldR->shareInput(NULL);
+    }
+  FV3_(irbase)::processSwapEngines(wL, wR, numsamples);
+}
+
 long FV3_(irmodel3)::getSFragmentSize(){ return ir3mL->getSFragmentSize(); }
 long FV3_(irmodel3)::getLFragmentSize(){ return ir3mL->getLFragmentSize(); }
 long FV3_(irmodel3)::getSFragmentCount(){ return ir3mL->getSFragmentCount(); }
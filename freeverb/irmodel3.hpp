@@ -28,6 +28,7 @@
 #include <cmath>
 #include <vector>
 #include <new>
+#include <typeinfo>
 
 #include "freeverb/frag.hpp"
 #include "freeverb/delay.hpp"
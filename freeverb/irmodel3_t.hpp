@@ -28,6 +28,9 @@ class _FV3_(irmodel3m) : public _FV3_(irbasem)
   virtual void unloadImpulse();
   virtual void processreplace(_fv3_float_t *inputL, long numsamples);
   virtual void mute();
+  virtual _FV3_(irbasem) * clone();
+  virtual long getFDLCount();
+  virtual _FV3_(fragfdl) * getFDL(long i);
 
   void setFragmentSize(long size, long factor);
   long getSFragmentSize();
@@ -35,23 +38,46 @@ class _FV3_(irmodel3m) : public _FV3_(irbasem)
   long getSFragmentCount();
   long getLFragmentCount();
   long getScursor();
+
+  // Process count independent streams in place. Streams of irmodel3m instances
+  // sharing one impulse (irbase::bindImpulse() or fragfdl::setSpectra()) and the
+  // same state are computed together: each spectrum of the impulse is multiplied
+  // with all of them in one pass.
+  static void processbatch(_FV3_(irmodel3m) ** ir, _fv3_float_t ** inputL, long count, long numsamples);
+
+  // Use the input spectra and the delay lines of lead instead of computing them.
+  // lead must be loaded with the same sizes and state, and both must be processed
+  // by processshared() with the same input. NULL = compute them again.
+  bool shareInput(_FV3_(irmodel3m) * lead)
+    ;
+  // the shareInput() lead, NULL = not shared
+  _FV3_(irmodel3m) * getInputLead();
+  // inputL is processed by lead into inputL and by follow (shareInput(lead)) into outputR.
+  // The engines run on the lanes, NULL = in this thread.
+  static void processshared(_FV3_(irmodel3m) * lead, _FV3_(irmodel3m) * follow, _fv3_float_t *inputL, _fv3_float_t *outputR, long numsamples,
+                            _FV3_(lanes) * lanes);
   
  protected:
   virtual void processZL(_fv3_float_t *inputL, long numsamples);
+  // processZL() = Begin, MULT(1...), Middle, [LVECTOR], End
+  void processZLBegin();
+  void processZLMiddle(_fv3_float_t *inputL, long numsamples);
+  long getLtarget();
+  void processZLEnd();
+  // the small/large fragment MULT() steps of ((irmodel3m**)arg)[lane]
+  static void sMULTLane(void * arg, long lane);
+  static void lMULTLane(void * arg, long lane);
   
-  void allocFrags(std::vector<_FV3_(frag)*> *to, const _fv3_float_t *inputL, long fragSize, long num, long mod, unsigned fftflags, _fv3_float_t * preAllocL)
-    ;
-  void freeFrags(std::vector<_FV3_(frag)*> *v);
   void allocSlots(long ssize, long lsize)
     ;
   void freeSlots();
 
   long Lcursor, Scursor, Lstep, sFragmentSize, lFragmentSize;
-  _FV3_(slot) sReverseSlot, lReverseSlot, sIFFTSlot, lIFFTSlot, sSwapSlot, lSwapSlot, restSlot, fifoSlot, lFrameSlot, sOnlySlot, sImpulseFFTBlock, lImpulseFFTBlock;
+  _FV3_(slot) sReverseSlot, lReverseSlot, sIFFTSlot, lIFFTSlot, sSwapSlot, lSwapSlot, restSlot, fifoSlot, lFrameSlot, sOnlySlot;
   _fv3_float_t *sFramePointerL, *sFramePointerR;
-  std::vector<_FV3_(frag)*> sFragments, lFragments;
+  _FV3_(fragfdl) sFragmentsFDL, lFragmentsFDL;
   _FV3_(fragfft) sFragmentsFFT, lFragmentsFFT;
-  _FV3_(blockDelay) sBlockDelayL, lBlockDelayL;
+  _FV3_(irmodel3m) * inputLead;
 
  private:
   _FV3_(irmodel3m)(const _FV3_(irmodel3m)& x);
@@ -77,6 +103,11 @@ class _FV3_(irmodel3) : public _FV3_(irmodel1)
   void printconfig();
   
  protected:
+  virtual void attachEngines();
+  virtual long getNextBlockSize();
+  virtual bool shareInput(bool share);
+  virtual void processShared(_fv3_float_t *wL, _fv3_float_t *wR, long numsamples);
+  virtual void processSwapEngines(_fv3_float_t *wL, _fv3_float_t *wR, long numsamples);
   _FV3_(irmodel3m) *ir3mL, *ir3mR;
 
  private:
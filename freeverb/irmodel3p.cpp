@@ -23,88 +23,81 @@
 #include "freeverb/fv3_type_float.h"
 #include "freeverb/fv3_ns_start.h"
 
-static void * irmodel3p_lfthread(void *vdParam)
+FV3_(lfThreadJob)::FV3_(lfThreadJob)()
 {
-  FV3_(lfThreadInfoW) *info = (FV3_(lfThreadInfoW)*)vdParam;
-  while(1)
-    {
-      sleep(0);
-      info->event_StartThread->wait();
-      info->event_StartThread->reset();
-      if(*info->flags & FV3_IR3P_THREAD_FLAG_RUN)
-        {
-          info->threadSection->lock();
-          if(info->lFragments->size() > 0)
-            {
-              for(long i = 0;i < (long)info->lFragments->size()-1;i ++)
-                {
-                  if((long)info->lFragments->size() > i+1)
-                    {
-                      info->lFragments->at(i+1)->MULT(info->lBlockDelayL->get(i), *info->lSwapL);
-                    }
-                }
-            }
-          *info->flags ^= FV3_IR3P_THREAD_FLAG_RUN;
-          info->event_ThreadEnded->trigger();
-          info->threadSection->unlock();
-        }
-      if(*info->flags & FV3_IR3P_THREAD_FLAG_EXIT)
-        {
-          *info->flags ^= FV3_IR3P_THREAD_FLAG_EXIT;
-          break;
-        }
-    }
-  pthread_exit(NULL);
-  return 0;
+  lFragmentsFDL = NULL;
+  lSwapL = NULL;
+  blockBegin = blockEnd = 0;
+  submitted = false;
+}
+
+void FV3_(lfThreadJob)::run()
+{
+  lFragmentsFDL->MULT(1, lFragmentsFDL->getFragmentCount(), 1, lSwapL, blockBegin, blockEnd);
 }
 
 // irmodel3pm
 
 FV3_(irmodel3pm)::FV3_(irmodel3pm)()
 {
-  validThread = false;
-  hostThreadData.lFragmentSize = &lFragmentSize;
-  hostThreadData.lFragments = &lFragments;
-  hostThreadData.lBlockDelayL = &lBlockDelayL;
-  hostThreadData.lSwapL = &lSwapSlot.L;
-  hostThreadData.flags = &threadFlags;
-  hostThreadData.threadSection = &threadSection;
-  hostThreadData.event_StartThread = &event_StartThread;
-  hostThreadData.event_ThreadEnded = &event_ThreadEnded;
+  validThread.store(false);
+  lastBoundary = blockPeriod = 0;
+  deadlineMissed.store(0);
+  // the jobs are never reallocated while the engine may be processing
+  jobs.resize(FV3_IR3P_MaxThreadCount);
+  setThreadCount(FV3_IR3P_DThreadCount);
   resume();
 }
 
 FV3_(irmodel3pm)::FV3_(~irmodel3pm)()
 {
   suspend();
+  retireJobs();
 }
 
 void FV3_(irmodel3pm)::resume()
 {
-  mainSection.lock();
-  if(validThread == false)
-    {
-      threadFlags = FV3_IR3P_THREAD_FLAG_0; // init exit flag
-      pthread_create(&lFragmentThreadHandle, NULL, irmodel3p_lfthread, &hostThreadData);
-      event_StartThread.reset();
-      event_ThreadEnded.reset();
-      event_ThreadEnded.set();
-      validThread = true;
-    }
-  mainSection.unlock();
+  validThread.store(true);
 }
 
 void FV3_(irmodel3pm)::suspend()
 {
-  mainSection.lock();
-  if(validThread == true)
+  // processZL() may still submit the jobs of the current boundary,
+  // the reconfiguration below waits for them again in mainSection.
+  validThread.store(false);
+  waitJobs();
+}
+
+void FV3_(irmodel3pm)::waitJobs()
+{
+  for(long i = 0;i < (long)jobs.size();i ++) PthreadScheduler::instance().wait(&jobs[i]);
+}
+
+void FV3_(irmodel3pm)::retireJobs()
+{
+  for(long i = 0;i < (long)jobs.size();i ++) PthreadScheduler::instance().retire(&jobs[i]);
+}
+
+long FV3_(irmodel3pm)::getDeadlineMissed()
+{
+  return deadlineMissed.load();
+}
+
+void FV3_(irmodel3pm)::setThreadCount(long count)
+{
+  if(count < 0)
     {
-      threadFlags |= FV3_IR3P_THREAD_FLAG_EXIT;
-      event_StartThread.trigger();
-      pthread_join(lFragmentThreadHandle, NULL);
-      validThread = false;
+      std::fprintf(stderr, "irmodel3pm::setThreadCount(): invalid thread count (%ld)\n", count);
+      return;
     }
-  mainSection.unlock();
+  if(count == 0) count = PthreadScheduler::instance().getThreadCount();
+  if(count > FV3_IR3P_MaxThreadCount) count = FV3_IR3P_MaxThreadCount;
+  threadCount.store(count);
+}
+
+long FV3_(irmodel3pm)::getThreadCount()
+{
+  return threadCount.load();
 }
 
 void FV3_(irmodel3pm)::loadImpulse(const fv3_float_t * inputL, long size)
@@ -112,18 +105,16 @@ void FV3_(irmodel3pm)::loadImpulse(const fv3_float_t * inputL, long size)
 {
   suspend();
   mainSection.lock();
-  threadSection.lock();
+  waitJobs();
   try
     {
       FV3_(irmodel3m)::loadImpulse(inputL, size);
     }
   catch(std::bad_alloc)
     {
-      threadSection.unlock();
       mainSection.unlock();
       throw;
     }
-  threadSection.unlock();
   mainSection.unlock();
   resume();
 }
@@ -132,9 +123,8 @@ void FV3_(irmodel3pm)::unloadImpulse()
 {
   suspend();
   mainSection.lock();
-  threadSection.lock();
+  waitJobs();
   FV3_(irmodel3m)::unloadImpulse();
-  threadSection.unlock();
   mainSection.unlock();
   resume();
 }
@@ -142,53 +132,84 @@ void FV3_(irmodel3pm)::unloadImpulse()
 void FV3_(irmodel3pm)::setFragmentSize(long size, long factor)
 {
   mainSection.lock();
-  threadSection.lock();
+  waitJobs();
   FV3_(irmodel3m)::setFragmentSize(size, factor);
-  threadSection.unlock();
   mainSection.unlock();
 }
 
 void FV3_(irmodel3pm)::mute()
 {
   mainSection.lock();
-  threadSection.lock();
+  waitJobs();
   FV3_(irmodel3m)::mute();
-  threadSection.unlock();
   mainSection.unlock();
 }
 
+FV3_(irbasem) * FV3_(irmodel3pm)::clone()
+{
+  FV3_(irmodel3pm) *ir = new FV3_(irmodel3pm);
+  cloneConfig(ir);
+  if(sFragmentSize > 0) ir->setFragmentSize(sFragmentSize, lFragmentSize/sFragmentSize);
+  ir->setThreadCount(threadCount.load());
+  return ir;
+}
+
 void FV3_(irmodel3pm)::processZL(fv3_float_t *inputL, long numsamples)
 {
-  // SOL2 calls suspend() multiple times while the thread mutex is still not clear.
-  mainSection.lock();
-  if(validThread != true)
+  // Never block the real-time thread. setThreadCount(), suspend() and resume() are lock free and
+  // picked up at the large block boundary. Only while the engine is reconfigured in mainSection
+  // (loadImpulse(), unloadImpulse(), setFragmentSize(), mute()) the block is muted, no job is submitted.
+  if(!mainSection.trylock())
     {
-      mainSection.unlock();
+      FV3_(utils)::mute(inputL, numsamples);
       return;
     }
-
-  if(Lcursor == 0&&lFragments.size() > 0)
+  if(Lcursor == 0&&lFragmentsFDL.getFragmentCount() > 0)
     {
       lFrameSlot.mute(lFragmentSize);
       lReverseSlot.mute(lFragmentSize-1, lFragmentSize+1);
-      event_ThreadEnded.wait();
-      event_ThreadEnded.reset();
-      threadSection.lock();
-      lBlockDelayL.push(lIFFTSlot.L);
-      lFragments[0]->MULT(lBlockDelayL.get(0), lSwapSlot.L);
+      // The results of the jobs of the last block are needed now, a miss is counted once per boundary.
+      // The unstarted jobs are taken over by this thread, only the running jobs are waited for.
+      for(long i = 0;i < (long)jobs.size();i ++)
+        {
+          if(jobs[i].submitted&&!jobs[i].finished()){ deadlineMissed.fetch_add(1); break; }
+        }
+      waitJobs();
+      lFragmentsFDL.push(lIFFTSlot.L);
+      lFragmentsFDL.MULT(0, lIFFTSlot.L, lSwapSlot.L);
       lFragmentsFFT.HC2R(lSwapSlot.L, lReverseSlot.L);
       lSwapSlot.mute(lFragmentSize*2);
-      threadSection.unlock();
-      threadFlags |= FV3_IR3P_THREAD_FLAG_RUN;
-      event_StartThread.trigger();
+      // All the jobs are idle here. Without the workers the large fragments are processed in this thread.
+      long jobCount = validThread.load() ? threadCount.load() : 0;
+      if(jobCount <= 0)
+        {
+          lastBoundary = 0;
+          lFragmentsFDL.MULT(1, lFragmentsFDL.getFragmentCount(), 1, lSwapSlot.L);
+        }
+      // The jobs must be finished before the next large block boundary.
+      uint64_t boundary = PthreadScheduler::now();
+      if(jobCount > 0&&lastBoundary > 0) blockPeriod = boundary - lastBoundary;
+      if(jobCount > 0) lastBoundary = boundary;
+      // split the bin blocks among the jobs
+      long blockCount = lFragmentsFDL.getBlockCount();
+      for(long i = 0;i < jobCount;i ++)
+        {
+          jobs[i].lFragmentsFDL = &lFragmentsFDL;
+          jobs[i].lSwapL = lSwapSlot.L;
+          jobs[i].blockBegin = blockCount*i/jobCount;
+          jobs[i].blockEnd = blockCount*(i+1)/jobCount;
+          jobs[i].deadline = boundary + blockPeriod;
+          jobs[i].submitted = jobs[i].blockBegin < jobs[i].blockEnd;
+          if(jobs[i].submitted) PthreadScheduler::instance().submit(&jobs[i]);
+        }
     }
   
   if(Scursor == 0)
     {
       sFramePointerL = lFrameSlot.L+Lcursor;
       sSwapSlot.mute(sFragmentSize*2);
-      sBlockDelayL.push(sIFFTSlot.L);
-      for(long i = 1;i < (long)sFragments.size();i ++){ sFragments[i]->MULT(sBlockDelayL.get(i-1), sSwapSlot.L); }
+      sFragmentsFDL.push(sIFFTSlot.L);
+      sFragmentsFDL.MULT(1, sFragmentsFDL.getFragmentCount(), 1, sSwapSlot.L);
     }
   
   sOnlySlot.mute(sFragmentSize);
@@ -196,15 +217,15 @@ void FV3_(irmodel3pm)::processZL(fv3_float_t *inputL, long numsamples)
   memcpy(lFrameSlot.L+Lcursor, inputL, sizeof(fv3_float_t)*numsamples);
   memcpy(sOnlySlot.L+Scursor, inputL, sizeof(fv3_float_t)*numsamples);
   
-  if(sFragments.size() > 0)
+  if(sFragmentsFDL.getFragmentCount() > 0)
     {
       sFragmentsFFT.R2HC(sOnlySlot.L, sIFFTSlot.L);
-      sFragments[0]->MULT(sIFFTSlot.L, sSwapSlot.L);
+      sFragmentsFDL.MULT(0, sIFFTSlot.L, sSwapSlot.L);
       sReverseSlot.mute(sFragmentSize*2);
       sFragmentsFFT.HC2R(sSwapSlot.L, sReverseSlot.L);
     }
   
-  if(lFragments.size() > 0)
+  if(lFragmentsFDL.getFragmentCount() > 0)
     {
       for(long i = 0;i < numsamples;i ++){ inputL[i] = (sReverseSlot.L+Scursor)[i] + (restSlot.L+Scursor)[i] + (lReverseSlot.L+Lcursor)[i]; }
     }
@@ -218,7 +239,7 @@ void FV3_(irmodel3pm)::processZL(fv3_float_t *inputL, long numsamples)
 
   // thread...
 
-  if(Scursor == sFragmentSize&&sFragments.size() > 0)
+  if(Scursor == sFragmentSize&&sFragmentsFDL.getFragmentCount() > 0)
     {
       sFragmentsFFT.R2HC(sFramePointerL, sIFFTSlot.L);
       memcpy(restSlot.L, sReverseSlot.L+sFragmentSize, sizeof(fv3_float_t)*(sFragmentSize-1));
@@ -227,7 +248,7 @@ void FV3_(irmodel3pm)::processZL(fv3_float_t *inputL, long numsamples)
   
   if(Lcursor == lFragmentSize)
     {
-      if(lFragments.size() > 0)
+      if(lFragmentsFDL.getFragmentCount() > 0)
         {
           lFragmentsFFT.R2HC(lFrameSlot.L, lIFFTSlot.L);
           memcpy(lReverseSlot.L, lReverseSlot.L+lFragmentSize, sizeof(fv3_float_t)*(lFragmentSize-1));
@@ -246,8 +267,8 @@ FV3_(irmodel3p)::FV3_(irmodel3p)()
   delete irmR, irmR = NULL;
   try
     {
-      ir3mL = new FV3_(irmodel3pm);
-      ir3mR = new FV3_(irmodel3pm);
+      ir3mL = ir3pmL = new FV3_(irmodel3pm);
+      ir3mR = ir3pmR = new FV3_(irmodel3pm);
       irmL = ir3mL;
       irmR = ir3mR;
     }
@@ -294,18 +315,15 @@ void FV3_(irmodel3p)::unloadImpulse()
   resume();
 }
 
+// The engines suspend and resume without mainSection, the processing is not muted.
 void FV3_(irmodel3p)::resume()
 {
-  mainSection.lock();
   FV3_(irbase)::resume();
-  mainSection.unlock();
 }
 
 void FV3_(irmodel3p)::suspend()
 {
-  mainSection.lock();
   FV3_(irbase)::suspend();
-  mainSection.unlock();
 }
 
 void FV3_(irmodel3p)::mute()
@@ -322,6 +340,49 @@ void FV3_(irmodel3p)::setFragmentSize(long size, long factor)
   mainSection.unlock();
 }
 
+void FV3_(irmodel3p)::processreplace(const fv3_float_t *inputL, const fv3_float_t *inputR, fv3_float_t *outputL, fv3_float_t *outputR, long numsamples)
+{
+  processstrided(inputL, inputR, 1, outputL, outputR, 1, numsamples);
+}
+
+void FV3_(irmodel3p)::processstrided(const fv3_float_t *inputL, const fv3_float_t *inputR, long inputStride,
+                                     fv3_float_t *outputL, fv3_float_t *outputR, long outputStride, long numsamples)
+{
+  // the model is reconfigured in mainSection, output silence instead of waiting
+  if(!mainSection.trylock())
+    {
+      for(long i = 0;i < numsamples;i ++){ outputL[i*outputStride] = outputR[i*outputStride] = 0; }
+      return;
+    }
+  if(inputStride == 1&&outputStride == 1)
+    FV3_(irmodel3)::processreplace(inputL, inputR, outputL, outputR, numsamples);
+  else
+    FV3_(irmodel3)::processstrided(inputL, inputR, inputStride, outputL, outputR, outputStride, numsamples);
+  mainSection.unlock();
+}
+
+void FV3_(irmodel3p)::attachEngines()
+{
+  FV3_(irmodel3)::attachEngines();
+  ir3pmL = static_cast<FV3_(irmodel3pm)*>(irmL);
+  ir3pmR = static_cast<FV3_(irmodel3pm)*>(irmR);
+}
+
+void FV3_(irmodel3p)::setThreadCount(long count)
+{
+  ir3pmL->setThreadCount(count), ir3pmR->setThreadCount(count);
+}
+
+long FV3_(irmodel3p)::getThreadCount()
+{
+  return ir3pmL->getThreadCount();
+}
+
+long FV3_(irmodel3p)::getDeadlineMissed()
+{
+  return ir3pmL->getDeadlineMissed() + ir3pmR->getDeadlineMissed();
+}
+
 void FV3_(irmodel3p)::setInitialDelay(long numsamples)
   
 {
@@ -43,9 +43,8 @@
 #include <pthread.h>
 #include "freeverb/fv3_pthread_tool.hpp"
 
-#define FV3_IR3P_THREAD_FLAG_0    (0U)
-#define FV3_IR3P_THREAD_FLAG_EXIT (1U << 1)
-#define FV3_IR3P_THREAD_FLAG_RUN  (1U << 2)
+#define FV3_IR3P_DThreadCount 1
+#define FV3_IR3P_MaxThreadCount 64
 
 namespace fv3
 {
@@ -18,15 +18,19 @@
  *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
  */
 
-typedef struct {
-  long * lFragmentSize;
-  std::vector<_FV3_(frag)*> *lFragments;
-  _FV3_(blockDelay) *lBlockDelayL;
-  _fv3_float_t **lSwapL;
-  volatile int *flags;
-  PthreadEvent *event_StartThread, *event_ThreadEnded;
-  PthreadLocker *threadSection;
-} _FV3_(lfThreadInfoW);
+// A part of the large fragment vector multiplication submitted to PthreadScheduler.
+// Each job processes the bin blocks [blockBegin, blockEnd) of all large fragments.
+class _FV3_(lfThreadJob) : public PthreadJob
+{
+ public:
+  _FV3_(lfThreadJob)();
+  virtual void run();
+  _FV3_(fragfdl) *lFragmentsFDL;
+  _fv3_float_t *lSwapL;
+  long blockBegin, blockEnd;
+  // submitted at the last large block boundary, the result is needed at the next one
+  bool submitted;
+};
 
 class _FV3_(irmodel3pm) : public _FV3_(irmodel3m)
 {
@@ -39,17 +43,29 @@ class _FV3_(irmodel3pm) : public _FV3_(irmodel3m)
   virtual void resume();
   virtual void suspend();
   virtual void mute();
+  virtual _FV3_(irbasem) * clone();
   virtual void setFragmentSize(long size, long factor);
+  // the number of the jobs the large fragments are split into, 0 = PthreadScheduler thread count.
+  // This may be called while processreplace() is running, the count is picked up at the next large block boundary.
+  // suspend() and resume() may be called while processing too, the large fragments are processed
+  // in the processreplace() thread while the engine is suspended. The blocks processed while
+  // the engine is reconfigured (loadImpulse(), setFragmentSize(), mute()...) are muted.
+  void setThreadCount(long count);
+  long getThreadCount();
+  // the number of the large block boundaries where the result of a submitted job was not ready
+  long getDeadlineMissed();
   
  protected:
   virtual void processZL(_fv3_float_t *inputL, long numsamples);
+  void waitJobs();
+  void retireJobs();
 
-  bool validThread;
-  _FV3_(lfThreadInfoW) hostThreadData;
-  volatile int threadFlags;
-  PthreadLocker threadSection, mainSection;
-  PthreadEvent event_StartThread, event_ThreadEnded;
-  pthread_t lFragmentThreadHandle;
+  std::atomic<bool> validThread;
+  std::atomic<long> threadCount;
+  std::atomic<long> deadlineMissed;
+  uint64_t lastBoundary, blockPeriod;
+  std::vector<_FV3_(lfThreadJob)> jobs;
+  PthreadLocker mainSection;
 
  private:
   _FV3_(irmodel3pm)(const _FV3_(irmodel3pm)& x);
@@ -70,8 +86,19 @@ class _FV3_(irmodel3p) : public _FV3_(irmodel3)
   virtual void setFragmentSize(long size, long factor);
   virtual void setInitialDelay(long numsamples)
     ;
+  void setThreadCount(long count);
+  long getThreadCount();
+  long getDeadlineMissed();
+  // muted while the model is reconfigured by another thread
+  using _FV3_(irmodel3)::processreplace;
+  virtual void processreplace(const _fv3_float_t *inputL, const _fv3_float_t *inputR, _fv3_float_t *outputL, _fv3_float_t *outputR, long numsamples);
+  using _FV3_(irmodel3)::processstrided;
+  virtual void processstrided(const _fv3_float_t *inputL, const _fv3_float_t *inputR, long inputStride,
+                              _fv3_float_t *outputL, _fv3_float_t *outputR, long outputStride, long numsamples);
   
  protected:
+  virtual void attachEngines();
+  _FV3_(irmodel3pm) *ir3pmL, *ir3pmR;
   PthreadLocker mainSection;
 
  private:
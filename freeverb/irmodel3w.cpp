@@ -43,16 +43,7 @@ static unsigned __stdcall lfThread(void *vdParam)
       if(*info->flags & FV3_THREAD_FLAG_RUN)
         {
           EnterCriticalSection(info->threadSection);
-          if(info->lFragments->size() > 0)
-            {
-              for(long i = 0;i < (long)info->lFragments->size()-1;i ++)
-                {
-                  if((long)info->lFragments->size() > i+1)
-                    {
-                      info->lFragments->at(i+1)->MULT(info->lBlockDelayL->get(i), *info->lSwapL);
-                    }
-                }
-            }
+          info->lFragmentsFDL->MULT(1, info->lFragmentsFDL->getFragmentCount(), 1, *info->lSwapL);
           *info->flags ^= FV3_THREAD_FLAG_RUN;
           SetEvent(event_ThreadEnded);
           LeaveCriticalSection(info->threadSection);
@@ -77,8 +68,7 @@ FV3_(irmodel3wm)::FV3_(irmodel3wm)()
   threadId = 0;
   threadPriority = THREAD_PRIORITY_NORMAL;
   hostThreadData.lFragmentSize = &lFragmentSize;
-  hostThreadData.lFragments = &lFragments;
-  hostThreadData.lBlockDelayL = &lBlockDelayL;
+  hostThreadData.lFragmentsFDL = &lFragmentsFDL;
   hostThreadData.lSwapL = &lSwapSlot.L;
   hostThreadData.flags = &threadFlags;
   hostThreadData.threadSection = &threadSection;
@@ -196,6 +186,15 @@ void FV3_(irmodel3wm)::mute()
   LeaveCriticalSection(&mainSection);
 }
 
+FV3_(irbasem) * FV3_(irmodel3wm)::clone()
+{
+  FV3_(irmodel3wm) *ir = new FV3_(irmodel3wm);
+  cloneConfig(ir);
+  if(sFragmentSize > 0) ir->setFragmentSize(sFragmentSize, lFragmentSize/sFragmentSize);
+  ir->setLFThreadPriority(threadPriority);
+  return ir;
+}
+
 void FV3_(irmodel3wm)::processZL(fv3_float_t *inputL, long numsamples)
 {
   // SOL2 calls suspend() many times though the thread mutex is not clear.
@@ -206,7 +205,7 @@ void FV3_(irmodel3wm)::processZL(fv3_float_t *inputL, long numsamples)
       return;
     }
 
-  if(Lcursor == 0&&lFragments.size() > 0)
+  if(Lcursor == 0&&lFragmentsFDL.getFragmentCount() > 0)
     {
       lFrameSlot.mute(lFragmentSize);
       lReverseSlot.mute(lFragmentSize-1, lFragmentSize+1);
@@ -215,8 +214,8 @@ void FV3_(irmodel3wm)::processZL(fv3_float_t *inputL, long numsamples)
       ResetEvent(event_waitfor);
 
       EnterCriticalSection(&threadSection);
-      lBlockDelayL.push(lIFFTSlot.L);
-      lFragments[0]->MULT(lBlockDelayL.get(0), lSwapSlot.L);
+      lFragmentsFDL.push(lIFFTSlot.L);
+      lFragmentsFDL.MULT(0, lIFFTSlot.L, lSwapSlot.L);
       lFragmentsFFT.HC2R(lSwapSlot.L, lReverseSlot.L);
       lSwapSlot.mute(lFragmentSize*2);
       LeaveCriticalSection(&threadSection);
@@ -230,8 +229,8 @@ void FV3_(irmodel3wm)::processZL(fv3_float_t *inputL, long numsamples)
     {
       sFramePointerL = lFrameSlot.L+Lcursor;
       sSwapSlot.mute(sFragmentSize*2);
-      sBlockDelayL.push(sIFFTSlot.L);
-      for(long i = 1;i < (long)sFragments.size();i ++){ sFragments[i]->MULT(sBlockDelayL.get(i-1), sSwapSlot.L); }
+      sFragmentsFDL.push(sIFFTSlot.L);
+      sFragmentsFDL.MULT(1, sFragmentsFDL.getFragmentCount(), 1, sSwapSlot.L);
     }
   
   sOnlySlot.mute(sFragmentSize);
@@ -239,15 +238,15 @@ void FV3_(irmodel3wm)::processZL(fv3_float_t *inputL, long numsamples)
   memcpy(lFrameSlot.L+Lcursor, inputL, sizeof(fv3_float_t)*numsamples);
   memcpy(sOnlySlot.L+Scursor, inputL, sizeof(fv3_float_t)*numsamples);
   
-  if(sFragments.size() > 0)
+  if(sFragmentsFDL.getFragmentCount() > 0)
     {
       sFragmentsFFT.R2HC(sOnlySlot.L, sIFFTSlot.L);
-      sFragments[0]->MULT(sIFFTSlot.L, sSwapSlot.L);
+      sFragmentsFDL.MULT(0, sIFFTSlot.L, sSwapSlot.L);
       sReverseSlot.mute(sFragmentSize*2);
       sFragmentsFFT.HC2R(sSwapSlot.L, sReverseSlot.L);
     }
   
-  if(lFragments.size() > 0)
+  if(lFragmentsFDL.getFragmentCount() > 0)
     {
       for(long i = 0;i < numsamples;i ++){ inputL[i] = (sReverseSlot.L+Scursor)[i] + (restSlot.L+Scursor)[i] + (lReverseSlot.L+Lcursor)[i]; }
     }
@@ -261,7 +260,7 @@ void FV3_(irmodel3wm)::processZL(fv3_float_t *inputL, long numsamples)
 
   // thread...
 
-  if(Scursor == sFragmentSize&&sFragments.size() > 0)
+  if(Scursor == sFragmentSize&&sFragmentsFDL.getFragmentCount() > 0)
     {
       sFragmentsFFT.R2HC(sFramePointerL, sIFFTSlot.L);
       memcpy(restSlot.L, sReverseSlot.L+sFragmentSize, sizeof(fv3_float_t)*(sFragmentSize-1));
@@ -270,7 +269,7 @@ void FV3_(irmodel3wm)::processZL(fv3_float_t *inputL, long numsamples)
   
   if(Lcursor == lFragmentSize)
     {
-      if(lFragments.size() > 0)
+      if(lFragmentsFDL.getFragmentCount() > 0)
         {
           lFragmentsFFT.R2HC(lFrameSlot.L, lIFFTSlot.L);
           memcpy(lReverseSlot.L, lReverseSlot.L+lFragmentSize, sizeof(fv3_float_t)*(lFragmentSize-1));
@@ -385,4 +384,11 @@ bool FV3_(irmodel3w)::setLFThreadPriority(int priority)
   return ret;
 }
 
+void FV3_(irmodel3w)::attachEngines()
+{
+  FV3_(irmodel3)::attachEngines();
+  ir3wmL = static_cast<FV3_(irmodel3wm)*>(irmL);
+  ir3wmR = static_cast<FV3_(irmodel3wm)*>(irmR);
+}
+
 #include "freeverb/fv3_ns_end.h"
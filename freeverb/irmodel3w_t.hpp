@@ -20,8 +20,7 @@
 
 typedef struct {
   long * lFragmentSize;
-  std::vector<_FV3_(frag)*> *lFragments;
-  _FV3_(blockDelay) *lBlockDelayL, *lBlockDelayR;
+  _FV3_(fragfdl) *lFragmentsFDL;
   _fv3_float_t **lSwapL, **lSwapR;
   volatile int *flags;
   CRITICAL_SECTION *threadSection;
@@ -39,6 +38,7 @@ class _FV3_(irmodel3wm) : public _FV3_(irmodel3m)
   virtual void resume();
   virtual void suspend();
   virtual void mute();
+  virtual _FV3_(irbasem) * clone();
   virtual void setFragmentSize(long size, long factor);
 
   bool setLFThreadPriority(int priority);
@@ -78,6 +78,7 @@ class _FV3_(irmodel3w) : public _FV3_(irmodel3)
   bool setLFThreadPriority(int priority);
 
  protected:
+  virtual void attachEngines();
   CRITICAL_SECTION mainSection;
   _FV3_(irmodel3wm) *ir3wmL, *ir3wmR;
 
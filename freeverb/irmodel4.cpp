@@ -0,0 +1,515 @@
+/**
+ *  Impulse Response Processor model implementation
+ *  Non-Uniform Partitioned Version
+ *
+ *  Copyright (C) 2006-2018 Teru Kamogashira
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "freeverb/irmodel4.hpp"
+#include "freeverb/fv3_type_float.h"
+#include "freeverb/fv3_ns_start.h"
+
+// fraglevel
+
+FV3_(fraglevel)::FV3_(fraglevel)()
+{
+  fragmentSize = step = 0;
+  setSIMD(0,0);
+}
+
+FV3_(fraglevel)::FV3_(~fraglevel)()
+{
+  unloadImpulse();
+}
+
+void FV3_(fraglevel)::setSIMD(uint32_t flag1, uint32_t flag2)
+{
+  simdFlag1 = flag1;
+  simdFlag2 = flag2;
+}
+
+void FV3_(fraglevel)::loadImpulse(const fv3_float_t * inputL, long fragSize, long num, long mod, unsigned fftflags)
+  
+{
+  unloadImpulse();
+  try
+    {
+      reverseSlot.alloc(2*fragSize, 1);
+      // Following slots must be SIMD compatible slots.
+      ifftSlot.alloc(2*fragSize, 1);
+      swapSlot.alloc(2*fragSize, 1);
+      fragmentsFFT.setSIMD(simdFlag1, simdFlag2);
+      fragmentsFFT.allocFFT(fragSize, fftflags);
+      fragmentsFDL.setSIMD(simdFlag1, simdFlag2);
+      fragmentsFDL.loadImpulse(inputL, fragSize, fragSize*num+mod, fftflags);
+      fragmentSize = fragSize;
+    }
+  catch(std::bad_alloc)
+    {
+      std::fprintf(stderr, "fraglevel::loadImpulse(%ld) bad_alloc\n", fragSize);
+      unloadImpulse();
+      throw;
+    }
+  mute();
+}
+
+void FV3_(fraglevel)::unloadImpulse()
+{
+  fragmentsFDL.unloadImpulse();
+  fragmentsFFT.freeFFT();
+  reverseSlot.free();
+  ifftSlot.free();
+  swapSlot.free();
+  fragmentSize = step = 0;
+}
+
+void FV3_(fraglevel)::mute()
+{
+  step = 0;
+  fragmentsFDL.mute();
+  reverseSlot.mute();
+  ifftSlot.mute();
+  swapSlot.mute();
+}
+
+long FV3_(fraglevel)::getFragmentSize(){ return fragmentSize; }
+long FV3_(fraglevel)::getFragmentCount(){ return fragmentsFDL.getFragmentCount(); }
+fv3_float_t * FV3_(fraglevel)::getReverse(){ return reverseSlot.L; }
+
+void FV3_(fraglevel)::startBlock()
+{
+  if(fragmentsFDL.getFragmentCount() == 0) return;
+  reverseSlot.mute(fragmentSize-1, fragmentSize+1);
+  fragmentsFDL.push(ifftSlot.L);
+  fragmentsFDL.MULT(0, ifftSlot.L, swapSlot.L);
+  fragmentsFFT.HC2R(swapSlot.L, reverseSlot.L);
+  swapSlot.mute();
+}
+
+void FV3_(fraglevel)::processStep(long cursor)
+{
+  // The vector multiplication of the level is divided into the small steps to reduce CPU load spike.
+  long target = (fragmentsFDL.getFragmentCount()-1)*cursor/fragmentSize;
+  if(target > step)
+    {
+      fragmentsFDL.MULT(step+1, target+1, 1, swapSlot.L);
+      step = target;
+    }
+}
+
+void FV3_(fraglevel)::endBlock(const fv3_float_t * frame)
+{
+  if(fragmentsFDL.getFragmentCount() == 0) return;
+  fragmentsFFT.R2HC(frame, ifftSlot.L);
+  std::memcpy(reverseSlot.L, reverseSlot.L+fragmentSize, sizeof(fv3_float_t)*(fragmentSize-1));
+  step = 0;
+}
+
+// irmodel4m
+
+FV3_(irmodel4m)::FV3_(irmodel4m)()
+{
+  sFragmentSize = lFragmentSize = factor = 0;
+  maxFragmentSize = FV3_IR4_DMaxFragmentSize;
+  setFragmentSize(FV3_IR4_DFragmentSize, FV3_IR4_DefaultFactor);
+  Scursor = Fcursor = 0;
+}
+
+FV3_(irmodel4m)::FV3_(~irmodel4m)()
+{
+  FV3_(irmodel4m)::unloadImpulse();
+}
+
+void FV3_(irmodel4m)::loadImpulse(const fv3_float_t * inputL, long size)
+  
+{
+  if(size <= 0) return;
+  FV3_(irmodel4m)::unloadImpulse();
+  
+  // partition schedule
+  // level 0 : [0, s*factor) zero latency, sFragmentSize x factor
+  // level k : [N, N*factor) latency N, N x (factor-1), N = s*factor^k
+  // the last level : [N, size) N <= maxFragmentSize
+  long sFragmentNum = 0, sFragmentMod = 0;
+  std::vector<long> levelSize, levelNum, levelMod;
+  long nextSize = sFragmentSize*factor;
+  if(size <= nextSize||nextSize > maxFragmentSize)
+    {
+      sFragmentNum = size / sFragmentSize;
+      sFragmentMod = size % sFragmentSize;
+    }
+  else
+    {
+      sFragmentNum = factor, sFragmentMod = 0;
+      for(long N = nextSize;;N *= factor)
+        {
+          levelSize.push_back(N);
+          if(size > N*factor&&N*factor <= maxFragmentSize)
+            {
+              levelNum.push_back(factor-1), levelMod.push_back(0);
+            }
+          else
+            {
+              levelNum.push_back((size-N)/N), levelMod.push_back((size-N)%N);
+              break;
+            }
+        }
+    }
+  
+  try
+    {
+      impulseSize = size;
+      lFragmentSize = levelSize.size() > 0 ? levelSize.back() : sFragmentSize;
+      sReverseSlot.alloc(2*sFragmentSize, 1);
+      restSlot.alloc(sFragmentSize, 1);
+      sOnlySlot.alloc(sFragmentSize, 1);
+      frameSlot.alloc(lFragmentSize, 1);
+      // Following slots must be SIMD compatible slots.
+      sIFFTSlot.alloc(2*sFragmentSize, 1);
+      sSwapSlot.alloc(2*sFragmentSize, 1);
+
+      sFragmentsFFT.setSIMD(simdFlag1, simdFlag2);
+      sFragmentsFFT.allocFFT(sFragmentSize, fftflags);
+      setSIMD(sFragmentsFFT.getSIMD(0),sFragmentsFFT.getSIMD(1));
+
+      sFragmentsFDL.setSIMD(simdFlag1, simdFlag2);
+      sFragmentsFDL.loadImpulse(inputL, sFragmentSize, sFragmentSize*sFragmentNum+sFragmentMod, fftflags);
+
+      for(long i = 0;i < (long)levelSize.size();i ++)
+        {
+          FV3_(fraglevel) * l = new FV3_(fraglevel);
+          levels.push_back(l);
+          l->setSIMD(simdFlag1, simdFlag2);
+          l->loadImpulse(inputL+levelSize[i], levelSize[i], levelNum[i], levelMod[i], fftflags);
+        }
+      latency = 0;
+    }
+  catch(std::bad_alloc)
+    {
+      std::fprintf(stderr, "irmodel4m::loadImpulse(%ld) bad_alloc\n", size);
+      FV3_(irmodel4m)::unloadImpulse();
+      throw;
+    }
+#ifdef DEBUG
+  std::fprintf(stderr, "irmodel4m::loadImpulse(): {S%ldx%ld+%ld}", sFragmentSize, sFragmentNum, sFragmentMod);
+  for(long i = 0;i < (long)levelSize.size();i ++) std::fprintf(stderr, "{L%ldx%ld+%ld}", levelSize[i], levelNum[i], levelMod[i]);
+  std::fprintf(stderr, "\n");
+#endif
+  FV3_(irmodel4m)::mute();
+}
+
+void FV3_(irmodel4m)::unloadImpulse()
+{
+  if(impulseSize == 0) return;
+  impulseSize = 0;
+  sFragmentsFDL.unloadImpulse();
+  freeLevels();
+  sFragmentsFFT.freeFFT();
+  sReverseSlot.free();
+  restSlot.free();
+  sOnlySlot.free();
+  frameSlot.free();
+  sIFFTSlot.free();
+  sSwapSlot.free();
+  lFragmentSize = sFragmentSize;
+}
+
+void FV3_(irmodel4m)::freeLevels()
+{
+  for(std::vector<FV3_(fraglevel)*>::iterator i = levels.begin();i != levels.end();i ++) delete *i;
+  levels.clear();
+}
+
+void FV3_(irmodel4m)::processreplace(fv3_float_t *inputL, long numsamples)
+{
+  if(numsamples <= 0||impulseSize <= 0) return;
+  long cursor = sFragmentSize - Scursor;
+  if(numsamples > cursor)
+    {
+      processZL(inputL, cursor);
+      long div = (numsamples - cursor)/sFragmentSize;
+      long mod = (numsamples - cursor)%sFragmentSize;
+      for(long i = 0;i < div;i ++)
+        processZL(inputL+cursor+i*sFragmentSize, sFragmentSize);
+      if(mod > 0) processZL(inputL+cursor+div*sFragmentSize, mod);
+    }
+  else
+    {
+      processZL(inputL, numsamples);
+    }
+}
+
+void FV3_(irmodel4m)::processZL(fv3_float_t *inputL, long numsamples)
+{
+  // numsamples <= sFragmentSize - Scursor
+  for(long l = 0;l < (long)levels.size();l ++)
+    {
+      if(Fcursor % levels[l]->getFragmentSize() == 0) levels[l]->startBlock();
+    }
+  
+  if(Scursor == 0)
+    {
+      sSwapSlot.mute();
+      sFragmentsFDL.push(sIFFTSlot.L);
+      sFragmentsFDL.MULT(1, sFragmentsFDL.getFragmentCount(), 1, sSwapSlot.L);
+    }
+  sOnlySlot.mute();
+  
+  std::memcpy(frameSlot.L+Fcursor, inputL, sizeof(fv3_float_t)*numsamples);
+  std::memcpy(sOnlySlot.L+Scursor, inputL, sizeof(fv3_float_t)*numsamples);
+  
+  sFragmentsFFT.R2HC(sOnlySlot.L, sIFFTSlot.L);
+  sFragmentsFDL.MULT(0, sIFFTSlot.L, sSwapSlot.L);
+  sReverseSlot.mute();
+  sFragmentsFFT.HC2R(sSwapSlot.L, sReverseSlot.L);
+  
+  for(long i = 0;i < numsamples;i ++){ inputL[i] = (sReverseSlot.L+Scursor)[i] + (restSlot.L+Scursor)[i]; }
+  for(long l = 0;l < (long)levels.size();l ++)
+    {
+      fv3_float_t * lReverse = levels[l]->getReverse() + Fcursor % levels[l]->getFragmentSize();
+      for(long i = 0;i < numsamples;i ++){ inputL[i] += lReverse[i]; }
+    }
+  
+  Scursor += numsamples, Fcursor += numsamples;
+  
+  // large fragment vector multipliers
+  for(long l = 0;l < (long)levels.size();l ++)
+    {
+      long N = levels[l]->getFragmentSize();
+      levels[l]->processStep((Fcursor-1) % N + 1);
+    }
+  
+  if(Scursor == sFragmentSize)
+    {
+      sFragmentsFFT.R2HC(frameSlot.L+Fcursor-sFragmentSize, sIFFTSlot.L);
+      std::memcpy(restSlot.L, sReverseSlot.L+sFragmentSize, sizeof(fv3_float_t)*(sFragmentSize-1));
+      Scursor = 0;
+    }
+  
+  for(long l = 0;l < (long)levels.size();l ++)
+    {
+      long N = levels[l]->getFragmentSize();
+      if(Fcursor % N == 0) levels[l]->endBlock(frameSlot.L+Fcursor-N);
+    }
+  
+  if(Fcursor == lFragmentSize) Fcursor = 0;
+}
+
+void FV3_(irmodel4m)::mute()
+{
+  if(impulseSize == 0) return;
+  Scursor = Fcursor = 0;
+  sFragmentsFDL.mute();
+  sReverseSlot.mute();
+  sIFFTSlot.mute();
+  sSwapSlot.mute();
+  restSlot.mute();
+  frameSlot.mute();
+  sOnlySlot.mute();
+  for(long l = 0;l < (long)levels.size();l ++) levels[l]->mute();
+}
+
+FV3_(irbasem) * FV3_(irmodel4m)::clone()
+{
+  FV3_(irmodel4m) *ir = new FV3_(irmodel4m);
+  cloneConfig(ir);
+  if(sFragmentSize > 0) ir->setFragmentSize(sFragmentSize, factor);
+  ir->setMaxFragmentSize(maxFragmentSize);
+  return ir;
+}
+
+void FV3_(irmodel4m)::setFragmentSize(long size, long _factor)
+{
+  if(size <= 0||_factor < 2||size < FV3_IR_Min_FragmentSize||size != FV3_(utils)::checkPow2(size)||_factor != FV3_(utils)::checkPow2(_factor))
+    {
+      std::fprintf(stderr, "irmodel4::setFragmentSize(): invalid fragment size/factor (%ld/%ld)\n", size, _factor);
+      return;
+    }
+  if(sFragmentSize != size||factor != _factor)
+    {
+      FV3_(irmodel4m)::unloadImpulse();
+      sFragmentSize = lFragmentSize = size;
+      factor = _factor;
+    }
+}
+
+void FV3_(irmodel4m)::setMaxFragmentSize(long size)
+{
+  if(size <= 0||size < FV3_IR_Min_FragmentSize||size != FV3_(utils)::checkPow2(size))
+    {
+      std::fprintf(stderr, "irmodel4::setMaxFragmentSize(): invalid fragment size (%ld)\n", size);
+      return;
+    }
+  if(maxFragmentSize != size)
+    {
+      FV3_(irmodel4m)::unloadImpulse();
+      maxFragmentSize = size;
+    }
+}
+
+long FV3_(irmodel4m)::getSFragmentSize(){ return sFragmentSize; }
+long FV3_(irmodel4m)::getLFragmentSize(){ return lFragmentSize; }
+long FV3_(irmodel4m)::getMaxFragmentSize(){ return maxFragmentSize; }
+long FV3_(irmodel4m)::getFactor(){ return factor; }
+long FV3_(irmodel4m)::getSFragmentCount(){ return sFragmentsFDL.getFragmentCount(); }
+long FV3_(irmodel4m)::getLevelCount(){ return (long)levels.size(); }
+long FV3_(irmodel4m)::getScursor(){ return Scursor; }
+
+long FV3_(irmodel4m)::getLevelFragmentSize(long level)
+{
+  if(level < 0||level >= (long)levels.size()) return 0;
+  return levels[level]->getFragmentSize();
+}
+
+long FV3_(irmodel4m)::getLevelFragmentCount(long level)
+{
+  if(level < 0||level >= (long)levels.size()) return 0;
+  return levels[level]->getFragmentCount();
+}
+
+// irmodel4
+
+FV3_(irmodel4)::FV3_(irmodel4)()
+{
+  fragmentSize = 0;
+  delete irmL, irmL = NULL;
+  delete irmR, irmR = NULL;
+  try
+    {
+      ir4mL = new FV3_(irmodel4m);
+      ir4mR = new FV3_(irmodel4m);
+      irmL = ir4mL;
+      irmR = ir4mR;
+    }
+  catch(std::bad_alloc)
+    {
+      delete irmL;
+      delete irmR;
+      throw;
+    }
+}
+
+FV3_(irmodel4)::FV3_(~irmodel4)()
+{
+  FV3_(irmodel4)::unloadImpulse();
+}
+
+void FV3_(irmodel4)::loadImpulse(const fv3_float_t * inputL, const fv3_float_t * inputR, long size)
+  
+{
+  if(size <= 0||getSFragmentSize() < FV3_IR_Min_FragmentSize) return;
+  FV3_(irmodel4)::unloadImpulse();
+  setSIMD(irmL->getSIMD(0),irmL->getSIMD(1));
+  try
+    {
+      irmL->loadImpulse(inputL, size), irmR->loadImpulse(inputR, size);
+      impulseSize = size;
+      latency = 0;
+      inputW.alloc(getSFragmentSize(), 2);
+      inputD.alloc(getSFragmentSize(), 2);
+      FV3_(irbase)::setInitialDelay(getInitialDelay());
+    }
+  catch(std::bad_alloc)
+    {
+      std::fprintf(stderr, "irmodel4::loadImpulse(%ld) bad_alloc\n", size);
+      FV3_(irmodel4)::unloadImpulse();
+      throw;
+    }
+  FV3_(irmodel1)::mute();
+}
+
+void FV3_(irmodel4)::setFragmentSize(long size, long factor)
+{
+  if(size <= 0||factor < 2||size < FV3_IR_Min_FragmentSize||size != FV3_(utils)::checkPow2(size)||factor != FV3_(utils)::checkPow2(factor))
+    {
+      std::fprintf(stderr, "irmodel4::setFragmentSize(): invalid fragment size/factor (%ld/%ld)\n", size, factor);
+      return;
+    }
+  if(getSFragmentSize() != size||ir4mL->getFactor() != factor)
+    {
+      FV3_(irmodel4)::unloadImpulse();
+      ir4mL->setFragmentSize(size, factor);
+      ir4mR->setFragmentSize(size, factor);
+    }
+}
+
+void FV3_(irmodel4)::setMaxFragmentSize(long size)
+{
+  if(size <= 0||size < FV3_IR_Min_FragmentSize||size != FV3_(utils)::checkPow2(size))
+    {
+      std::fprintf(stderr, "irmodel4::setMaxFragmentSize(): invalid fragment size (%ld)\n", size);
+      return;
+    }
+  if(getMaxFragmentSize() != size)
+    {
+      FV3_(irmodel4)::unloadImpulse();
+      ir4mL->setMaxFragmentSize(size);
+      ir4mR->setMaxFragmentSize(size);
+    }
+}
+
+void FV3_(irmodel4)::processreplace(const fv3_float_t *inputL, const fv3_float_t *inputR, fv3_float_t *outputL, fv3_float_t *outputR, long numsamples)
+{
+  FV3_(denormalguard) guard;
+  if(numsamples <= 0||impulseSize <= 0) return;
+  long sFragmentSize = getSFragmentSize();
+  long cursor = sFragmentSize - ir4mL->getScursor();  
+  if(numsamples > cursor)
+    {
+      processreplaceS(inputL, inputR, outputL, outputR, cursor);
+      long div = (numsamples - cursor)/sFragmentSize;
+      long mod = (numsamples - cursor)%sFragmentSize;
+      for(long i = 0;i < div;i ++)
+        processreplaceS(inputL+cursor+i*sFragmentSize, inputR+cursor+i*sFragmentSize, outputL+cursor+i*sFragmentSize, outputR+cursor+i*sFragmentSize, sFragmentSize);
+      processreplaceS(inputL+cursor+div*sFragmentSize, inputR+cursor+div*sFragmentSize, outputL+cursor+div*sFragmentSize, outputR+cursor+div*sFragmentSize, mod);
+    }
+  else
+    {
+      processreplaceS(inputL, inputR, outputL, outputR, numsamples);
+    }
+}
+
+long FV3_(irmodel4)::getNextBlockSize()
+{
+  return getSFragmentSize() - ir4mL->getScursor();
+}
+
+void FV3_(irmodel4)::attachEngines()
+{
+  ir4mL = static_cast<FV3_(irmodel4m)*>(irmL);
+  ir4mR = static_cast<FV3_(irmodel4m)*>(irmR);
+}
+
+long FV3_(irmodel4)::getSFragmentSize(){ return ir4mL->getSFragmentSize(); }
+long FV3_(irmodel4)::getLFragmentSize(){ return ir4mL->getLFragmentSize(); }
+long FV3_(irmodel4)::getMaxFragmentSize(){ return ir4mL->getMaxFragmentSize(); }
+long FV3_(irmodel4)::getSFragmentCount(){ return ir4mL->getSFragmentCount(); }
+long FV3_(irmodel4)::getLevelCount(){ return ir4mL->getLevelCount(); }
+long FV3_(irmodel4)::getLevelFragmentSize(long level){ return ir4mL->getLevelFragmentSize(level); }
+long FV3_(irmodel4)::getLevelFragmentCount(long level){ return ir4mL->getLevelFragmentCount(level); }
+
+void FV3_(irmodel4)::printconfig()
+{
+  std::fprintf(stderr, "*** irmodel4 config ***\n");
+  std::fprintf(stderr, "impulseSize = %ld\n", impulseSize);
+  std::fprintf(stderr, "short fragment Size = %ld\n", getSFragmentSize());
+  std::fprintf(stderr, "short fragment vector Length = %ld\n", getSFragmentCount());
+  for(long l = 0;l < getLevelCount();l ++)
+    std::fprintf(stderr, "level %ld fragment Size/vector Length = %ld/%ld\n", l+1, getLevelFragmentSize(l), getLevelFragmentCount(l));
+}
+
+#include "freeverb/fv3_ns_end.h"
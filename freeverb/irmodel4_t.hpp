@@ -0,0 +1,125 @@
+/**
+ *  Impulse Response Processor model implementation
+ *  Non-Uniform Partitioned Version
+ *
+ *  Copyright (C) 2006-2018 Teru Kamogashira
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+// One level of the non-uniform partition schedule.
+// The level processes the impulse fragments [fragmentSize*k, fragmentSize*(k+1))
+// of the impulse which starts at the offset fragmentSize with the latency fragmentSize.
+class _FV3_(fraglevel)
+{
+ public:
+  _FV3_(fraglevel)();
+  virtual _FV3_(~fraglevel)();
+  void setSIMD(uint32_t flag1, uint32_t flag2);
+  void loadImpulse(const _fv3_float_t * inputL, long fragSize, long num, long mod, unsigned fftflags)
+    ;
+  void unloadImpulse();
+  void mute();
+  long getFragmentSize();
+  long getFragmentCount();
+  // cursor == 0
+  void startBlock();
+  // spread the vector multiplication over the block, 0 < cursor <= fragmentSize
+  void processStep(long cursor);
+  // cursor == fragmentSize, frame = the last fragmentSize input samples
+  void endBlock(const _fv3_float_t * frame);
+  _fv3_float_t * getReverse();
+
+ private:
+  _FV3_(fraglevel)(const _FV3_(fraglevel)& x);
+  _FV3_(fraglevel)& operator=(const _FV3_(fraglevel)& x);
+  long fragmentSize, step;
+  uint32_t simdFlag1, simdFlag2;
+  _FV3_(fragfdl) fragmentsFDL;
+  _FV3_(fragfft) fragmentsFFT;
+  _FV3_(slot) reverseSlot, ifftSlot, swapSlot;
+};
+
+class _FV3_(irmodel4m) : public _FV3_(irbasem)
+{
+ public:
+  _FV3_(irmodel4m)();
+  virtual _FV3_(~irmodel4m)();
+  virtual void loadImpulse(const _fv3_float_t * inputL, long size)
+    ;
+  virtual void unloadImpulse();
+  virtual void processreplace(_fv3_float_t *inputL, long numsamples);
+  virtual void mute();
+  virtual _FV3_(irbasem) * clone();
+
+  void setFragmentSize(long size, long factor);
+  void setMaxFragmentSize(long size);
+  long getSFragmentSize();
+  long getLFragmentSize();
+  long getMaxFragmentSize();
+  long getFactor();
+  long getSFragmentCount();
+  long getLevelCount();
+  long getLevelFragmentSize(long level);
+  long getLevelFragmentCount(long level);
+  long getScursor();
+  
+ protected:
+  virtual void processZL(_fv3_float_t *inputL, long numsamples);
+  
+  void freeLevels();
+
+  long Fcursor, Scursor, sFragmentSize, lFragmentSize, maxFragmentSize, factor;
+  _FV3_(slot) sReverseSlot, sIFFTSlot, sSwapSlot, restSlot, frameSlot, sOnlySlot;
+  _FV3_(fragfdl) sFragmentsFDL;
+  std::vector<_FV3_(fraglevel)*> levels;
+  _FV3_(fragfft) sFragmentsFFT;
+
+ private:
+  _FV3_(irmodel4m)(const _FV3_(irmodel4m)& x);
+  _FV3_(irmodel4m)& operator=(const _FV3_(irmodel4m)& x);
+};
+
+class _FV3_(irmodel4) : public _FV3_(irmodel1)
+{
+ public:
+  _FV3_(irmodel4)();
+  virtual _FV3_(~irmodel4)();
+  virtual void loadImpulse(const _fv3_float_t * inputL, const _fv3_float_t * inputR, long size)
+    ;
+  using _FV3_(irbase)::processreplace;
+  virtual void processreplace(const _fv3_float_t *inputL, const _fv3_float_t *inputR, _fv3_float_t *outputL, _fv3_float_t *outputR, long numsamples);
+  
+  virtual void setFragmentSize(long size, long factor);
+  virtual void setMaxFragmentSize(long size);
+  
+  long getSFragmentSize();
+  long getLFragmentSize();
+  long getMaxFragmentSize();
+  long getSFragmentCount();
+  long getLevelCount();
+  long getLevelFragmentSize(long level);
+  long getLevelFragmentCount(long level);
+  void printconfig();
+  
+ protected:
+  virtual void attachEngines();
+  virtual long getNextBlockSize();
+  _FV3_(irmodel4m) *ir4mL, *ir4mR;
+
+ private:
+  _FV3_(irmodel4)(const _FV3_(irmodel4)& x);
+  _FV3_(irmodel4)& operator=(const _FV3_(irmodel4)& x);
+};
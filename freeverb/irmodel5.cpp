@@ -0,0 +1,256 @@
+/**
+ *  Impulse Response Processor model implementation
+ *  Direct Head Zero Latency Version
+ *
+ *  Copyright (C) 2006-2018 Teru Kamogashira
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "freeverb/irmodel5.hpp"
+#include "freeverb/fv3_type_float.h"
+#include "freeverb/fv3_ns_start.h"
+
+// irmodel5m
+
+FV3_(irmodel5m)::FV3_(irmodel5m)()
+{
+  setFragmentSize(FV3_IR5_DFragmentSize);
+  autoFragmentSize = true;
+  headSize = tailSize = 0;
+}
+
+FV3_(irmodel5m)::FV3_(~irmodel5m)()
+{
+  ;
+}
+
+void FV3_(irmodel5m)::loadImpulse(const fv3_float_t * inputL, long size)
+  
+{
+  if(size <= 0) return;
+  unloadImpulse();
+  if(autoFragmentSize) setFragmentSize(getOptimalFragmentSize(size));
+  long head = size < fragmentSize ? size : fragmentSize;
+  try
+    {
+      // The tail starts at fragmentSize, which is the latency of irmodel2m.
+      if(size > head) FV3_(irmodel2m)::loadImpulse(inputL+head, size-head);
+      headSize = head, tailSize = size-head;
+      headSlot.alloc(headSize, 1);
+      historySlot.alloc(headSize-1+fragmentSize, 1);
+      headOutSlot.alloc(fragmentSize, 1);
+      for(long i = 0;i < headSize;i ++) headSlot.L[i] = inputL[headSize-1-i];
+      impulseSize = size;
+      latency = 0;
+      mute();
+#ifdef DEBUG
+      std::fprintf(stderr, "irmodel5m::loadImpulse(): head %ld + tail {%ldx%ld}\n", headSize, fragmentSize, (tailSize+fragmentSize-1)/fragmentSize);
+#endif
+    }
+  catch(std::bad_alloc)
+    {
+      std::fprintf(stderr, "irmodel5m::loadImpulse(%ld) bad_alloc\n", size);
+      unloadImpulse();
+      throw;
+    }
+}
+
+void FV3_(irmodel5m)::unloadImpulse()
+{
+  headSlot.free();
+  historySlot.free();
+  headOutSlot.free();
+  headSize = 0;
+  if(impulseSize == 0) return;
+  if(tailSize > 0) FV3_(irmodel2m)::unloadImpulse();
+  impulseSize = tailSize = 0;
+}
+
+void FV3_(irmodel5m)::processreplace(fv3_float_t *inputL, long numsamples)
+{
+  if(numsamples <= 0||impulseSize <= 0) return;
+  if(numsamples > fragmentSize) // divide into fragmentSize pieces
+    {
+      long div = numsamples/fragmentSize;
+      for(long i = 0;i < div;i ++){ processreplace(inputL+i*fragmentSize, fragmentSize); }
+      processreplace(inputL+div*fragmentSize, numsamples%fragmentSize);
+      return;
+    }
+  
+  processHead(inputL, headOutSlot.L, numsamples);
+  if(tailSize > 0)
+    {
+      FV3_(irmodel2m)::processreplace(inputL, numsamples);
+      for(long i = 0;i < numsamples;i ++){ inputL[i] += headOutSlot.L[i]; }
+    }
+  else
+    {
+      std::memcpy(inputL, headOutSlot.L, sizeof(fv3_float_t)*numsamples);
+    }
+}
+
+void FV3_(irmodel5m)::processHead(const fv3_float_t *inputL, fv3_float_t *outputL, long numsamples)
+{
+  // numsamples <= fragmentSize
+  // outputL[i] = sum headSlot.L[k]*x[i+k], x = historySlot.L, the impulse is reversed.
+  fv3_float_t * x = historySlot.L;
+  const fv3_float_t * h = headSlot.L;
+  std::memcpy(x+headSize-1, inputL, sizeof(fv3_float_t)*numsamples);
+  long i = 0;
+  // FV3_IR5_HeadBlock outputs share each tap, the inner loop is vectorized.
+  for(;i+FV3_IR5_HeadBlock <= numsamples;i += FV3_IR5_HeadBlock)
+    {
+      fv3_float_t acc[FV3_IR5_HeadBlock];
+      for(long b = 0;b < FV3_IR5_HeadBlock;b ++) acc[b] = 0;
+      const fv3_float_t * xi = x+i;
+      for(long k = 0;k < headSize;k ++)
+        {
+          fv3_float_t c = h[k];
+          for(long b = 0;b < FV3_IR5_HeadBlock;b ++) acc[b] += c*xi[k+b];
+        }
+      for(long b = 0;b < FV3_IR5_HeadBlock;b ++) outputL[i+b] = acc[b];
+    }
+  for(;i < numsamples;i ++)
+    {
+      fv3_float_t acc = 0;
+      for(long k = 0;k < headSize;k ++) acc += h[k]*x[i+k];
+      outputL[i] = acc;
+    }
+  std::memmove(x, x+numsamples, sizeof(fv3_float_t)*(headSize-1));
+}
+
+void FV3_(irmodel5m)::mute()
+{
+  if(tailSize > 0) FV3_(irmodel2m)::mute();
+  historySlot.mute();
+  headOutSlot.mute();
+}
+
+FV3_(irbasem) * FV3_(irmodel5m)::clone()
+{
+  FV3_(irmodel5m) *ir = new FV3_(irmodel5m);
+  cloneConfig(ir);
+  ir->setFragmentSize(fragmentSize);
+  ir->setAutoFragmentSize(autoFragmentSize);
+  return ir;
+}
+
+void FV3_(irmodel5m)::setAutoFragmentSize(bool value)
+{
+  autoFragmentSize = value;
+}
+
+bool FV3_(irmodel5m)::getAutoFragmentSize()
+{
+  return autoFragmentSize;
+}
+
+long FV3_(irmodel5m)::getHeadSize()
+{
+  return headSize;
+}
+
+double FV3_(irmodel5m)::getCost(long size, long fragment)
+{
+  // head only
+  if(size <= fragment) return (double)size;
+  // head + forward and inverse FFT of 2*fragment per fragment + the partitions
+  long count = (size-fragment+fragment-1)/fragment;
+  return (double)fragment
+    + 4.0*FV3_IR5_FFTCost*std::log((double)(2*fragment))/std::log(2.0)
+    + FV3_IR5_MACCost*count*(fragment+1)/fragment;
+}
+
+long FV3_(irmodel5m)::getOptimalFragmentSize(long size)
+{
+  long best = FV3_IR_Min_FragmentSize;
+  double bestCost = getCost(size, best);
+  for(long f = best*2;f <= FV3_IR5_MaxFragmentSize&&f/2 < size;f *= 2)
+    {
+      double cost = getCost(size, f);
+      if(cost < bestCost) best = f, bestCost = cost;
+    }
+  return best;
+}
+
+// irmodel5
+
+FV3_(irmodel5)::FV3_(irmodel5)()
+{
+  delete irmL, irmL = NULL;
+  delete irmR, irmR = NULL;
+  try
+    {
+      ir2mL = new FV3_(irmodel5m);
+      ir2mR = new FV3_(irmodel5m);
+      irmL = ir2mL;
+      irmR = ir2mR;
+    }
+  catch(std::bad_alloc)
+    {
+      delete irmL;
+      delete irmR;
+      throw;
+    }
+  FV3_(irmodel2)::setFragmentSize(FV3_IR5_DFragmentSize);
+  autoFragmentSize = true;
+}
+
+FV3_(irmodel5)::FV3_(~irmodel5)()
+{
+  ;
+}
+
+void FV3_(irmodel5)::setFragmentSize(long size)
+{
+  FV3_(irmodel2)::setFragmentSize(size);
+  if(fragmentSize == size) setAutoFragmentSize(false);
+}
+
+void FV3_(irmodel5)::setAutoFragmentSize(bool value)
+{
+  autoFragmentSize = value;
+  static_cast<FV3_(irmodel5m)*>(irmL)->setAutoFragmentSize(value);
+  static_cast<FV3_(irmodel5m)*>(irmR)->setAutoFragmentSize(value);
+}
+
+bool FV3_(irmodel5)::getAutoFragmentSize()
+{
+  return autoFragmentSize;
+}
+
+void FV3_(irmodel5)::loadImpulse(const fv3_float_t * inputL, const fv3_float_t * inputR, long size)
+  
+{
+  if(size <= 0) return;
+  if(autoFragmentSize) FV3_(irmodel2)::setFragmentSize(FV3_(irmodel5m)::getOptimalFragmentSize(size));
+  unloadImpulse();
+  try
+    {
+      FV3_(irmodel2)::loadImpulse(inputL, inputR, size);
+      latency = 0;
+      setInitialDelay(getInitialDelay());
+      mute();
+    }
+  catch(std::bad_alloc)
+    {
+      std::fprintf(stderr, "irmodel5::loadImpulse(%ld) bad_alloc\n", size);
+      unloadImpulse();
+      throw;
+    }
+}
+
+#include "freeverb/fv3_ns_end.h"
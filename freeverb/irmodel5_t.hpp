@@ -0,0 +1,76 @@
+/**
+ *  Impulse Response Processor model implementation
+ *
+ *  Copyright (C) 2006-2018 Teru Kamogashira
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+
+// The first fragmentSize taps of the impulse are convolved in the time domain,
+// the rest by the uniformly partitioned FFT of irmodel2m whose latency fragmentSize
+// is hidden by the head. The fragment size is chosen by getOptimalFragmentSize().
+class _FV3_(irmodel5m) : public _FV3_(irmodel2m)
+{
+ public:
+  _FV3_(irmodel5m)();
+  virtual _FV3_(~irmodel5m)();
+  virtual void loadImpulse(const _fv3_float_t * inputL, long size)
+    ;
+  virtual void unloadImpulse();
+  virtual void processreplace(_fv3_float_t *inputL, long numsamples);
+  virtual void mute();
+  virtual _FV3_(irbasem) * clone();
+
+  // select the fragment size by the cost model at every loadImpulse() (default on)
+  void setAutoFragmentSize(bool value);
+  bool getAutoFragmentSize();
+  long getHeadSize();
+  // The fragment size of the least estimated cost per sample for the impulse size.
+  static long getOptimalFragmentSize(long size);
+  // estimated cost per sample, in units of one multiply-add of the time domain head
+  static double getCost(long size, long fragment);
+
+ protected:
+  void processHead(const _fv3_float_t *inputL, _fv3_float_t *outputL, long numsamples);
+  bool autoFragmentSize;
+  long headSize, tailSize;
+  // headSlot = the reversed head taps, historySlot = headSize-1 past inputs + fragmentSize inputs
+  _FV3_(slot) headSlot, historySlot, headOutSlot;
+
+ private:
+  _FV3_(irmodel5m)(const _FV3_(irmodel5m)& x);
+  _FV3_(irmodel5m)& operator=(const _FV3_(irmodel5m)& x);
+};
+
+class _FV3_(irmodel5) : public _FV3_(irmodel2)
+{
+ public:
+  _FV3_(irmodel5)();
+  virtual _FV3_(~irmodel5)();
+  virtual void loadImpulse(const _fv3_float_t * inputL, const _fv3_float_t * inputR, long size)
+    ;
+  // disables the automatic fragment size
+  virtual void setFragmentSize(long size);
+  void setAutoFragmentSize(bool value);
+  bool getAutoFragmentSize();
+
+ protected:
+  bool autoFragmentSize;
+
+ private:
+  _FV3_(irmodel5)(const _FV3_(irmodel5)& x);
+  _FV3_(irmodel5)& operator=(const _FV3_(irmodel5)& x);
+};
@@ -49,6 +49,7 @@ void FV3_(irmodels)::loadImpulse(const fv3_float_t * inputL, const fv3_float_t *
 
 void FV3_(irmodels)::processreplace(const fv3_float_t *inputL, const fv3_float_t *inputR, fv3_float_t *outputL, fv3_float_t *outputR, long numsamples)
 {
+  FV3_(denormalguard) guard;
   if(numsamples <= 0||impulseSize <= 0) return;
   for(long i = 0;i < numsamples;i ++)
     {
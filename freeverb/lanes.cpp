@@ -0,0 +1,84 @@
+/**
+ *  Fork/Join Lanes for the Channel Processing
+ *
+ *  Copyright (C) 2006-2018 Teru Kamogashira
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "freeverb/lanes.hpp"
+#include "freeverb/fv3_type_float.h"
+#include "freeverb/fv3_ns_start.h"
+
+FV3_(lanes)::FV3_(lanes)()
+{
+  threshold = FV3_LANES_DThreshold;
+#ifdef ENABLE_PTHREAD
+  submitted = false;
+  multiprocessor = sysconf(_SC_NPROCESSORS_ONLN) > 1;
+#endif
+}
+
+FV3_(lanes)::FV3_(~lanes)()
+{
+#ifdef ENABLE_PTHREAD
+  // the entries of the lanes which were run by the caller may still be queued
+  if(submitted) for(long k = 1;k < FV3_LANES_Max;k ++) PthreadScheduler::instance().retire(&jobs[k]);
+#endif
+}
+
+void FV3_(lanes)::setThreshold(long size)
+{
+  threshold = size;
+}
+
+long FV3_(lanes)::getThreshold()
+{
+  return threshold;
+}
+
+void FV3_(lanes)::run(function_t function, void * arg, long count, long numsamples)
+{
+  if(count <= 0) return;
+  bool parallel = count > 1&&threshold >= 0&&numsamples >= threshold;
+#if defined(ENABLE_PTHREAD)
+  if(parallel&&multiprocessor)
+    {
+      long n = count < FV3_LANES_Max ? count : FV3_LANES_Max;
+      for(long k = 1;k < n;k ++)
+        {
+          jobs[k].function = function, jobs[k].arg = arg, jobs[k].lane = k;
+          // before any background job
+          jobs[k].deadline = 0;
+          PthreadScheduler::instance().submit(&jobs[k]);
+        }
+      submitted = true;
+      function(arg, 0);
+      for(long k = n;k < count;k ++) function(arg, k);
+      for(long k = 1;k < n;k ++) PthreadScheduler::instance().wait(&jobs[k]);
+      return;
+    }
+#elif defined(USEOMP)
+  if(parallel)
+    {
+#pragma omp parallel for
+      for(long k = 0;k < count;k ++) function(arg, k);
+      return;
+    }
+#endif
+  for(long k = 0;k < count;k ++) function(arg, k);
+}
+
+#include "freeverb/fv3_ns_end.h"
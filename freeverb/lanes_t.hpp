@@ -0,0 +1,56 @@
+/**
+ *  Fork/Join Lanes for the Channel Processing
+ *
+ *  Copyright (C) 2006-2018 Teru Kamogashira
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+// Runs the independent work of the channels of one block in parallel and waits for all of them.
+// Lane 0 runs in the caller thread, the others on the persistent PthreadScheduler workers
+// (ENABLE_PTHREAD), which spin before they sleep and can be bound to cores by
+// PthreadScheduler::setAffinity(). A lane which no worker has taken yet is run by the caller.
+// Without ENABLE_PTHREAD the lanes are run by OpenMP (USEOMP) or one by one.
+class _FV3_(lanes)
+{
+ public:
+  typedef void (*function_t)(void * arg, long lane);
+  _FV3_(lanes)();
+  _FV3_(~lanes)();
+  // blocks of numsamples >= size are run in parallel, 0 = always, < 0 = never
+  void setThreshold(long size);
+  long getThreshold();
+  // function(arg, lane) for 0 <= lane < count, numsamples is the size of the work
+  void run(function_t function, void * arg, long count, long numsamples);
+  
+ private:
+  _FV3_(lanes)(const _FV3_(lanes)& x);
+  _FV3_(lanes)& operator=(const _FV3_(lanes)& x);
+  long threshold;
+#ifdef ENABLE_PTHREAD
+  // a single processor only spins
+  bool multiprocessor;
+  class job : public PthreadJob
+  {
+  public:
+    virtual void run(){ function(arg, lane); }
+    function_t function;
+    void * arg;
+    long lane;
+  };
+  job jobs[FV3_LANES_Max];
+  bool submitted;
+#endif
+};
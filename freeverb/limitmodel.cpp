@@ -164,6 +164,7 @@ fv3_float_t FV3_(limitmodel)::getDGain(){ return currentGain2; }
 */
 void FV3_(limitmodel)::processreplace(fv3_float_t *inputL, fv3_float_t *inputR, fv3_float_t *outputL, fv3_float_t *outputR, long numsamples)
 {
+  FV3_(denormalguard) guard;
   float gainL = 1, gainR = 1;
   for(long i = 0;i < numsamples;i ++)
     {
@@ -30,6 +30,7 @@ const long FV3_(nrev)::allpassCo[] = {347, 113, 37, 59, 53, 43, 37, 29, 19,};
 FV3_(nrev)::FV3_(nrev)()
 	   
 {
+  combLR.setlanes(2*FV3_NREV_NUM_COMB);
   hpf = lpfL = lpfR = 0;
   setRearDelay(0);
   setrt60(1);
@@ -67,10 +68,7 @@ void FV3_(nrev)::printconfig()
 void FV3_(nrev)::mute()
 {
   FV3_(revbase)::mute();
-  for (long i = 0;i < FV3_NREV_NUM_COMB;i ++)
-    {
-      combL[i].mute(); combR[i].mute();
-    }
+  combLR.mute();
   for (long i = 0;i < FV3_NREV_NUM_ALLPASS;i ++)
     {
       allpassL[i].mute(); allpassR[i].mute();
@@ -116,6 +114,7 @@ void FV3_(nrev)::processreplace(fv3_float_t *inputL, fv3_float_t *inputR, fv3_fl
 				fv3_float_t *outputRearL, fv3_float_t *outputRearR, long numsamples)
 		
 {
+  FV3_(denormalguard) guard;
   if(numsamples <= 0) return;
   long count = numsamples*SRC.getSRCFactor();
   try{ growWave(count); }catch(std::bad_alloc){ throw; }
@@ -135,7 +134,7 @@ void FV3_(nrev)::processreplace(fv3_float_t *inputL, fv3_float_t *inputR, fv3_fl
 
 void FV3_(nrev)::processloop2(long count, fv3_float_t *inputL, fv3_float_t *inputR, fv3_float_t *outputL, fv3_float_t *outputR)
 {
-  fv3_float_t outL, outR;
+  fv3_float_t outL, outR, combOut[2*FV3_NREV_NUM_COMB];
   while(count-- > 0)
     {
       outL = outR = 0;
@@ -143,14 +142,15 @@ void FV3_(nrev)::processloop2(long count, fv3_float_t *inputL, fv3_float_t *inpu
       UNDENORMAL(hpf);
 
       hpf *= FV3_NREV_SCALE_WET;
+      combLR._process(hpf, combOut);
       
-      for(long i = 0;i < FV3_NREV_NUM_COMB;i ++) outL += combL[i]._process(hpf);
+      for(long i = 0;i < FV3_NREV_NUM_COMB;i ++) outL += combOut[i];
       for(long i = 0;i < 3;i ++) outL = allpassL[i]._process_ov(outL);
       lpfL = damp2*lpfL + damp2_1*outL; UNDENORMAL(lpfL);
       outL = allpassL[3]._process_ov(lpfL); outL = allpassL[5]._process_ov(outL);
       outL = delayWL(lLDCC(outL));
       
-      for(long i = 0;i < FV3_NREV_NUM_COMB;i ++) outR += combR[i]._process(hpf);
+      for(long i = 0;i < FV3_NREV_NUM_COMB;i ++) outR += combOut[FV3_NREV_NUM_COMB+i];
       for(long i = 0;i < 3;i ++) outR = allpassR[i]._process_ov(outR);
       lpfR = damp2*lpfR + damp2_1*outR; UNDENORMAL(lpfR);
       outR = allpassR[3]._process_ov(lpfR); outR = allpassL[6]._process_ov(outR);
@@ -165,7 +165,7 @@ void FV3_(nrev)::processloop2(long count, fv3_float_t *inputL, fv3_float_t *inpu
 void FV3_(nrev)::processloop4(long count, fv3_float_t *inputL, fv3_float_t *inputR, fv3_float_t *outputL, fv3_float_t *outputR,
 			      fv3_float_t *outRearL, fv3_float_t *outRearR)
 {
-  fv3_float_t outL, outR;
+  fv3_float_t outL, outR, combOut[2*FV3_NREV_NUM_COMB];
   while(count-- > 0)
     {
       outL = outR = 0;
@@ -173,8 +173,9 @@ void FV3_(nrev)::processloop4(long count, fv3_float_t *inputL, fv3_float_t *inpu
       UNDENORMAL(hpf);
 
       hpf *= FV3_NREV_SCALE_WET;
+      combLR._process(hpf, combOut);
       
-      for(long i = 0;i < FV3_NREV_NUM_COMB;i ++) outL += combL[i]._process(hpf);
+      for(long i = 0;i < FV3_NREV_NUM_COMB;i ++) outL += combOut[i];
       for(long i = 0;i < 3;i ++) outL = allpassL[i]._process_ov(outL);
       lpfL = damp2*lpfL + damp2_1*outL; UNDENORMAL(lpfL);
       outL = allpassL[3]._process_ov(lpfL);
@@ -186,7 +187,7 @@ void FV3_(nrev)::processloop4(long count, fv3_float_t *inputL, fv3_float_t *inpu
       *outRearL = delayRearL(*outRearL);
       outRearL ++;
 
-      for(long i = 0;i < FV3_NREV_NUM_COMB;i ++) outR += combR[i]._process(hpf);
+      for(long i = 0;i < FV3_NREV_NUM_COMB;i ++) outR += combOut[FV3_NREV_NUM_COMB+i];
       for(long i = 0;i < 3;i ++) outR = allpassR[i]._process_ov(outR);
       lpfR = damp2*lpfR + damp2_1*outR; UNDENORMAL(lpfR);
       outR = allpassR[3]._process_ov(lpfR);
@@ -208,8 +209,8 @@ void FV3_(nrev)::setcombfeedback(fv3_float_t back, long zero)
 {
   for(long i = 0;i < FV3_NREV_NUM_COMB;i ++)
     {
-      combL[i].setfeedback(zero*std::pow((fv3_float_t)10.0, -3 * (fv3_float_t)combL[i].getsize() / back));
-      combR[i].setfeedback(zero*std::pow((fv3_float_t)10.0, -3 * (fv3_float_t)combR[i].getsize() / back));
+      combLR.setfeedback(i, zero*std::pow((fv3_float_t)10.0, -3 * (fv3_float_t)combLR.getsize(i) / back));
+      combLR.setfeedback(FV3_NREV_NUM_COMB+i, zero*std::pow((fv3_float_t)10.0, -3 * (fv3_float_t)combLR.getsize(FV3_NREV_NUM_COMB+i) / back));
     }
 }
 
@@ -248,8 +249,8 @@ void FV3_(nrev)::setdamp(fv3_float_t value)
   damp = value;
   for(long i = 0;i < FV3_NREV_NUM_COMB;i ++)
     {
-      combL[i].setdamp(damp);
-      combR[i].setdamp(damp);
+      combLR.setdamp(i, damp);
+      combLR.setdamp(FV3_NREV_NUM_COMB+i, damp);
     }
 }
 
@@ -320,8 +321,8 @@ void FV3_(nrev)::setFsFactors()
   long stereoSpread = f_((long)FV3_NREV_STEREO_SPREAD, totalFactor);
   for(long i = 0;i < FV3_NREV_NUM_COMB;i ++)
     {
-      combL[i].setsize(p_(combCo[i],totalFactor));
-      combR[i].setsize(p_(f_(combCo[i],totalFactor)+stereoSpread,1));
+      combLR.setsize(i, p_(combCo[i],totalFactor));
+      combLR.setsize(FV3_NREV_NUM_COMB+i, p_(f_(combCo[i],totalFactor)+stereoSpread,1));
     }
   for(long i = 0;i < FV3_NREV_NUM_ALLPASS;i ++)
     {
@@ -100,7 +100,8 @@ class _FV3_(nrev) : public _FV3_(revbase)
   _fv3_float_t roomsize, feedback, damp, damp2, damp2_1, damp3, damp3_1;
   _fv3_float_t wetRearReal, wetRear, dccutfq;
   _FV3_(allpass) allpassL[FV3_NREV_NUM_ALLPASS], allpassR[FV3_NREV_NUM_ALLPASS];
-  _FV3_(comb) combL[FV3_NREV_NUM_COMB], combR[FV3_NREV_NUM_COMB];
+  // combL = lanes [0,FV3_NREV_NUM_COMB), combR = lanes [FV3_NREV_NUM_COMB,2*FV3_NREV_NUM_COMB)
+  _FV3_(combv) combLR;
   _FV3_(src) SRCRear;
   long rearDelay;
   _FV3_(delay) delayRearL, delayRearR;
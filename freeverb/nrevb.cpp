@@ -32,6 +32,7 @@ const long FV3_(nrevb)::allpassCo2[] = {57, 87, 103,};
 FV3_(nrevb)::FV3_(nrevb)()
 	    
 {
+  comb2LR.setlanes(2*FV3_NREVB_NUM_COMB_2);
   lastL = lastR = 0;
   setdamp(0.1);
   setfeedback(0.5);
@@ -42,10 +43,7 @@ void FV3_(nrevb)::mute()
 {
   FV3_(nrev)::mute();
   lastL = lastR = 0;
-  for (long i = 0;i < FV3_NREVB_NUM_COMB_2;i ++)
-    {
-      comb2L[i].mute(); comb2R[i].mute();
-    }
+  comb2LR.mute();
   for (long i = 0;i < FV3_NREVB_NUM_ALLPASS_2;i ++)
     {
       allpass2L[i].mute(); allpass2R[i].mute();
@@ -57,8 +55,8 @@ void FV3_(nrevb)::setcombfeedback(fv3_float_t back, long zero)
   FV3_(nrev)::setcombfeedback(back, zero);
   for(long i = 0;i < FV3_NREVB_NUM_COMB_2;i ++)
     {
-      comb2L[i].setfeedback(zero*std::pow((fv3_float_t)10.0, -3 * (fv3_float_t)comb2L[i].getsize() / back));
-      comb2R[i].setfeedback(zero*std::pow((fv3_float_t)10.0, -3 * (fv3_float_t)comb2R[i].getsize() / back));
+      comb2LR.setfeedback(i, zero*std::pow((fv3_float_t)10.0, -3 * (fv3_float_t)comb2LR.getsize(i) / back));
+      comb2LR.setfeedback(FV3_NREVB_NUM_COMB_2+i, zero*std::pow((fv3_float_t)10.0, -3 * (fv3_float_t)comb2LR.getsize(FV3_NREVB_NUM_COMB_2+i) / back));
     }
 }
 
@@ -77,23 +75,25 @@ void FV3_(nrevb)::setdamp(fv3_float_t value)
   FV3_(nrev)::setdamp(value);
   for(long i = 0;i < FV3_NREVB_NUM_COMB_2;i ++)
     {
-      comb2L[i].setdamp(value);
-      comb2R[i].setdamp(value);
+      comb2LR.setdamp(i, value);
+      comb2LR.setdamp(FV3_NREVB_NUM_COMB_2+i, value);
     }
 }
 
 void FV3_(nrevb)::processloop2(long count, fv3_float_t *inputL, fv3_float_t *inputR, fv3_float_t *outputL, fv3_float_t *outputR)
 {
-  fv3_float_t outL, outR, tmpL, tmpR;
+  fv3_float_t outL, outR, combOut[2*FV3_NREV_NUM_COMB], comb2Out[2*FV3_NREVB_NUM_COMB_2];
   while(count-- > 0)
     {
       hpf = damp3_1*inDCC.process(*inputL + *inputR) - damp3*hpf; UNDENORMAL(hpf);
-      outL = outR = tmpL = tmpR = hpf;
+      outL = outR = hpf;
+      combLR._process(hpf, combOut);
+      comb2LR._process(hpf, comb2Out);
       
       outL += apfeedback*lastL;
       lastL += -1*apfeedback*outL;
-      for(long i = 0;i < FV3_NREV_NUM_COMB;i ++) outL += combL[i]._process(tmpL);
-      for(long i = 0;i < FV3_NREVB_NUM_COMB_2;i ++) outL += comb2L[i]._process(tmpL);
+      for(long i = 0;i < FV3_NREV_NUM_COMB;i ++) outL += combOut[i];
+      for(long i = 0;i < FV3_NREVB_NUM_COMB_2;i ++) outL += comb2Out[i];
       for(long i = 0;i < 3;i ++) outL = allpassL[i]._process(outL);
       for(long i = 0;i < FV3_NREVB_NUM_ALLPASS_2;i ++) outL = allpass2L[i]._process(outL);
       lpfL = damp2*lpfL + damp2_1*outL; UNDENORMAL(lpfL);
@@ -102,8 +102,8 @@ void FV3_(nrevb)::processloop2(long count, fv3_float_t *inputL, fv3_float_t *inp
 
       outR += apfeedback*lastR;
       lastR += -1*apfeedback*outR;
-      for(long i = 0;i < FV3_NREV_NUM_COMB;i ++) outR += combR[i]._process(tmpR);
-      for(long i = 0;i < FV3_NREVB_NUM_COMB_2;i ++) outR += comb2R[i]._process(tmpR);
+      for(long i = 0;i < FV3_NREV_NUM_COMB;i ++) outR += combOut[FV3_NREV_NUM_COMB+i];
+      for(long i = 0;i < FV3_NREVB_NUM_COMB_2;i ++) outR += comb2Out[FV3_NREVB_NUM_COMB_2+i];
       for(long i = 0;i < 3;i ++) outR = allpassR[i]._process(outR);
       for(long i = 0;i < FV3_NREVB_NUM_ALLPASS_2;i ++) outR = allpass2R[i]._process(outR);
       lpfR = damp2*lpfR + damp2_1*outR; UNDENORMAL(lpfR);
@@ -133,8 +133,8 @@ void FV3_(nrevb)::setFsFactors()
   long stereoSpread = f_((long)FV3_NREV_STEREO_SPREAD, totalFactor);
   for(long i = 0;i < FV3_NREVB_NUM_COMB_2;i ++)
     {
-      comb2L[i].setsize(p_(combCo2[i],totalFactor));
-      comb2R[i].setsize(p_(f_(combCo2[i],totalFactor)+stereoSpread,1));
+      comb2LR.setsize(i, p_(combCo2[i],totalFactor));
+      comb2LR.setsize(FV3_NREVB_NUM_COMB_2+i, p_(f_(combCo2[i],totalFactor)+stereoSpread,1));
     }
   for(long i = 0;i < FV3_NREVB_NUM_ALLPASS_2;i ++)
     {
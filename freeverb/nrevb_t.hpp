@@ -39,7 +39,8 @@ class _FV3_(nrevb) : public _FV3_(nrev)
   // work values
   _fv3_float_t lastL, lastR;
   _FV3_(allpass) allpass2L[FV3_NREVB_NUM_ALLPASS_2], allpass2R[FV3_NREVB_NUM_ALLPASS_2];
-  _FV3_(comb) comb2L[FV3_NREVB_NUM_COMB_2], comb2R[FV3_NREVB_NUM_COMB_2];
+  // comb2L = lanes [0,FV3_NREVB_NUM_COMB_2), comb2R = lanes [FV3_NREVB_NUM_COMB_2,2*FV3_NREVB_NUM_COMB_2)
+  _FV3_(combv) comb2LR;
   const static long combCo2[FV3_NREVB_NUM_COMB_2], allpassCo2[FV3_NREVB_NUM_ALLPASS_2];
     
  private:
@@ -0,0 +1,176 @@
+/**
+ *  Polyphase Integer Factor Oversampler
+ *
+ *  Copyright (C) 2006-2018 Teru Kamogashira
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "freeverb/polyphase.hpp"
+#include "freeverb/fv3_type_float.h"
+#include "freeverb/fv3_ns_start.h"
+
+FV3_(polyphase)::FV3_(polyphase)()
+{
+  factor = 1; taps = 0;
+}
+
+FV3_(polyphase)::~FV3_(polyphase)()
+{
+  free();
+}
+
+void FV3_(polyphase)::free()
+{
+  upCoef.free(); downCoef.free();
+  upHist.free(); upWork.free(); downHist.free(); downPhase.free();
+  factor = 1;
+}
+
+void FV3_(polyphase)::setFactor(long _factor, long _taps)
+{
+  if(_factor < 1||_taps < 2)
+    {
+      std::fprintf(stderr, "polyphase::setFactor(%ld,%ld): invalid factor/taps\n", _factor, _taps);
+      return;
+    }
+  free();
+  factor = _factor; taps = _taps;
+  if(factor == 1) return;
+
+  // prototype LPF, zero padded to factor*taps points
+  const long length = factor*(taps-1)+1, H = factor*taps-1;
+  FV3_(slot) prototype, window;
+  try
+    {
+      prototype.alloc(factor*taps, 1);
+      window.alloc(length, 1);
+      upCoef.alloc(factor*taps, 1);
+      downCoef.alloc(factor*taps, 1);
+      upHist.alloc(taps-1+FV3_POLYPHASE_BLOCK, 2);
+      upWork.alloc(FV3_POLYPHASE_BLOCK, 2);
+      downHist.alloc(H+factor*FV3_POLYPHASE_BLOCK, 2);
+      downPhase.alloc(factor*(taps-1+FV3_POLYPHASE_BLOCK), 2);
+    }
+  catch(std::bad_alloc)
+    {
+      std::fprintf(stderr, "polyphase::setFactor(%ld,%ld) bad_alloc\n", factor, taps);
+      free();
+      factor = 1;
+      throw;
+    }
+  fv3_float_t * h = prototype.L, * w = window.L;
+  FV3_(firwindow)::Sinc(h, length, 0.5/(fv3_float_t)factor);
+  FV3_(firwindow)::Kaiser(w, length, FV3_(firwindow)::KaiserBeta(FV3_POLYPHASE_ATTENUATION)/M_PI);
+  fv3_float_t sum = 0;
+  for(long i = 0;i < length;i ++){ h[i] *= w[i]; sum += h[i]; }
+  for(long i = 0;i < length;i ++) h[i] /= sum;
+  for(long i = length;i < factor*taps;i ++) h[i] = 0;
+
+  // y[n*factor+p] = factor * sum_k h[p+k*factor] x[n-k]
+  for(long p = 0;p < factor;p ++)
+    for(long k = 0;k < taps;k ++)
+      upCoef.L[p*taps+k] = (fv3_float_t)factor*h[p+(taps-1-k)*factor];
+  // y[n] = sum_j h[j] x[n*factor-j]
+  for(long s = 0;s < factor;s ++)
+    for(long r = 0;r < taps;r ++)
+      downCoef.L[s*taps+r] = h[H-r*factor-s];
+  mute();
+}
+
+void FV3_(polyphase)::mute()
+{
+  upHist.mute(); upWork.mute(); downHist.mute(); downPhase.mute();
+}
+
+void FV3_(polyphase)::upsample(const fv3_float_t *inputL, const fv3_float_t *inputR, fv3_float_t *outputL, fv3_float_t *outputR, long numsamples)
+{
+  if(factor == 1)
+    {
+      std::memmove(outputL, inputL, sizeof(fv3_float_t)*numsamples);
+      std::memmove(outputR, inputR, sizeof(fv3_float_t)*numsamples);
+      return;
+    }
+  for(long i = 0;i < numsamples;i += FV3_POLYPHASE_BLOCK)
+    {
+      long count = numsamples-i < FV3_POLYPHASE_BLOCK ? numsamples-i : FV3_POLYPHASE_BLOCK;
+      upblock(inputL+i, inputR+i, outputL+i*factor, outputR+i*factor, count);
+    }
+}
+
+void FV3_(polyphase)::downsample(const fv3_float_t *inputL, const fv3_float_t *inputR, fv3_float_t *outputL, fv3_float_t *outputR, long numsamples)
+{
+  if(factor == 1)
+    {
+      std::memmove(outputL, inputL, sizeof(fv3_float_t)*numsamples);
+      std::memmove(outputR, inputR, sizeof(fv3_float_t)*numsamples);
+      return;
+    }
+  for(long i = 0;i < numsamples;i += FV3_POLYPHASE_BLOCK)
+    {
+      long count = numsamples-i < FV3_POLYPHASE_BLOCK ? numsamples-i : FV3_POLYPHASE_BLOCK;
+      downblock(inputL+i*factor, inputR+i*factor, outputL+i, outputR+i, count);
+    }
+}
+
+// The inner loops run over the outputs with a fixed coefficient, L and R side by side,
+// so that they are vectorized without reassociating the sums.
+
+void FV3_(polyphase)::upblock(const fv3_float_t *inputL, const fv3_float_t *inputR, fv3_float_t *outputL, fv3_float_t *outputR, long numsamples)
+{
+  fv3_float_t *hL = upHist.L, *hR = upHist.R, *wL = upWork.L, *wR = upWork.R;
+  std::memcpy(hL+taps-1, inputL, sizeof(fv3_float_t)*numsamples);
+  std::memcpy(hR+taps-1, inputR, sizeof(fv3_float_t)*numsamples);
+  for(long p = 0;p < factor;p ++)
+    {
+      const fv3_float_t * coef = upCoef.L+p*taps;
+      FV3_(utils)::mute(wL, numsamples); FV3_(utils)::mute(wR, numsamples);
+      for(long k = 0;k < taps;k ++)
+	{
+	  const fv3_float_t c = coef[k], *xL = hL+k, *xR = hR+k;
+	  for(long n = 0;n < numsamples;n ++){ wL[n] += c*xL[n]; wR[n] += c*xR[n]; }
+	}
+      for(long n = 0;n < numsamples;n ++){ outputL[n*factor+p] = wL[n]; outputR[n*factor+p] = wR[n]; }
+    }
+  std::memmove(hL, hL+numsamples, sizeof(fv3_float_t)*(taps-1));
+  std::memmove(hR, hR+numsamples, sizeof(fv3_float_t)*(taps-1));
+}
+
+void FV3_(polyphase)::downblock(const fv3_float_t *inputL, const fv3_float_t *inputR, fv3_float_t *outputL, fv3_float_t *outputR, long numsamples)
+{
+  const long H = factor*taps-1, plen = taps-1+FV3_POLYPHASE_BLOCK, count = taps-1+numsamples;
+  fv3_float_t *hL = downHist.L, *hR = downHist.R;
+  std::memcpy(hL+H, inputL, sizeof(fv3_float_t)*numsamples*factor);
+  std::memcpy(hR+H, inputR, sizeof(fv3_float_t)*numsamples*factor);
+  for(long s = 0;s < factor;s ++)
+    {
+      fv3_float_t *pL = downPhase.L+s*plen, *pR = downPhase.R+s*plen;
+      for(long i = 0;i < count;i ++){ pL[i] = hL[i*factor+s]; pR[i] = hR[i*factor+s]; }
+    }
+  FV3_(utils)::mute(outputL, numsamples); FV3_(utils)::mute(outputR, numsamples);
+  for(long s = 0;s < factor;s ++)
+    {
+      const fv3_float_t * coef = downCoef.L+s*taps;
+      for(long r = 0;r < taps;r ++)
+	{
+	  const fv3_float_t c = coef[r], *xL = downPhase.L+s*plen+r, *xR = downPhase.R+s*plen+r;
+	  for(long n = 0;n < numsamples;n ++){ outputL[n] += c*xL[n]; outputR[n] += c*xR[n]; }
+	}
+    }
+  std::memmove(hL, hL+numsamples*factor, sizeof(fv3_float_t)*H);
+  std::memmove(hR, hR+numsamples*factor, sizeof(fv3_float_t)*H);
+}
+
+#include "freeverb/fv3_ns_end.h"
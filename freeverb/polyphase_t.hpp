@@ -0,0 +1,61 @@
+/**
+ *  Polyphase Integer Factor Oversampler
+ *
+ *  Copyright (C) 2006-2018 Teru Kamogashira
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/**
+ * Integer factor polyphase FIR up/down sampler for the stereo oversampling.
+ * The prototype is a Kaiser windowed sinc low pass filter of factor*(taps-1)+1 points.
+ * Only the non-zero input samples of the upsampler and the kept outputs of the
+ * downsampler are computed. The latency of an up/down round trip is exactly taps-1
+ * samples of the base rate.
+ */
+class _FV3_(polyphase)
+{
+ public:
+  _FV3_(polyphase)();
+  virtual _FV3_(~polyphase)();
+  void setFactor(long factor, long taps);
+  long getFactor(){ return factor; }
+  long getTaps(){ return taps; }
+  long getLatency(){ return factor > 1 ? taps-1 : 0; }
+  void mute();
+  void free();
+
+  /**
+   * @param[in] numsamples base rate input samples, numsamples*factor samples are written to the outputs.
+   */
+  void upsample(const _fv3_float_t *inputL, const _fv3_float_t *inputR, _fv3_float_t *outputL, _fv3_float_t *outputR, long numsamples);
+
+  /**
+   * @param[in] numsamples base rate output samples, numsamples*factor samples are read from the inputs.
+   */
+  void downsample(const _fv3_float_t *inputL, const _fv3_float_t *inputR, _fv3_float_t *outputL, _fv3_float_t *outputR, long numsamples);
+
+ private:
+  _FV3_(polyphase)(const _FV3_(polyphase)& x);
+  _FV3_(polyphase)& operator=(const _FV3_(polyphase)& x);
+  void upblock(const _fv3_float_t *inputL, const _fv3_float_t *inputR, _fv3_float_t *outputL, _fv3_float_t *outputR, long numsamples);
+  void downblock(const _fv3_float_t *inputL, const _fv3_float_t *inputR, _fv3_float_t *outputL, _fv3_float_t *outputR, long numsamples);
+  long factor, taps;
+  // upCoef[p*taps+k]: phase p, oldest input first. downCoef[s*taps+r]: high rate phase s, oldest input first.
+  _FV3_(slot) upCoef, downCoef;
+  // upHist: taps-1 base rate history + block, downHist: factor*taps-1 high rate history + block,
+  // downPhase: downHist split into factor phases of taps-1+FV3_POLYPHASE_BLOCK samples.
+  _FV3_(slot) upHist, upWork, downHist, downPhase;
+};
@@ -59,6 +59,7 @@ void FV3_(progenitor2)::mute()
 void FV3_(progenitor2)::processreplace(fv3_float_t *inputL, fv3_float_t *inputR, fv3_float_t *outputL, fv3_float_t *outputR, long numsamples)
 		       
 {
+  FV3_(denormalguard) guard;
   switch(reverbType)
     {
     case FV3_REVTYPE_PROG:
@@ -107,6 +107,28 @@ void FV3_(revbase)::mute()
   SRC.mute();
 }
 
+void FV3_(revbase)::processstrided(const fv3_float_t *inputL, const fv3_float_t *inputR, long inputStride,
+                                   fv3_float_t *outputL, fv3_float_t *outputR, long outputStride, long numsamples)
+{
+  if(numsamples <= 0) return;
+  if(inputStride < 1||outputStride < 1)
+    {
+      std::fprintf(stderr, "revbase::processstrided(%ld,%ld) invalid stride\n", inputStride, outputStride);
+      return;
+    }
+  // the chunks stay in the cache instead of the whole blocks split into the planar buffers
+  fv3_float_t iL[FV3_REVBASE_StrideChunk], iR[FV3_REVBASE_StrideChunk], oL[FV3_REVBASE_StrideChunk], oR[FV3_REVBASE_StrideChunk];
+  for(long pos = 0;pos < numsamples;pos += FV3_REVBASE_StrideChunk)
+    {
+      long n = numsamples - pos < FV3_REVBASE_StrideChunk ? numsamples - pos : FV3_REVBASE_StrideChunk;
+      const fv3_float_t *ciL = inputL+pos*inputStride, *ciR = inputR+pos*inputStride;
+      fv3_float_t *coL = outputL+pos*outputStride, *coR = outputR+pos*outputStride;
+      for(long i = 0;i < n;i ++){ iL[i] = ciL[i*inputStride], iR[i] = ciR[i*inputStride]; }
+      processreplace(iL, iR, oL, oR, n);
+      for(long i = 0;i < n;i ++){ coL[i*outputStride] = oL[i], coR[i*outputStride] = oR[i]; }
+    }
+}
+
 void FV3_(revbase)::growWave(long size)
 		
 {
@@ -61,6 +61,13 @@ public:
   virtual void mute();
   virtual void processreplace(_fv3_float_t *inputL, _fv3_float_t *inputR, _fv3_float_t *outputL, _fv3_float_t *outputR, long numsamples)
      = 0;
+  /**
+   * process the strided buffers, the i-th sample of a channel is at [i*stride].
+   * processstrided(LR, LR+1, 2, LR, LR+1, 2, numsamples) processes the interleaved LR in place.
+   * @attention each output must be the same as an input or must not overlap the inputs.
+   */
+  virtual void processstrided(const _fv3_float_t *inputL, const _fv3_float_t *inputR, long inputStride,
+                              _fv3_float_t *outputL, _fv3_float_t *outputR, long outputStride, long numsamples);
 
   /**
    * set the reverb front sound level.
@@ -28,6 +28,7 @@ const long FV3_(revmodel)::allpCo[] = {556, 441, 341, 225,};
 FV3_(revmodel)::FV3_(revmodel)()
 	       
 {
+  combLR.setlanes(2*FV3_FREV_NUM_COMB);
   setroomsize(0.1);
   setdamp(0.1);
 }
@@ -42,11 +43,7 @@ void FV3_(revmodel)::printconfig()
 void FV3_(revmodel)::mute()
 {
   FV3_(revbase)::mute();
-  for (long i = 0;i < FV3_FREV_NUM_COMB;i ++)
-    {
-      combL[i].mute();
-      combR[i].mute();
-    }
+  combLR.mute();
   for (long i = 0;i < FV3_FREV_NUM_ALLPASS;i ++)
     {
       allpassL[i].mute();
@@ -57,39 +54,48 @@ void FV3_(revmodel)::mute()
 void FV3_(revmodel)::processreplace(fv3_float_t *inputL, fv3_float_t *inputR, fv3_float_t *outputL, fv3_float_t *outputR, long numsamples)
 		    
 {
+  FV3_(denormalguard) guard;
   if(numsamples <= 0) return;
   long count = numsamples*SRC.getSRCFactor();
   try{ growWave(count); }catch(std::bad_alloc){ throw; }
 
   fv3_float_t outL, outR, input, *origOutL = outputL, *origOutR = outputR;
+  fv3_float_t combOut[2*FV3_FREV_NUM_COMB];
   SRC.usrc(inputL, inputR, over.L, over.R, numsamples);
   inputL = over.L; inputR = over.R; outputL = overO.L; outputR = overO.R;
 
-  while(count-- > 0)
+  for(long t = 0;t < count;t ++)
     {
       outL = outR = 0.0;
-      input = (*inputL + *inputR) * FV3_FREV_FIXED_GAIN;
+      input = (inputL[t] + inputR[t]) * FV3_FREV_FIXED_GAIN;
 
       // Accumulate comb filters in parallel
+      combLR._process(input, combOut);
       for(long i = 0;i < FV3_FREV_NUM_COMB;i ++)
 	{
-	  outL += combL[i]._process(input);
-	  outR += combR[i]._process(input);
-	}
-      
-      // Feed through allpasses in series
-      for(long i = 0;i < FV3_FREV_NUM_ALLPASS;i ++)
-	{
-	  outL = allpassL[i]._process_ov(outL);
-	  outR = allpassR[i]._process_ov(outR);
+	  outL += combOut[i];
+	  outR += combOut[FV3_FREV_NUM_COMB+i];
 	}
+      outputL[t] = outL; outputR[t] = outR;
+    }
 
-      fv3_float_t fpL = delayWL(outL);
-      fv3_float_t fpR = delayWR(outR);
-      *outputL = fpL*wet1 + fpR*wet2 + delayL(*inputL)*dry;
-      *outputR = fpR*wet1 + fpL*wet2 + delayR(*inputR)*dry;
-      UNDENORMAL(*outputL); UNDENORMAL(*outputR);
-      inputL ++; inputR ++; outputL ++; outputR ++;
+  // Feed through allpasses in series
+  for(long i = 0;i < FV3_FREV_NUM_ALLPASS;i ++)
+    {
+      allpassL[i].process_ov(outputL, outputL, count);
+      allpassR[i].process_ov(outputR, outputR, count);
+    }
+
+  delayWL.process(outputL, outputL, count);
+  delayWR.process(outputR, outputR, count);
+  delayL.process(inputL, inputL, count);
+  delayR.process(inputR, inputR, count);
+  for(long t = 0;t < count;t ++)
+    {
+      fv3_float_t fpL = outputL[t], fpR = outputR[t];
+      outputL[t] = fpL*wet1 + fpR*wet2 + inputL[t]*dry;
+      outputR[t] = fpR*wet1 + fpL*wet2 + inputR[t]*dry;
+      UNDENORMAL(outputL[t]); UNDENORMAL(outputR[t]);
     }
   SRC.dsrc(overO.L, overO.R, origOutL, origOutR, numsamples);
 }
@@ -99,8 +105,8 @@ void FV3_(revmodel)::setroomsize(fv3_float_t value)
   roomsize = (value*FV3_FREV_SCALE_ROOM) + FV3_FREV_OFFSET_ROOM;
   for(long i = 0;i < FV3_FREV_NUM_COMB;i ++)
     {
-      combL[i].setfeedback(roomsize);
-      combR[i].setfeedback(roomsize);
+      combLR.setfeedback(i, roomsize);
+      combLR.setfeedback(FV3_FREV_NUM_COMB+i, roomsize);
     }
 }
 
@@ -114,8 +120,8 @@ void FV3_(revmodel)::setdamp(fv3_float_t value)
   damp = value;
   for(long i = 0;i < FV3_FREV_NUM_COMB;i ++)
     {
-      combL[i].setdamp(damp);
-      combR[i].setdamp(damp);
+      combLR.setdamp(i, damp);
+      combLR.setdamp(FV3_FREV_NUM_COMB+i, damp);
     }
 }
 
@@ -157,8 +163,8 @@ void FV3_(revmodel)::setFsFactors()
     }
   for(long i = 0;i < FV3_FREV_NUM_COMB;i ++)
     {
-      combL[i].setsize(f_(combCo[i],totalFactor));
-      combR[i].setsize(f_(combCo[i]+FV3_FREV_STEREO_SPREAD441,totalFactor));
+      combLR.setsize(i, f_(combCo[i],totalFactor));
+      combLR.setsize(FV3_FREV_NUM_COMB+i, f_(combCo[i]+FV3_FREV_STEREO_SPREAD441,totalFactor));
     }
   setAllpassFeedback(FV3_FREV_ALLPASS_FEEDBACK);
   setdamp(getdamp());
@@ -42,6 +42,7 @@ public:
   void setAllpassFeedback(_fv3_float_t fb);
   _fv3_float_t roomsize, damp;
   _FV3_(allpass) allpassL[FV3_FREV_NUM_ALLPASS], allpassR[FV3_FREV_NUM_ALLPASS];
-  _FV3_(comb) combL[FV3_FREV_NUM_COMB], combR[FV3_FREV_NUM_COMB];
+  // combL = lanes [0,FV3_FREV_NUM_COMB), combR = lanes [FV3_FREV_NUM_COMB,2*FV3_FREV_NUM_COMB)
+  _FV3_(combv) combLR;
   const static long combCo[FV3_FREV_NUM_COMB], allpCo[FV3_FREV_NUM_ALLPASS];
 };
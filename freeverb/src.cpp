@@ -69,6 +69,11 @@ void FV3_(src)::setSRCFactor(long factor, long converter_type)
       up2R.setLPF_RBJ  (1, lpf_iir2_bw, 2*overSamplingFactor, FV3_BIQUAD_RBJ_Q);
       down2R.setLPF_RBJ(1, lpf_iir2_bw, 2*overSamplingFactor, FV3_BIQUAD_RBJ_Q);
       break;
+
+    case FV3_SRC_POLYPHASE:
+      poly.setFactor(overSamplingFactor, FV3_POLYPHASE_DEFAULT_TAPS);
+      latency = poly.getLatency();
+      break;
       
     default:
       src_stateL = SRC_(src_new)(src_converter, 1, &src_errorL);
@@ -90,6 +95,9 @@ void FV3_(src)::setSRCFactor(long factor, long converter_type)
       
       src_dataL.src_ratio = src_dataR.src_ratio = (fv3_float_t)factor;
       src_dataLV.src_ratio = src_dataRV.src_ratio = 1.0f/(fv3_float_t)factor;
+      // the sinc converters build their coefficient tables here, not in the processing
+      SRC_(src_set_ratio)(src_stateL, src_dataL.src_ratio); SRC_(src_set_ratio)(src_stateR, src_dataR.src_ratio);
+      SRC_(src_set_ratio)(src_stateLV, src_dataLV.src_ratio); SRC_(src_set_ratio)(src_stateRV, src_dataRV.src_ratio);
       latency = filloutSRC();
       break;
     }
@@ -111,6 +119,7 @@ void FV3_(src)::mute()
 {
   up1L.mute(), up1R.mute(), down1L.mute(), down1R.mute();
   up2L.mute(), up2R.mute(), down2L.mute(), down2R.mute();
+  poly.mute();
   if(src_stateL == NULL||src_stateR == NULL||src_stateLV == NULL||src_stateRV == NULL) return;
   SRC_(src_reset)(src_stateL); SRC_(src_reset)(src_stateR);
   SRC_(src_reset)(src_stateLV); SRC_(src_reset)(src_stateRV);
@@ -123,6 +132,7 @@ void FV3_(src)::freeSRC()
   if(src_stateLV != NULL) src_stateLV = SRC_(src_delete)(src_stateLV);
   if(src_stateRV != NULL) src_stateRV = SRC_(src_delete)(src_stateRV);
   src_stateL = src_stateR = src_stateLV = src_stateRV = NULL;
+  poly.free();
 }
 
 void FV3_(src)::src_uzoh(fv3_float_t *input, fv3_float_t *output, long factor, long numsamples)
@@ -188,6 +198,11 @@ long FV3_(src)::usrc(fv3_float_t *inputL, fv3_float_t *inputR, fv3_float_t *outp
       src_u_iir2(inputR, outputR, overSamplingFactor, numsamples, &up2R);
       break;
 
+    case FV3_SRC_POLYPHASE:
+      poly.upsample(inputL, inputR, outputL, outputR, numsamples);
+      numsamples *= overSamplingFactor;
+      break;
+
     default:
       src_dataL.data_in = inputL; src_dataL.data_out = outputL;
       src_dataR.data_in = inputR; src_dataR.data_out = outputR;
@@ -238,6 +253,10 @@ long FV3_(src)::dsrc(fv3_float_t *inputL, fv3_float_t *inputR,
       src_d_iir2(inputR, outputR, overSamplingFactor, numsamples, &down2R);
       break;
 
+    case FV3_SRC_POLYPHASE:
+      poly.downsample(inputL, inputR, outputL, outputR, numsamples);
+      break;
+
     default:  
       src_dataLV.data_in = inputL; src_dataLV.data_out = outputL;
       src_dataRV.data_in = inputR; src_dataRV.data_out = outputR;
@@ -26,6 +26,7 @@
 #include "freeverb/utils.hpp"
 #include "freeverb/efilter.hpp"
 #include "freeverb/biquad.hpp"
+#include "freeverb/polyphase.hpp"
 #include "freeverb/fv3_defs.h"
 
 namespace fv3
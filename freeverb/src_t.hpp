@@ -50,5 +50,6 @@ class _FV3_(src)
   long src_errorL, src_errorR;
   _FV3_(iir_1st) up1L, up1R, down1L, down1R;
   _FV3_(biquad) up2L, up2R, down2L, down2R;
+  _FV3_(polyphase) poly;
   _fv3_float_t lpf_iir2_bw;
 };
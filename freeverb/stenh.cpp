@@ -60,6 +60,7 @@ void FV3_(stenh)::mute()
 
 void FV3_(stenh)::processreplace(fv3_float_t *inputL, fv3_float_t *inputR, fv3_float_t *outputL, fv3_float_t *outputR, long numsamples)
 {
+  FV3_(denormalguard) guard;
   for(long i = 0;i < numsamples;i ++)
     {
       fv3_float_t iL = inputL[i], iR = inputR[i], diff, directS, delayS, sumS, gainS, gainD, vcaFactor;
@@ -81,6 +81,7 @@ void FV3_(strev)::mute()
 void FV3_(strev)::processreplace(fv3_float_t *inputL, fv3_float_t *inputR, fv3_float_t *outputL, fv3_float_t *outputR, long numsamples)
 		    
 {
+  FV3_(denormalguard) guard;
   if(numsamples <= 0) return;
   long count = numsamples*getOSFactor();
   try{growWave(count);}catch(std::bad_alloc){throw;}
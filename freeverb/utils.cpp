@@ -19,6 +19,9 @@
  */
 
 #include "freeverb/utils.hpp"
+#if !defined(ENABLE_X86SIMD)&&defined(__SSE__)
+#include <xmmintrin.h>
+#endif
 #include "freeverb/fv3_type_float.h"
 #include "freeverb/fv3_ns_start.h"
 
@@ -150,6 +153,29 @@ void FV3_(utils)::setMXCSR(uint32_t mxcsr)
 #endif
 }
 
+uint64_t FV3_(utils)::getFPCR()
+{
+  uint64_t fpcr = 0;
+#if defined(__aarch64__)
+  __asm__ __volatile__ ("mrs %0, fpcr" : "=r" (fpcr));
+#elif defined(__arm__)&&defined(__VFP_FP__)&&!defined(__SOFTFP__)
+  uint32_t fpscr;
+  __asm__ __volatile__ ("vmrs %0, fpscr" : "=r" (fpscr));
+  fpcr = fpscr;
+#endif
+  return fpcr;
+}
+
+void FV3_(utils)::setFPCR(uint64_t fpcr)
+{
+#if defined(__aarch64__)
+  __asm__ __volatile__ ("msr fpcr, %0" : : "r" (fpcr));
+#elif defined(__arm__)&&defined(__VFP_FP__)&&!defined(__SOFTFP__)
+  uint32_t fpscr = (uint32_t)fpcr;
+  __asm__ __volatile__ ("vmsr fpscr, %0" : : "r" (fpscr));
+#endif
+}
+
 void FV3_(utils)::XGETBV(uint32_t op, uint32_t * _eax, uint32_t *_edx)
 {
 #if defined(ENABLE_X86SIMD)
@@ -170,12 +196,12 @@ void FV3_(utils)::cpuid(uint32_t op, uint32_t *out_eax, uint32_t *out_ebx, uint3
   uint32_t c_eax, c_ebx, c_ecx, c_edx;
 #if defined(__amd64__)||defined(__x86_64__)
   __asm__ __volatile__("cpuid\n\t"
-		       :[eax]"=a"(c_eax),[ebx]"=b"(c_ebx),[ecx]"=c"(c_ecx),[edx]"=d"(c_edx) :"a"(op) : "cc" );
+		       :[eax]"=a"(c_eax),[ebx]"=b"(c_ebx),[ecx]"=c"(c_ecx),[edx]"=d"(c_edx) :"a"(op), "c"(0) : "cc" );
 #else
   __asm__ __volatile__("xchgl %%ebx,%[ebx]\n\t"
 		       "cpuid\n\t"
 		       "xchgl %%ebx,%[ebx]\n\t"
-		       :[eax]"=a"(c_eax),[ebx]"=r"(c_ebx),[ecx]"=c"(c_ecx),[edx]"=d"(c_edx) :"a"(op) : "cc" );
+		       :[eax]"=a"(c_eax),[ebx]"=r"(c_ebx),[ecx]"=c"(c_ecx),[edx]"=d"(c_edx) :"a"(op), "c"(0) : "cc" );
 #endif
   *out_eax = c_eax, *out_ebx = c_ebx, *out_ecx = c_ecx, *out_edx = c_edx;
 #endif
@@ -216,7 +242,7 @@ uint32_t FV3_(utils)::getSIMDFlag()
     {
       uint32_t k[2] = {0,0,};
       XGETBV(0, &k[0], &k[1]);
-      if((k[0] & 0x6) == 0x6)
+      if((k[0] & FV3_X86SIMD_XCR0_AVX) == FV3_X86SIMD_XCR0_AVX)
 	{
 	  simdFlag |= FV3_X86SIMD_FLAG_AVX;
 	  if(j[3] & FV3_X86SIMD_CPUID_FMA3)
@@ -228,10 +254,83 @@ uint32_t FV3_(utils)::getSIMDFlag()
 	    {
 	      simdFlag |= FV3_X86SIMD_FLAG_FMA4;
 	    }
+	  cpuid(0x0,&j[1],&j[2],&j[3],&j[4]);
+	  if(j[1] >= 7)
+	    {
+	      cpuid(0x7,&j[1],&j[2],&j[3],&j[4]);
+	      if((j[2] & FV3_X86SIMD_CPUID_AVX2)&&(simdFlag & FV3_X86SIMD_FLAG_FMA3))
+		{
+		  simdFlag |= FV3_X86SIMD_FLAG_AVX2;
+		}
+	      if((j[2] & FV3_X86SIMD_CPUID_AVX512F)&&(k[0] & FV3_X86SIMD_XCR0_AVX512) == FV3_X86SIMD_XCR0_AVX512)
+		{
+		  simdFlag |= FV3_X86SIMD_FLAG_AVX512F;
+		}
+	    }
 	}
     }
+#endif
+#if defined(LIBFV3_FLOAT)||defined(LIBFV3_DOUBLE)
+  simdFlag |= FV3_SIMD_FLAG_VECTOR;
+#if defined(__aarch64__)&&defined(__ARM_NEON)
+  simdFlag |= FV3_SIMD_FLAG_NEON;
+#endif
 #endif
   return simdFlag;
 }
 
+// denormal protection
+
+FV3_(denormalguard)::FV3_(denormalguard)()
+{
+  mxcsr = 0; fpcr = 0; restore = false;
+#if defined(ENABLE_X86SIMD)
+  // getMXCSR()/setMXCSR() run cpuid and fxsave on every call, cache them.
+  static const bool sse = (FV3_(utils)::getSIMDFlag()&FV3_X86SIMD_FLAG_SSE) != 0;
+  static const uint32_t mask = sse ? FV3_(utils)::getMXCSR_MASK() : 0;
+  if(sse)
+    {
+      __asm__ __volatile__ ("stmxcsr %0" : "=m" (mxcsr));
+      uint32_t flush = (mxcsr|FV3_X86SIMD_MXCSR_FZ|FV3_X86SIMD_MXCSR_DAZ) & mask;
+      if(flush != mxcsr)
+	{
+	  __asm__ __volatile__ ("ldmxcsr %0" : : "m" (flush));
+	  restore = true;
+	}
+    }
+#elif defined(__SSE__)
+  // The compiler targets SSE (default on x86-64), DAZ is known to exist only with SSE3.
+  mxcsr = _mm_getcsr();
+#if defined(__SSE3__)
+  uint32_t flush = mxcsr|FV3_X86SIMD_MXCSR_FZ|FV3_X86SIMD_MXCSR_DAZ;
+#else
+  uint32_t flush = mxcsr|FV3_X86SIMD_MXCSR_FZ;
+#endif
+  if(flush != mxcsr)
+    {
+      _mm_setcsr(flush);
+      restore = true;
+    }
+#elif defined(__aarch64__)||(defined(__arm__)&&defined(__VFP_FP__)&&!defined(__SOFTFP__))
+  fpcr = FV3_(utils)::getFPCR();
+  if((fpcr & FV3_ARMSIMD_FPCR_FZ) == 0)
+    {
+      FV3_(utils)::setFPCR(fpcr|FV3_ARMSIMD_FPCR_FZ);
+      restore = true;
+    }
+#endif
+}
+
+FV3_(denormalguard)::FV3_(~denormalguard)()
+{
+  if(!restore) return;
+#if defined(ENABLE_X86SIMD)
+  __asm__ __volatile__ ("ldmxcsr %0" : : "m" (mxcsr));
+#elif defined(__SSE__)
+  _mm_setcsr(mxcsr);
+#elif defined(__aarch64__)||(defined(__arm__)&&defined(__VFP_FP__)&&!defined(__SOFTFP__))
+  FV3_(utils)::setFPCR(fpcr);
+#endif
+}
+
 #include "freeverb/fv3_ns_end.h"
@@ -25,6 +25,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <cmath>
+#include <limits>
 #include <new>
 #include <stdint.h>
 #include "freeverb/fv3_defs.h"
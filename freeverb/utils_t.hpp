@@ -35,7 +35,45 @@ class _FV3_(utils)
   static uint32_t getMXCSR();
   static uint32_t getMXCSR_MASK();
   static void     setMXCSR(uint32_t mxcsr);
+  static uint64_t getFPCR();
+  static void     setFPCR(uint64_t fpcr);
   static void cpuid(uint32_t op, uint32_t *_eax, uint32_t *_ebx, uint32_t *_ecx, uint32_t *_edx);
   static void XGETBV(uint32_t op, uint32_t * _eax, uint32_t *_edx);
   static uint32_t getSIMDFlag();
+
+  /**
+   * UNDENORMAL() without a branch, for the lane and block loops.
+   * @param[in] v The signal value.
+   * @return v, or 0 if v is denormal or not finite.
+   */
+  static inline _fv3_float_t undenormal(_fv3_float_t v)
+  {
+#ifdef DISABLE_UNDENORMAL
+    return v;
+#else
+    _fv3_float_t a = std::fabs(v);
+    return a >= std::numeric_limits<_fv3_float_t>::min()&&a <= std::numeric_limits<_fv3_float_t>::max() ? v : 0;
+#endif
+  }
+};
+
+/**
+ * Denormal protection scope guard.
+ * This enables the flush to zero mode of the FPU (MXCSR FTZ/DAZ on x86 SSE, FPCR FZ on ARM)
+ * and restores the previous mode on destruction. The processreplace() methods of the effects
+ * create this at their entry, so that the denormals produced in the tails are flushed by the hardware.
+ * The x87 FPU (long double) has no such mode, UNDENORMAL() is still required for it.
+ */
+class _FV3_(denormalguard)
+{
+ public:
+  _FV3_(denormalguard)();
+  _FV3_(~denormalguard)();
+
+ private:
+  _FV3_(denormalguard)(const _FV3_(denormalguard)& x);
+  _FV3_(denormalguard)& operator=(const _FV3_(denormalguard)& x);
+  uint32_t mxcsr;
+  uint64_t fpcr;
+  bool restore;
 };
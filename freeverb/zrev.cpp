@@ -23,6 +23,39 @@
 #include "freeverb/fv3_type_float.h"
 #include "freeverb/fv3_ns_start.h"
 
+// zrevlanes
+
+FV3_(zrevlanes)::FV3_(zrevlanes)()
+{
+  for(long i = 0;i < FV3_ZREV_NUM_DELAYS;i ++) b0[i] = b1[i] = b2[i] = a1[i] = a2[i] = 0;
+  mute();
+}
+
+void FV3_(zrevlanes)::setCoefficients(FV3_(biquad) * filters)
+{
+  for(long i = 0;i < FV3_ZREV_NUM_DELAYS;i ++)
+    {
+      b0[i] = filters[i].get_B0(), b1[i] = filters[i].get_B1(), b2[i] = filters[i].get_B2();
+      a1[i] = filters[i].get_A1(), a2[i] = filters[i].get_A2();
+    }
+}
+
+void FV3_(zrevlanes)::setCoefficients(FV3_(iir_1st) * filters)
+{
+  for(long i = 0;i < FV3_ZREV_NUM_DELAYS;i ++)
+    {
+      b0[i] = 0, b1[i] = filters[i].get_B1(), b2[i] = filters[i].get_B2();
+      a1[i] = 0, a2[i] = filters[i].get_A2();
+    }
+}
+
+void FV3_(zrevlanes)::mute()
+{
+  for(long i = 0;i < FV3_ZREV_NUM_DELAYS;i ++) i1[i] = i2[i] = o1[i] = o2[i] = 0;
+}
+
+// zrev
+
 // [s] ~70[m]
 const fv3_float_t FV3_(zrev)::delayLengthReal[] = { .153129, .210389, .127837, .256891, .174713, .192303, .125000, .219991, };
 const fv3_float_t FV3_(zrev)::delayLengthDiff[] = { .020346, .024421, .031604, .027333, .022904, .029291, .013458, .019123, };
@@ -45,6 +78,7 @@ void FV3_(zrev)::mute()
 {
   FV3_(revbase)::mute();
   for(long i = 0;i < FV3_ZREV_NUM_DELAYS;i ++){ _diff1[i].mute(); _delay[i].mute(); _filt1[i].mute(); }
+  _filt1Lanes.mute();
   lfo1.mute(); lfo2.mute(); lfo1_lpf.mute(); lfo2_lpf.mute();
   dccutL.mute(), dccutR.mute(); out1_lpf.mute(); out2_lpf.mute(); out1_hpf.mute(); out2_hpf.mute();
 }
@@ -52,6 +86,7 @@ void FV3_(zrev)::mute()
 void FV3_(zrev)::processreplace(fv3_float_t *inputL, fv3_float_t *inputR, fv3_float_t *outputL, fv3_float_t *outputR, long numsamples)
 		    
 {
+  FV3_(denormalguard) guard;
   if(numsamples <= 0) return;
   long count = numsamples*getOSFactor();
   try{growWave(count);}catch(std::bad_alloc){throw;}
@@ -60,6 +95,10 @@ void FV3_(zrev)::processreplace(fv3_float_t *inputL, fv3_float_t *inputR, fv3_fl
   SRC.usrc(inputL, inputR, over.L, over.R, numsamples);
   inputL = over.L; inputR = over.R; outputL = overO.L; outputR = overO.R;
 
+  // lane input signs and the delay feedback, the lanes 0-3 take L and 4-7 take R.
+  const fv3_float_t sign[FV3_ZREV_NUM_DELAYS] = { 1, 1, -1, -1, 1, 1, -1, -1, };
+  loadLanes();
+
   while(count-- > 0)
     {
       fv3_float_t lfo1q = lfo1_lpf(lfo1()*lfofactor);
@@ -68,43 +107,20 @@ void FV3_(zrev)::processreplace(fv3_float_t *inputL, fv3_float_t *inputR, fv3_fl
       // if(lfo2q < -1.) lfo2q = -1.; if(lfo2q > 1.) lfo2q = 1.;
       fv3_float_t lfo1p = -1 * lfo1q;
       fv3_float_t lfo2p = -1 * lfo2q;
+      const fv3_float_t diffMod[FV3_ZREV_NUM_DELAYS] = { lfo1q, lfo1p, lfo1q, lfo1p, lfo2p, lfo2q, lfo2p, lfo2q, };
+      const fv3_float_t delayMod[FV3_ZREV_NUM_DELAYS] = { lfo2q, lfo1q, lfo2p, lfo1p, lfo1p, lfo2q, lfo1p, lfo2p, };
+
+      fv3_float_t tL = dccutL(*inputL), tR = dccutR(*inputR);
+      fv3_float_t x[FV3_ZREV_NUM_DELAYS], y[FV3_ZREV_NUM_DELAYS];
+      for(long i = 0;i < FV3_ZREV_NUM_DELAYS;i ++) y[i] = laneDZ[i] + sign[i] * (i < FV3_ZREV_NUM_DELAYS/2 ? tL : tR);
+      processLaneAllpass(y, diffMod, x);
+      FV3_(zrevlanes)::hadamard(x);
+      for(long i = 0;i < FV3_ZREV_NUM_DELAYS;i ++) y[i] = x[i];
+      _filt1Lanes.processIIR1(y);
+      processLaneDelay(y, delayMod);
 
-      fv3_float_t t, x0, x1, x2, x3, x4, x5, x6, x7;
-      t = dccutL(*inputL);
-      x0 = _diff1[0]._process(_delay[0]._getlast() + t, lfo1q);
-      x1 = _diff1[1]._process(_delay[1]._getlast() + t, lfo1p);
-      x2 = _diff1[2]._process(_delay[2]._getlast() - t, lfo1q);
-      x3 = _diff1[3]._process(_delay[3]._getlast() - t, lfo1p);
-      t = dccutR(*inputR);
-      x4 = _diff1[4]._process(_delay[4]._getlast() + t, lfo2p);
-      x5 = _diff1[5]._process(_delay[5]._getlast() + t, lfo2q);
-      x6 = _diff1[6]._process(_delay[6]._getlast() - t, lfo2p);
-      x7 = _diff1[7]._process(_delay[7]._getlast() - t, lfo2q);
-      
-      t = x0 - x1; x0 += x1;  x1 = t;
-      t = x2 - x3; x2 += x3;  x3 = t;
-      t = x4 - x5; x4 += x5;  x5 = t;
-      t = x6 - x7; x6 += x7;  x7 = t;
-      t = x0 - x2; x0 += x2;  x2 = t;
-      t = x1 - x3; x1 += x3;  x3 = t;
-      t = x4 - x6; x4 += x6;  x6 = t;
-      t = x5 - x7; x5 += x7;  x7 = t;
-      t = x0 - x4; x0 += x4;  x4 = t;
-      t = x1 - x5; x1 += x5;  x5 = t;
-      t = x2 - x6; x2 += x6;  x6 = t;
-      t = x3 - x7; x3 += x7;  x7 = t;
-      
-      _delay[0]._process(_filt1[0](x0), lfo2q);
-      _delay[1]._process(_filt1[1](x1), lfo1q);
-      _delay[2]._process(_filt1[2](x2), lfo2p);
-      _delay[3]._process(_filt1[3](x3), lfo1p);
-      _delay[4]._process(_filt1[4](x4), lfo1p);
-      _delay[5]._process(_filt1[5](x5), lfo2q);
-      _delay[6]._process(_filt1[6](x6), lfo1p);
-      _delay[7]._process(_filt1[7](x7), lfo2p);
-
-      outL = 0.3*(x1 + x2);
-      outR = 0.3*(x1 - x2);
+      outL = 0.3*(x[1] + x[2]);
+      outR = 0.3*(x[1] - x[2]);
       // Original Ambisonic 4ch output
       // q0 [i] = _g0 * x0;
       // q1 [i] = _g1 * x1;
@@ -121,9 +137,24 @@ void FV3_(zrev)::processreplace(fv3_float_t *inputL, fv3_float_t *inputR, fv3_fl
       UNDENORMAL(*outputL); UNDENORMAL(*outputR);
       inputL ++; inputR ++; outputL ++; outputR ++;
     }
+  storeLanes();
   SRC.dsrc(overO.L, overO.R, origOutL, origOutR, numsamples);
 }
 
+void FV3_(zrev)::loadLanes()
+{
+  for(long i = 0;i < FV3_ZREV_NUM_DELAYS;i ++)
+    {
+      laneDZ[i] = _delay[i]._getlast(), laneDM[i] = (fv3_float_t)_delay[i].getmodulationsize(), laneDF[i] = _delay[i].getfeedback();
+      laneAZ[i] = _diff1[i]._getlast(), laneAM[i] = (fv3_float_t)_diff1[i].getmodulationsize(), laneAF[i] = _diff1[i]._getfeedback();
+    }
+}
+
+void FV3_(zrev)::storeLanes()
+{
+  for(long i = 0;i < FV3_ZREV_NUM_DELAYS;i ++){ _delay[i]._setlast(laneDZ[i]); _diff1[i]._setlast(laneAZ[i]); }
+}
+
 void FV3_(zrev)::setrt60(fv3_float_t value)
 {
   rt60 = value;
@@ -161,6 +192,7 @@ void FV3_(zrev)::setloopdamp(fv3_float_t value)
 {
   loopdamp = limFs2(value);
   for(long i = 0;i < FV3_ZREV_NUM_DELAYS;i ++) _filt1[i].setLPF_BW(loopdamp, getTotalSampleRate());
+  _filt1Lanes.setCoefficients(_filt1);
 }
 
 fv3_float_t FV3_(zrev)::getloopdamp()
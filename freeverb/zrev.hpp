@@ -22,10 +22,13 @@
 #ifndef _FV3_ZREV_HPP
 #define _FV3_ZREV_HPP
 
+#include <cmath>
+
 #include "freeverb/revbase.hpp"
 #include "freeverb/comb.hpp"
 #include "freeverb/allpass.hpp"
 #include "freeverb/efilter.hpp"
+#include "freeverb/biquad.hpp"
 #include "freeverb/fv3_defs.h"
 
 #define FV3_ZREV_NUM_DELAYS 8
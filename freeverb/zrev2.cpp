@@ -46,6 +46,7 @@ void FV3_(zrev2)::mute()
 {
   FV3_(zrev)::mute();
   for(long i = 0;i < FV3_ZREV_NUM_DELAYS;i ++){ _lsf0[i].mute(); _hsf0[i].mute(); }
+  _lsf0Lanes.mute(); _hsf0Lanes.mute();
   for(long i = 0;i < FV3_ZREV2_NUM_IALLPASS;i ++){ iAllpassL[i].mute(); iAllpassR[i].mute(); }
   spin1_lfo.mute(); spin1_lpf.mute(); spincombl.mute(); spincombr.mute();
 }
@@ -53,6 +54,7 @@ void FV3_(zrev2)::mute()
 void FV3_(zrev2)::processreplace(fv3_float_t *inputL, fv3_float_t *inputR, fv3_float_t *outputL, fv3_float_t *outputR, long numsamples)
 		 
 {
+  FV3_(denormalguard) guard;
   switch(reverbType)
     {
     case FV3_REVTYPE_ZREV:
@@ -72,6 +74,9 @@ void FV3_(zrev2)::processreplace(fv3_float_t *inputL, fv3_float_t *inputR, fv3_f
   SRC.usrc(inputL, inputR, over.L, over.R, numsamples);
   inputL = over.L; inputR = over.R; outputL = overO.L; outputR = overO.R;
 
+  const fv3_float_t sign[FV3_ZREV_NUM_DELAYS] = { 1, 1, -1, -1, 1, 1, -1, -1, };
+  loadLanes();
+
   while(count-- > 0)
     {
       fv3_float_t lfo1q = lfo1_lpf(lfo1()*lfofactor);
@@ -80,6 +85,8 @@ void FV3_(zrev2)::processreplace(fv3_float_t *inputL, fv3_float_t *inputR, fv3_f
       // if(lfo2q < -1.) lfo2q = -1.; if(lfo2q > 1.) lfo2q = 1.;
       fv3_float_t lfo1p = -1 * lfo1q;
       fv3_float_t lfo2p = -1 * lfo2q;
+      const fv3_float_t diffMod[FV3_ZREV_NUM_DELAYS] = { lfo1q, lfo1p, lfo1q, lfo1p, lfo2p, lfo2q, lfo2p, lfo2q, };
+      const fv3_float_t delayMod[FV3_ZREV_NUM_DELAYS] = { lfo2q, lfo1q, lfo2p, lfo1p, lfo1p, lfo2q, lfo1p, lfo2q, };
 
       outL = dccutL(*inputL); outR = dccutR(*inputR);
 
@@ -92,42 +99,16 @@ void FV3_(zrev2)::processreplace(fv3_float_t *inputL, fv3_float_t *inputR, fv3_f
           i_sign *= -1;
         }
 
-      fv3_float_t t, x0, x1, x2, x3, x4, x5, x6, x7;
-      t = outL;
-      x0 = _diff1[0]._process(_lsf0[0](_hsf0[0](_delay[0]._getlast() + t)), lfo1q);
-      x1 = _diff1[1]._process(_lsf0[1](_hsf0[1](_delay[1]._getlast() + t)), lfo1p);
-      x2 = _diff1[2]._process(_lsf0[2](_hsf0[2](_delay[2]._getlast() - t)), lfo1q);
-      x3 = _diff1[3]._process(_lsf0[3](_hsf0[3](_delay[3]._getlast() - t)), lfo1p);
-      t = outR;
-      x4 = _diff1[4]._process(_lsf0[4](_hsf0[4](_delay[4]._getlast() + t)), lfo2p);
-      x5 = _diff1[5]._process(_lsf0[5](_hsf0[5](_delay[5]._getlast() + t)), lfo2q);
-      x6 = _diff1[6]._process(_lsf0[6](_hsf0[6](_delay[6]._getlast() - t)), lfo2p);
-      x7 = _diff1[7]._process(_lsf0[7](_hsf0[7](_delay[7]._getlast() - t)), lfo2q);
-      
-      t = x0 - x1; x0 += x1;  x1 = t;
-      t = x2 - x3; x2 += x3;  x3 = t;
-      t = x4 - x5; x4 += x5;  x5 = t;
-      t = x6 - x7; x6 += x7;  x7 = t;
-      t = x0 - x2; x0 += x2;  x2 = t;
-      t = x1 - x3; x1 += x3;  x3 = t;
-      t = x4 - x6; x4 += x6;  x6 = t;
-      t = x5 - x7; x5 += x7;  x7 = t;
-      t = x0 - x4; x0 += x4;  x4 = t;
-      t = x1 - x5; x1 += x5;  x5 = t;
-      t = x2 - x6; x2 += x6;  x6 = t;
-      t = x3 - x7; x3 += x7;  x7 = t;
-
-      _delay[0]._process(x0, lfo2q);
-      _delay[1]._process(x1, lfo1q);
-      _delay[2]._process(x2, lfo2p);
-      _delay[3]._process(x3, lfo1p);
-      _delay[4]._process(x4, lfo1p);
-      _delay[5]._process(x5, lfo2q);
-      _delay[6]._process(x6, lfo1p);
-      _delay[7]._process(x7, lfo2q);
-
-      outL = .2*(x0 - x1 + x2 - x3);
-      outR = .2*(x4 + x5 - x6 - x7);
+      fv3_float_t x[FV3_ZREV_NUM_DELAYS], y[FV3_ZREV_NUM_DELAYS];
+      for(long i = 0;i < FV3_ZREV_NUM_DELAYS;i ++) y[i] = laneDZ[i] + sign[i] * (i < FV3_ZREV_NUM_DELAYS/2 ? outL : outR);
+      _hsf0Lanes.processBiquad(y);
+      _lsf0Lanes.processBiquad(y);
+      processLaneAllpass(y, diffMod, x);
+      FV3_(zrevlanes)::hadamard(x);
+      processLaneDelay(x, delayMod);
+
+      outL = .2*(x[0] - x[1] + x[2] - x[3]);
+      outR = .2*(x[4] + x[5] - x[6] - x[7]);
 
       fv3_float_t spinlfo = spin1_lpf(spin1_lfo()*spin_factor);
       outL = spincombl._process_ff(outL, spinlfo);
@@ -140,6 +121,7 @@ void FV3_(zrev2)::processreplace(fv3_float_t *inputL, fv3_float_t *inputR, fv3_f
       UNDENORMAL(*outputL); UNDENORMAL(*outputR);
       inputL ++; inputR ++; outputL ++; outputR ++;
     }
+  storeLanes();
   SRC.dsrc(overO.L, overO.R, origOutL, origOutR, numsamples);
 }
 
@@ -161,6 +143,8 @@ void FV3_(zrev2)::setrt60(fv3_float_t value)
 							  / back / rt60_f_high * (1 - rt60_f_high))),
 			  1, getTotalSampleRate());
     }
+  _lsf0Lanes.setCoefficients(_lsf0);
+  _hsf0Lanes.setCoefficients(_hsf0);
 }
 
 void FV3_(zrev2)::setrt60_factor_low(fv3_float_t gain)
@@ -70,7 +70,9 @@ public:
   _FV3_(zrev2)& operator=(const _FV3_(zrev2)& x);
   virtual void setFsFactors();
   _fv3_float_t rt60_f_low, rt60_f_high, rt60_xo_low, rt60_xo_high, idiff1, wander_ms, spin_fq, spin_factor;
+  // _lsf0/_hsf0 compute the coefficients, _lsf0Lanes/_hsf0Lanes run them
   _FV3_(biquad) _lsf0[FV3_ZREV_NUM_DELAYS], _hsf0[FV3_ZREV_NUM_DELAYS];
+  _FV3_(zrevlanes) _lsf0Lanes, _hsf0Lanes;
   _FV3_(allpassm) iAllpassL[FV3_ZREV2_NUM_IALLPASS], iAllpassR[FV3_ZREV2_NUM_IALLPASS];
   _FV3_(lfo) spin1_lfo; _FV3_(iir_1st) spin1_lpf;
   const static long iAllpassLCo[FV3_ZREV2_NUM_IALLPASS], iAllpassRCo[FV3_ZREV2_NUM_IALLPASS], allpM_EXCURSION;
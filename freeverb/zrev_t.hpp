@@ -19,6 +19,65 @@
  *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
  */
 
+/**
+ * The filters of the FV3_ZREV_NUM_DELAYS lanes of the FDN as a structure of arrays,
+ * all lanes of one sample are filtered by vector operations.
+ * The coefficients are copied from the biquad/iir_1st objects which compute them.
+ */
+class _FV3_(zrevlanes)
+{
+ public:
+  _FV3_(zrevlanes)();
+  void setCoefficients(_FV3_(biquad) * filters);
+  void setCoefficients(_FV3_(iir_1st) * filters);
+  void mute();
+
+  // iir_1st::processd1() of all lanes
+  inline void processIIR1(_fv3_float_t * x)
+  {
+    for(long i = 0;i < FV3_ZREV_NUM_DELAYS;i ++)
+      {
+        _fv3_float_t output = _FV3_(utils)::undenormal(x[i] * b1[i] + o1[i]);
+        o1[i] = _FV3_(utils)::undenormal(output * a2[i] + x[i] * b2[i]);
+        x[i] = output;
+      }
+  }
+
+  // biquad::processd1() of all lanes
+  inline void processBiquad(_fv3_float_t * x)
+  {
+    for(long i = 0;i < FV3_ZREV_NUM_DELAYS;i ++)
+      {
+        _fv3_float_t i0 = x[i], output = x[i] * b0[i];
+        output += b1[i] * i1[i] + b2[i] * i2[i];
+        output -= a1[i] * o1[i] + a2[i] * o2[i];
+        output = _FV3_(utils)::undenormal(output);
+        i2[i] = i1[i]; i1[i] = i0;
+        o2[i] = o1[i]; o1[i] = output;
+        x[i] = output;
+      }
+  }
+
+  // the 8 point Hadamard transform (unnormalized)
+  static inline void hadamard(_fv3_float_t * x)
+  {
+    for(long s = 1;s < FV3_ZREV_NUM_DELAYS;s *= 2)
+      {
+        _fv3_float_t y[FV3_ZREV_NUM_DELAYS];
+        for(long i = 0;i < FV3_ZREV_NUM_DELAYS;i ++)
+          y[i] = (i & s) == 0 ? x[i] + x[i+s] : x[i-s] - x[i];
+        for(long i = 0;i < FV3_ZREV_NUM_DELAYS;i ++) x[i] = y[i];
+      }
+  }
+
+  _fv3_float_t b0[FV3_ZREV_NUM_DELAYS], b1[FV3_ZREV_NUM_DELAYS], b2[FV3_ZREV_NUM_DELAYS], a1[FV3_ZREV_NUM_DELAYS], a2[FV3_ZREV_NUM_DELAYS];
+  _fv3_float_t i1[FV3_ZREV_NUM_DELAYS], i2[FV3_ZREV_NUM_DELAYS], o1[FV3_ZREV_NUM_DELAYS], o2[FV3_ZREV_NUM_DELAYS];
+
+ private:
+  _FV3_(zrevlanes)(const _FV3_(zrevlanes)& x);
+  _FV3_(zrevlanes)& operator=(const _FV3_(zrevlanes)& x);
+};
+
 class _FV3_(zrev) : public _FV3_(revbase)
 {
 public:
@@ -52,12 +111,56 @@ public:
   _FV3_(zrev)(const _FV3_(zrev)& x);
   _FV3_(zrev)& operator=(const _FV3_(zrev)& x);
   virtual void setFsFactors();
+  // The FDN state of all lanes is held in the lane arrays while a block runs.
+  // Only the delay line reads and writes are done lane by lane.
+  void loadLanes();
+  void storeLanes();
+  inline void processLaneAllpass(const _fv3_float_t * input, const _fv3_float_t * modulation, _fv3_float_t * output)
+  {
+    _fv3_float_t a[FV3_ZREV_NUM_DELAYS], b[FV3_ZREV_NUM_DELAYS], frac[FV3_ZREV_NUM_DELAYS], w[FV3_ZREV_NUM_DELAYS];
+    long floor_mod[FV3_ZREV_NUM_DELAYS];
+    for(long i = 0;i < FV3_ZREV_NUM_DELAYS;i ++)
+      {
+        _fv3_float_t m = (modulation[i] + 1.) * laneAM[i], f = std::floor(m);
+        frac[i] = 1. - (m - f), floor_mod[i] = (long)f;
+      }
+    for(long i = 0;i < FV3_ZREV_NUM_DELAYS;i ++) _diff1[i]._tap(floor_mod[i], a[i], b[i]);
+    for(long i = 0;i < FV3_ZREV_NUM_DELAYS;i ++)
+      {
+        _fv3_float_t z = laneAZ[i] = _FV3_(utils)::undenormal(b[i] + frac[i] * (a[i] - laneAZ[i]));
+        w[i] = input[i] + z * laneAF[i];
+        output[i] = z - w[i] * laneAF[i];
+      }
+    for(long i = 0;i < FV3_ZREV_NUM_DELAYS;i ++) _diff1[i]._write(w[i]);
+  }
+  inline void processLaneDelay(const _fv3_float_t * input, const _fv3_float_t * modulation)
+  {
+    _fv3_float_t a[FV3_ZREV_NUM_DELAYS], b[FV3_ZREV_NUM_DELAYS], frac[FV3_ZREV_NUM_DELAYS], w[FV3_ZREV_NUM_DELAYS];
+    long floor_mod[FV3_ZREV_NUM_DELAYS];
+    for(long i = 0;i < FV3_ZREV_NUM_DELAYS;i ++)
+      {
+        _fv3_float_t m = (modulation[i] + 1.) * laneDM[i], f = std::floor(m);
+        frac[i] = 1. - (m - f), floor_mod[i] = (long)f;
+      }
+    for(long i = 0;i < FV3_ZREV_NUM_DELAYS;i ++) _delay[i]._tap(floor_mod[i], a[i], b[i]);
+    for(long i = 0;i < FV3_ZREV_NUM_DELAYS;i ++)
+      {
+        laneDZ[i] = _FV3_(utils)::undenormal(b[i] + frac[i] * (a[i] - laneDZ[i]));
+        w[i] = laneDF[i] * input[i];
+      }
+    for(long i = 0;i < FV3_ZREV_NUM_DELAYS;i ++) _delay[i]._write(w[i]);
+  }
 
   _fv3_float_t rt60, apfeedback, loopdamp, outputlpf, outputhpf, dccutfq;
   _FV3_(allpassm) _diff1[FV3_ZREV_NUM_DELAYS];
   _FV3_(delaym) _delay[FV3_ZREV_NUM_DELAYS];
   _FV3_(dccut) dccutL, dccutR;
+  // _filt1 computes the coefficients, _filt1Lanes runs them
   _FV3_(iir_1st) _filt1[FV3_ZREV_NUM_DELAYS], out1_lpf, out2_lpf, out1_hpf, out2_hpf;
+  _FV3_(zrevlanes) _filt1Lanes;
+  // last outputs (Z), modulation sizes (M) and feedbacks (F) of _delay (D) and _diff1 (A)
+  _fv3_float_t laneDZ[FV3_ZREV_NUM_DELAYS], laneDM[FV3_ZREV_NUM_DELAYS], laneDF[FV3_ZREV_NUM_DELAYS];
+  _fv3_float_t laneAZ[FV3_ZREV_NUM_DELAYS], laneAM[FV3_ZREV_NUM_DELAYS], laneAF[FV3_ZREV_NUM_DELAYS];
   _fv3_float_t  lfo1freq, lfo2freq, lfofactor;
   _FV3_(lfo) lfo1, lfo2;
   _FV3_(iir_1st) lfo1_lpf, lfo2_lpf;
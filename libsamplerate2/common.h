@@ -35,6 +35,10 @@ typedef struct SR2_(SRC_PRIVATE_tag)
   long (*const_process) (struct SR2_(SRC_PRIVATE_tag) *psrc, SR2_(SRC_DATA) *data) ;
 
   void (*reset) (struct SR2_(SRC_PRIVATE_tag) *psrc) ;
+  /* Prepares the converter for a constant ratio, called by src_set_ratio(), may be NULL. */
+  void (*set_ratio) (struct SR2_(SRC_PRIVATE_tag) *psrc, double new_ratio) ;
+  /* Frees the converter data owned by private_data, may be NULL. */
+  void (*close) (struct SR2_(SRC_PRIVATE_tag) *psrc) ;
   /* Data specific to SRC_MODE_CALLBACK. */
   SR2_(src_callback_t)	callback_func ;
   void *user_callback_data ;
@@ -91,6 +91,7 @@ SR2_(SRC_STATE) * SR2_(src_delete) (SR2_(SRC_STATE) *state)
   psrc = (SR2_(SRC_PRIVATE)*)state;
   if(psrc)
     {
+      if(psrc->close) psrc->close (psrc);
       if(psrc->private_data) free (psrc->private_data);
       memset (psrc, 0, sizeof (SR2_(SRC_PRIVATE)));
       free(psrc);
@@ -266,6 +267,7 @@ long SR2_(src_set_ratio) (SR2_(SRC_STATE) *state, double new_ratio)
   if(is_bad_src_ratio (new_ratio)) return SRC_ERR_BAD_SRC_RATIO;
   
   psrc->last_ratio = new_ratio;
+  if(psrc->set_ratio != NULL) psrc->set_ratio (psrc, new_ratio);
   
   return SRC_ERR_NO_ERROR;
 }
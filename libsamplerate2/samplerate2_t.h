@@ -26,6 +26,7 @@ long _SR2_(src_callback_read) (_SR2_(SRC_STATE) *state, double src_ratio,
 			       long frames, _sr2_float_t *data);
 long _SR2_(src_simple) (_SR2_(SRC_DATA) *data, long converter_type,
 			long channels);
+/* The sinc converters also build the coefficient table of new_ratio, call it outside the processing. */
 long _SR2_(src_set_ratio) (_SR2_(SRC_STATE) *state, double new_ratio) ;
 long _SR2_(src_reset) (_SR2_(SRC_STATE) *state) ;
 long _SR2_(src_error) (_SR2_(SRC_STATE) *state) ;
@@ -16,6 +16,7 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
  */
 
+#include <float.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -32,6 +33,21 @@
 #define FP_ONE ((double) (((increment_t) 1) << SHIFT_BITS))
 #define INV_FP_ONE (1.0 / FP_ONE)
 
+/* Polyphase table of a constant rational ratio. The accumulator count must be
+** a multiple of the channel count for the table to be used.
+*/
+#define SINC_TABLE_MAX_PHASES 4096
+#define SINC_TABLE_MAX_SIZE (1 << 22)
+#define SINC_TABLE_ACC 8
+
+#if defined(LIBSRATE2_FLOAT)
+#define SINC_TABLE_EPSILON FLT_EPSILON
+#elif defined(LIBSRATE2_DOUBLE)
+#define SINC_TABLE_EPSILON DBL_EPSILON
+#else
+#define SINC_TABLE_EPSILON LDBL_EPSILON
+#endif
+
 typedef int32_t increment_t;
 typedef sr2_float_t coeff_t;
 
@@ -53,6 +69,16 @@ typedef struct
   long coeff_half_len, index_inc;
   double src_ratio, input_index;
   coeff_t const	*coeffs;
+
+  /* Interpolated coefficients of each phase of table_ratio in data order,
+  ** repeated for each channel. All phases are filled by src_set_ratio(),
+  ** the processing only reads them.
+  */
+  double table_ratio;
+  long table_phases, table_stride;
+  increment_t *table_start;
+  long *table_offset, *table_count;
+  coeff_t *table;
   
   long 	b_current, b_end, b_real_end, b_len;
 
@@ -163,6 +189,150 @@ static int SR2_(prepare_data)(SR2_(SINC_FILTER) * filter,
   return 0;
 }
 
+// polyphase table codes
+
+static void SR2_(sinc_free_table) (SR2_(SINC_FILTER) * filter)
+{
+  free (filter->table);
+  free (filter->table_start);
+  free (filter->table_offset);
+  free (filter->table_count);
+  filter->table = NULL;
+  filter->table_start = NULL;
+  filter->table_offset = filter->table_count = NULL;
+  filter->table_phases = filter->table_stride = 0;
+}
+
+static void SR2_(prepare_table) (SR2_(SINC_FILTER) * filter, sr2_float_t src_ratio)
+{
+  double step;
+  sr2_float_t float_increment;
+  long q, k, max_taps;
+  
+  if(filter->table_ratio == src_ratio) return;
+  SR2_(sinc_free_table) (filter);
+  filter->table_ratio = src_ratio;
+  if(SINC_TABLE_ACC % filter->channels != 0) return;
+  
+  /* The fractional input index of a ratio p/q only takes q values. */
+  step = 1.0 / src_ratio;
+  for(q = 1;q <= SINC_TABLE_MAX_PHASES;q ++)
+    if(fabs (step * q - rint (step * q)) <= 16 * SINC_TABLE_EPSILON * step * q) break;
+  if(q > SINC_TABLE_MAX_PHASES) return;
+
+  float_increment = filter->index_inc * 1.0;
+  if(src_ratio < 1.0) float_increment = filter->index_inc * src_ratio;
+  max_taps = 2 * (int_to_fp (filter->coeff_half_len) / double_to_fp (float_increment)) + 2;
+  filter->table_stride = (max_taps * filter->channels + SINC_TABLE_ACC - 1) / SINC_TABLE_ACC * SINC_TABLE_ACC;
+  if(q * filter->table_stride > SINC_TABLE_MAX_SIZE) return;
+
+  filter->table = malloc (q * filter->table_stride * sizeof (filter->table [0]));
+  filter->table_start = malloc (q * sizeof (filter->table_start [0]));
+  filter->table_offset = malloc (q * sizeof (filter->table_offset [0]));
+  filter->table_count = malloc (q * sizeof (filter->table_count [0]));
+  if(filter->table == NULL || filter->table_start == NULL || filter->table_offset == NULL || filter->table_count == NULL)
+    {
+      SR2_(sinc_free_table) (filter);
+      return;
+    }
+  for(k = 0;k < q;k ++) filter->table_start [k] = -1;
+  filter->table_phases = q;
+}
+
+/* Keeps the input index of the table ratio on its rational grid, so that the
+** phases are reused instead of drifting with the rounding errors of the steps.
+** The fraction is snapped again after fmod_one(), so it is exactly the k/q of
+** the phase which sinc_set_ratio() has filled.
+*/
+static inline sr2_float_t
+SR2_(table_index) (SR2_(SINC_FILTER) *filter, sr2_float_t src_ratio, sr2_float_t input_index)
+{
+  if(filter->table_phases == 0 || filter->table_ratio != src_ratio) return input_index;
+  return (sr2_float_t) (rint (input_index * filter->table_phases) / filter->table_phases);
+}
+
+/* Same taps as calc_output_single, left half then right half in data order. */
+static void
+SR2_(fill_table_phase) (SR2_(SINC_FILTER) *filter, long phase, increment_t increment, increment_t start_filter_index)
+{	sr2_float_t		fraction, icoeff ;
+	increment_t	filter_index, max_filter_index ;
+	int			coeff_count, indx ;
+	long		ch, count = 0 ;
+	coeff_t		*table = filter->table + phase * filter->table_stride ;
+
+	max_filter_index = int_to_fp (filter->coeff_half_len) ;
+
+	filter_index = start_filter_index ;
+	coeff_count = (max_filter_index - filter_index) / increment ;
+	filter_index = filter_index + coeff_count * increment ;
+	filter->table_offset [phase] = - coeff_count ;
+
+	do
+	{	fraction = fp_to_double (filter_index) ;
+		indx = fp_to_int (filter_index) ;
+		icoeff = filter->coeffs [indx] + fraction * (filter->coeffs [indx + 1] - filter->coeffs [indx]) ;
+		for (ch = 0 ; ch < filter->channels ; ch ++)
+			table [count ++] = icoeff ;
+		filter_index -= increment ;
+		}
+	while (filter_index >= MAKE_INCREMENT_T (0)) ;
+
+	filter_index = increment - start_filter_index ;
+	do
+	{	fraction = fp_to_double (filter_index) ;
+		indx = fp_to_int (filter_index) ;
+		icoeff = filter->coeffs [indx] + fraction * (filter->coeffs [indx + 1] - filter->coeffs [indx]) ;
+		for (ch = 0 ; ch < filter->channels ; ch ++)
+			table [count ++] = icoeff ;
+		filter_index += increment ;
+		}
+	while (filter_index <= max_filter_index) ;
+
+	filter->table_count [phase] = count ;
+	filter->table_start [phase] = start_filter_index ;
+} /* fill_table_phase */
+
+/* Returns 0 if the output must be computed by the interpolating path.
+** The taps of all channels are one contiguous multiply-add with independent
+** accumulators, so it is vectorized without reordering the sums.
+*/
+static inline int
+SR2_(calc_output_table) (SR2_(SINC_FILTER) *filter, sr2_float_t src_ratio, sr2_float_t input_index,
+			 increment_t increment, increment_t start_filter_index, sr2_float_t scale, sr2_float_t * output)
+{	sr2_float_t	acc [SINC_TABLE_ACC], sum ;
+	const coeff_t	*table ;
+	const sr2_float_t *data ;
+	long		phase, count, i, k, ch ;
+
+	if (filter->table_phases == 0 || filter->table_ratio != src_ratio)
+		return 0 ;
+
+	phase = lrint (input_index * filter->table_phases) % filter->table_phases ;
+	if (filter->table_start [phase] != start_filter_index)
+		return 0 ;
+
+	table = filter->table + phase * filter->table_stride ;
+	data = filter->buffer + filter->b_current + filter->channels * filter->table_offset [phase] ;
+	count = filter->table_count [phase] ;
+
+	for (k = 0 ; k < SINC_TABLE_ACC ; k ++)
+		acc [k] = 0.0 ;
+	for (i = 0 ; i + SINC_TABLE_ACC <= count ; i += SINC_TABLE_ACC)
+		for (k = 0 ; k < SINC_TABLE_ACC ; k ++)
+			acc [k] += table [i + k] * data [i + k] ;
+	for (k = 0 ; i < count ; i ++, k ++)
+		acc [k] += table [i] * data [i] ;
+
+	for (ch = 0 ; ch < filter->channels ; ch ++)
+	{	sum = 0.0 ;
+		for (k = ch ; k < SINC_TABLE_ACC ; k += filter->channels)
+			sum += acc [k] ;
+		output [ch] = scale * sum ;
+		} ;
+
+	return 1 ;
+} /* calc_output_table */
+
 // main src codes
 
 static inline sr2_float_t
@@ -288,16 +458,18 @@ SR2_(sinc_mono_vari_process) (SR2_(SRC_PRIVATE) *psrc, SR2_(SRC_DATA) *data)
 
 		start_filter_index = double_to_fp (input_index * float_increment) ;
 
-		data->data_out [filter->out_gen] = (sr2_float_t) ((float_increment / filter->index_inc) *
-							    SR2_(calc_output_single) (filter, increment, start_filter_index)) ;
+		if (! SR2_(calc_output_table) (filter, src_ratio, input_index, increment, start_filter_index,
+					       float_increment / filter->index_inc, data->data_out + filter->out_gen))
+			data->data_out [filter->out_gen] = (sr2_float_t) ((float_increment / filter->index_inc) *
+								    SR2_(calc_output_single) (filter, increment, start_filter_index)) ;
 		filter->out_gen ++ ;
 
 		/* Figure out the next index. */
-		input_index += 1.0 / src_ratio ;
+		input_index = SR2_(table_index) (filter, src_ratio, input_index + 1.0 / src_ratio) ;
 		rem = SR2_(fmod_one) (input_index) ;
 
 		filter->b_current = (filter->b_current + filter->channels * lrint (input_index - rem)) % filter->b_len ;
-		input_index = rem ;
+		input_index = SR2_(table_index) (filter, src_ratio, rem) ;
 		} ;
 
 	psrc->last_position = input_index ;
@@ -437,15 +609,17 @@ SR2_(sinc_stereo_vari_process) (SR2_(SRC_PRIVATE) *psrc, SR2_(SRC_DATA) *data)
 
 		start_filter_index = double_to_fp (input_index * float_increment) ;
 
-		SR2_(calc_output_stereo) (filter, increment, start_filter_index, float_increment / filter->index_inc, data->data_out + filter->out_gen) ;
+		if (! SR2_(calc_output_table) (filter, src_ratio, input_index, increment, start_filter_index,
+					       float_increment / filter->index_inc, data->data_out + filter->out_gen))
+			SR2_(calc_output_stereo) (filter, increment, start_filter_index, float_increment / filter->index_inc, data->data_out + filter->out_gen) ;
 		filter->out_gen += 2 ;
 
 		/* Figure out the next index. */
-		input_index += 1.0 / src_ratio ;
+		input_index = SR2_(table_index) (filter, src_ratio, input_index + 1.0 / src_ratio) ;
 		rem = SR2_(fmod_one) (input_index) ;
 
 		filter->b_current = (filter->b_current + filter->channels * lrint (input_index - rem)) % filter->b_len ;
-		input_index = rem ;
+		input_index = SR2_(table_index) (filter, src_ratio, rem) ;
 		} ;
 
 	psrc->last_position = input_index ;
@@ -591,15 +765,17 @@ SR2_(sinc_quad_vari_process) (SR2_(SRC_PRIVATE) *psrc, SR2_(SRC_DATA) *data)
 
 		start_filter_index = double_to_fp (input_index * float_increment) ;
 
-		SR2_(calc_output_quad) (filter, increment, start_filter_index, float_increment / filter->index_inc, data->data_out + filter->out_gen) ;
+		if (! SR2_(calc_output_table) (filter, src_ratio, input_index, increment, start_filter_index,
+					       float_increment / filter->index_inc, data->data_out + filter->out_gen))
+			SR2_(calc_output_quad) (filter, increment, start_filter_index, float_increment / filter->index_inc, data->data_out + filter->out_gen) ;
 		filter->out_gen += 4 ;
 
 		/* Figure out the next index. */
-		input_index += 1.0 / src_ratio ;
+		input_index = SR2_(table_index) (filter, src_ratio, input_index + 1.0 / src_ratio) ;
 		rem = SR2_(fmod_one) (input_index) ;
 
 		filter->b_current = (filter->b_current + filter->channels * lrint (input_index - rem)) % filter->b_len ;
-		input_index = rem ;
+		input_index = SR2_(table_index) (filter, src_ratio, rem) ;
 		} ;
 
 	psrc->last_position = input_index ;
@@ -998,15 +1174,17 @@ SR2_(sinc_multichan_vari_process) (SR2_(SRC_PRIVATE) *psrc, SR2_(SRC_DATA) *data
 
 		start_filter_index = double_to_fp (input_index * float_increment) ;
 
-		SR2_(calc_output_multi) (filter, increment, start_filter_index, filter->channels, float_increment / filter->index_inc, data->data_out + filter->out_gen) ;
+		if (! SR2_(calc_output_table) (filter, src_ratio, input_index, increment, start_filter_index,
+					       float_increment / filter->index_inc, data->data_out + filter->out_gen))
+			SR2_(calc_output_multi) (filter, increment, start_filter_index, filter->channels, float_increment / filter->index_inc, data->data_out + filter->out_gen) ;
 		filter->out_gen += psrc->channels ;
 
 		/* Figure out the next index. */
-		input_index += 1.0 / src_ratio ;
+		input_index = SR2_(table_index) (filter, src_ratio, input_index + 1.0 / src_ratio) ;
 		rem = SR2_(fmod_one) (input_index) ;
 
 		filter->b_current = (filter->b_current + filter->channels * lrint (input_index - rem)) % filter->b_len ;
-		input_index = rem ;
+		input_index = SR2_(table_index) (filter, src_ratio, rem) ;
 		} ;
 
 	psrc->last_position = input_index ;
@@ -1022,6 +1200,34 @@ SR2_(sinc_multichan_vari_process) (SR2_(SRC_PRIVATE) *psrc, SR2_(SRC_DATA) *data
 
 // init codes
 
+static void SR2_(sinc_close) (SR2_(SRC_PRIVATE) *psrc)
+{
+  if(psrc->private_data != NULL) SR2_(sinc_free_table) ((SR2_(SINC_FILTER)*) psrc->private_data);
+}
+
+/* Builds the table of a constant ratio outside the processing.
+** The table is kept by reset, the other ratios are processed without it.
+*/
+static void SR2_(sinc_set_ratio) (SR2_(SRC_PRIVATE) *psrc, double new_ratio)
+{
+  SR2_(SINC_FILTER) *filter;
+  sr2_float_t src_ratio = new_ratio, float_increment, input_index;
+  long k;
+  
+  filter = (SR2_(SINC_FILTER)*) psrc->private_data;
+  if(filter == NULL || filter->table_ratio == src_ratio) return;
+  SR2_(prepare_table) (filter, src_ratio);
+  
+  /* the same increments as the processing loops */
+  float_increment = filter->index_inc * 1.0;
+  if(src_ratio < 1.0) float_increment = filter->index_inc * src_ratio;
+  for(k = 0;k < filter->table_phases;k ++)
+    {
+      input_index = (sr2_float_t) ((double) k / filter->table_phases);
+      SR2_(fill_table_phase) (filter, k, double_to_fp (float_increment), double_to_fp (input_index * float_increment));
+    }
+}
+
 static void SR2_(sinc_reset) (SR2_(SRC_PRIVATE) *psrc)
 {
   SR2_(SINC_FILTER) *filter;
@@ -1052,9 +1258,11 @@ long SR2_(sinc_set_converter) (SR2_(SRC_PRIVATE) *psrc, long src_enum)
   
   if(psrc->private_data != NULL)
     {
+      if(psrc->close != NULL) psrc->close (psrc);
       free (psrc->private_data);
       psrc->private_data = NULL;
     }
+  psrc->close = NULL;
   
   memset(&temp_filter, 0, sizeof (temp_filter));
 
@@ -1090,6 +1298,7 @@ long SR2_(sinc_set_converter) (SR2_(SRC_PRIVATE) *psrc, long src_enum)
     }
   
   psrc->reset = SR2_(sinc_reset);
+  psrc->set_ratio = SR2_(sinc_set_ratio);
   
   switch (src_enum)
     {
@@ -1147,6 +1356,7 @@ long SR2_(sinc_set_converter) (SR2_(SRC_PRIVATE) *psrc, long src_enum)
   memset (&temp_filter, 0xEE, sizeof (temp_filter));
   
   psrc->private_data = filter;
+  psrc->close = SR2_(sinc_close);
   
   SR2_(sinc_reset) (psrc);
   
@@ -31,6 +31,8 @@
 #include <freeverb/irmodel2.hpp>
 #include <freeverb/irmodel2zl.hpp>
 #include <freeverb/irmodel3.hpp>
+#include <freeverb/irmodel4.hpp>
+#include <freeverb/irmodel5.hpp>
 #ifdef ENABLE_PTHREAD
 #include <freeverb/irmodel3p.hpp>
 #endif
@@ -45,10 +47,13 @@ typedef fv3::irmodel1_ IR1;
 typedef fv3::irmodel2_ IR2;
 typedef fv3::irmodel2zl_ IR2ZL;
 typedef fv3::irmodel3_ IR3;
+typedef fv3::irmodel4_ IR4;
+typedef fv3::irmodel5_ IR5;
 #ifdef ENABLE_PTHREAD
 typedef fv3::irmodel3p_ IR3P;
 #endif
 typedef fv3::utils_ UTILS;
+typedef fv3::fftplan_ FFTPLAN;
 typedef double pfloat_t;
 #else
 typedef fv3::irbase_f IRBASE;
@@ -57,10 +62,13 @@ typedef fv3::irmodel1_f IR1;
 typedef fv3::irmodel2_f IR2;
 typedef fv3::irmodel2zl_f IR2ZL;
 typedef fv3::irmodel3_f IR3;
+typedef fv3::irmodel4_f IR4;
+typedef fv3::irmodel5_f IR5;
 #ifdef ENABLE_PTHREAD
 typedef fv3::irmodel3p_f IR3P;
 #endif
 typedef fv3::utils_f UTILS;
+typedef fv3::fftplan_f FFTPLAN;
 typedef float pfloat_t;
 #endif
 
@@ -73,6 +81,8 @@ long factor = 16;
 
 long processFrame = 1024;
 long frameCount = 1000;
+long threadCount = 1;
+long poolThreadCount = 0;
 
 static double loadIR(IRBASE *irm, long size, long fsize, long factor)
 {
@@ -83,7 +93,18 @@ static double loadIR(IRBASE *irm, long size, long fsize, long factor)
   
   IR2 *ir2 = dynamic_cast<IR2*>(irm);
   IR3 *ir3 = dynamic_cast<IR3*>(irm);
-  if(ir2 != NULL)
+  IR4 *ir4 = dynamic_cast<IR4*>(irm);
+  IR5 *ir5 = dynamic_cast<IR5*>(irm);
+  if(ir5 != NULL)
+    {
+      // the fragment size is selected by the cost model
+      std::fprintf(stderr, "IR5\n");
+      time_start = clock();
+      ir5->loadImpulse(irL,irR,size);
+      time_end = clock();
+      std::fprintf(stderr, "IR5 fragmentSize %ld\n", ir5->getFragmentSize());
+    }
+  else if(ir2 != NULL)
     {
       std::fprintf(stderr, "IR2\n");
       time_start = clock();
@@ -99,6 +120,15 @@ static double loadIR(IRBASE *irm, long size, long fsize, long factor)
       ir3->loadImpulse(irL,irR,size);
       time_end = clock();
     }
+  else if(ir4 != NULL)
+    {
+      std::fprintf(stderr, "IR4\n");
+      time_start = clock();
+      ir4->setFragmentSize(fsize,factor);
+      ir4->loadImpulse(irL,irR,size);
+      time_end = clock();
+      ir4->printconfig();
+    }
   else
     {
       time_start = clock();
@@ -112,6 +142,20 @@ static double loadIR(IRBASE *irm, long size, long fsize, long factor)
   return time_diff;
 }
 
+static double loadSpectra(IRBASE *irm, long size, const char * filename)
+{
+  clock_t time_start = 0, time_end = 0;
+  pfloat_t * irL = new pfloat_t[size]; UTILS::mute(irL, size);
+  pfloat_t * irR = new pfloat_t[size]; UTILS::mute(irR, size);
+  irm->saveSpectra(filename, irL, irR, size, 48000);
+  delete[] irL;
+  delete[] irR;
+  time_start = clock();
+  irm->loadSpectra(filename, 48000);
+  time_end = clock();
+  return (double)(time_end-time_start)/CLOCKS_PER_SEC;
+}
+
 static double process(IRBASE *irm, long fsize, long count, unsigned options)
 {
   clock_t time_start = 0, time_end = 0;
@@ -149,11 +193,19 @@ static void help(const char * cmd)
 #ifdef ENABLE_PTHREAD
                "\t6 irmodel3p  zero latency pthread\n"
 #endif
+               "\t7 irmodel4   zero latency non-uniform partitions\n"
+               "\t8 irmodel5   zero latency direct head + uniform partitions\n"
                "-ir impulseLength (480000)\n"
                "-fr fragmentSize (1024)\n"
                "-fa factor (16)\n"
                "-pf processFrame (1024)\n"
                "-fc frameCount (1000)\n"
+               "-w FFTW wisdom file (imported before and exported after the load)\n"
+               "-sp spectra file (saved and loaded after the load)\n"
+#ifdef ENABLE_PTHREAD
+               "-th threadCount of irmodel3p (1)\n"
+               "-tp threadCount of the shared thread pool (0=online processors)\n"
+#endif
                "\n",
                cmd);
 }
@@ -184,6 +236,14 @@ int main(int argc, char * argv[])
       ir = new IR3P();
       break;
 #endif
+    case 7:
+      std::fprintf(stderr, "MODEL = irmodel4\n");
+      ir = new IR4();
+      break;
+    case 8:
+      std::fprintf(stderr, "MODEL = irmodel5\n");
+      ir = new IR5();
+      break;
     case 4:
       std::fprintf(stderr, "MODEL = irmodels\n");
       ir = new IRS();
@@ -205,9 +265,26 @@ int main(int argc, char * argv[])
 
   if(args.getLong("-pf") > 0) processFrame = args.getLong("-pf");
   if(args.getLong("-fc") > 0) frameCount = args.getLong("-fc");
+#ifdef ENABLE_PTHREAD
+  if(args.getLong("-th") > 0) threadCount = args.getLong("-th");
+  if(args.getLong("-tp") > 0) poolThreadCount = args.getLong("-tp");
+  PthreadScheduler::instance().setThreadCount(poolThreadCount);
+  IR3P *ir3p = dynamic_cast<IR3P*>(ir);
+  if(ir3p != NULL)
+    {
+      ir3p->setThreadCount(threadCount);
+      std::fprintf(stderr, "threadCount = %ld/%ld\n", ir3p->getThreadCount(), PthreadScheduler::instance().getThreadCount());
+    }
+#endif
 
+  const char * wisdomFile = args.getString("-w");
+  if(std::strlen(wisdomFile) > 0) FFTPLAN::importWisdom(wisdomFile);
   std::fprintf(stderr, "loadIR( %ld %ld %ld )\n", impulseLength, fragmentSize, factor);
   double ltime = loadIR(ir, impulseLength, fragmentSize, factor);
+  if(std::strlen(wisdomFile) > 0) FFTPLAN::exportWisdom(wisdomFile);
+  const char * spectraFile = args.getString("-sp");
+  double stime = 0;
+  if(std::strlen(spectraFile) > 0) stime = loadSpectra(ir, impulseLength, spectraFile);
   std::fprintf(stderr, "process( %ld x %ld )\n", processFrame, frameCount);
   double ptime = process(ir, processFrame, frameCount, FV3_IR_SKIP_FILTER);
   std::fprintf(stderr, "\n");
@@ -223,6 +300,10 @@ int main(int argc, char * argv[])
 	       ltime, (double)impulseLength/48000/ltime);
   std::fprintf(stderr, "process t %.2f[s] (x%.2f@48kHz)\n",
 	       ptime, (double)processFrame*frameCount/48000/ptime);
+  if(std::strlen(spectraFile) > 0) std::fprintf(stderr, "spectra load time %.4f[s]\n", stime);
+#ifdef ENABLE_PTHREAD
+  if(ir3p != NULL) std::fprintf(stderr, "deadline missed %ld\n", ir3p->getDeadlineMissed());
+#endif
   std::fprintf(stderr, "\n");
   return 0;
 }
@@ -0,0 +1,148 @@
+/**
+ *  Freeverb3 Denormal Tail Test Program
+ *
+ *  Copyright (C) 2018 Teru Kamogashira
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <limits>
+#include <freeverb/revmodel.hpp>
+#include <freeverb/nrev.hpp>
+#include <freeverb/nrevb.hpp>
+#include <freeverb/strev.hpp>
+#include <freeverb/progenitor2.hpp>
+#include <freeverb/zrev2.hpp>
+#include <freeverb/dl_gardner.hpp>
+#include <freeverb/utils.hpp>
+
+// Feed a short noise burst and process a long silent tail, which decays into the denormal range.
+// The outputs must not contain any denormal and the FPU mode of the caller must be kept.
+// The processing time of the burst and the tail per second of audio is only printed for information,
+// the denormals in the internal state are not visible in the outputs, but they slow down the tail.
+
+#define FS 48000
+#define BLOCK 256
+#define BURST (FS)
+#define TAIL (FS*30)
+
+template <typename pfloat_t, typename REV, typename UTILS>
+class Test
+{
+public:
+  long test(const char * name)
+  {
+    REV rev;
+    pfloat_t iL[BLOCK], iR[BLOCK], oL[BLOCK], oR[BLOCK];
+    rev.setSampleRate(FS);
+    rev.mute();
+
+    uint32_t mxcsr = UTILS::getMXCSR();
+    uint64_t fpcr = UTILS::getFPCR();
+    long denormals = 0, modeErrors = 0;
+    double burstTime = 0, tailTime = 0;
+    for(long t = 0;t < BURST+TAIL;t += BLOCK)
+      {
+        for(long i = 0;i < BLOCK;i ++)
+          {
+            iL[i] = t < BURST ? std::rand()/(pfloat_t)RAND_MAX-0.5 : 0;
+            iR[i] = t < BURST ? std::rand()/(pfloat_t)RAND_MAX-0.5 : 0;
+          }
+        clock_t start = std::clock();
+        rev.processreplace(iL, iR, oL, oR, BLOCK);
+        double time = (double)(std::clock()-start)/CLOCKS_PER_SEC;
+        if(t < BURST) burstTime += time; else tailTime += time;
+        for(long i = 0;i < BLOCK;i ++)
+          {
+            if(std::fpclassify(oL[i]) == FP_SUBNORMAL) denormals ++;
+            if(std::fpclassify(oR[i]) == FP_SUBNORMAL) denormals ++;
+          }
+        if(UTILS::getMXCSR() != mxcsr||UTILS::getFPCR() != fpcr) modeErrors ++;
+      }
+    // per second of audio
+    double burstRate = burstTime*1000/((double)BURST/FS), tailRate = tailTime*1000/((double)TAIL/FS);
+    std::fprintf(stderr, "%-16s burst %8.3f ms/s tail %8.3f ms/s denormals %ld mode errors %ld %s\n", name,
+                 burstRate, tailRate, denormals, modeErrors, denormals == 0&&modeErrors == 0 ? "OK" : "NG");
+    return denormals + modeErrors;
+  }
+};
+
+// The product of the smallest normal number and 0.5 must be flushed only inside the guard.
+template <typename pfloat_t, typename GUARD>
+long testGuard()
+{
+#if defined(__x86_64__)||defined(__aarch64__)
+  volatile pfloat_t tiny = std::numeric_limits<pfloat_t>::min(), half = 0.5;
+  bool before = std::fpclassify(tiny*half) == FP_SUBNORMAL, inside;
+  {
+    GUARD guard;
+    inside = std::fpclassify(tiny*half) == FP_SUBNORMAL;
+  }
+  bool after = std::fpclassify(tiny*half) == FP_SUBNORMAL;
+  std::fprintf(stderr, "%-16s before %d inside %d after %d %s\n", "denormalguard", before, inside, after,
+               before&&!inside&&after ? "OK" : "NG");
+  return before&&!inside&&after ? 0 : 1;
+#else
+  // the scalar float math may not use the FPU mode of the guard (x87)
+  return 0;
+#endif
+}
+
+template <typename pfloat_t, typename UTILS, typename GUARD, typename REVMODEL, typename NREV, typename NREVB, typename STREV,
+          typename PROG2, typename ZREV2, typename GDLR>
+long testAll()
+{
+  long errors = 0;
+  errors += testGuard<pfloat_t,GUARD>();
+  errors += Test<pfloat_t,REVMODEL,UTILS>().test("revmodel");
+  errors += Test<pfloat_t,NREV,UTILS>().test("nrev");
+  errors += Test<pfloat_t,NREVB,UTILS>().test("nrevb");
+  errors += Test<pfloat_t,STREV,UTILS>().test("strev");
+  errors += Test<pfloat_t,PROG2,UTILS>().test("progenitor2");
+  errors += Test<pfloat_t,ZREV2,UTILS>().test("zrev2");
+  errors += Test<pfloat_t,GDLR,UTILS>().test("gd_largeroom");
+  return errors;
+}
+
+int main()
+{
+  fprintf(stderr, "Denormal Tail Test\n");
+  fprintf(stderr, "<" PACKAGE "-" VERSION ">\n");
+  fprintf(stderr, "Copyright (C) 2006-2018 Teru Kamogashira\n");
+#ifdef DISABLE_UNDENORMAL
+  fprintf(stderr, "Undenormal code: disabled\n");
+#else
+  fprintf(stderr, "Undenormal code: enabled\n");
+#endif
+
+  long errors = 0;
+#ifdef BUILD_FLOAT
+  fprintf(stderr, "========\n");
+  fprintf(stderr, "Single Precision\n");
+  errors += testAll<float,fv3::utils_f,fv3::denormalguard_f,fv3::revmodel_f,fv3::nrev_f,fv3::nrevb_f,fv3::strev_f,
+                    fv3::progenitor2_f,fv3::zrev2_f,fv3::gd_largeroom_f>();
+#endif
+#ifdef BUILD_DOUBLE
+  fprintf(stderr, "========\n");
+  fprintf(stderr, "Double Precision\n");
+  errors += testAll<double,fv3::utils_,fv3::denormalguard_,fv3::revmodel_,fv3::nrev_,fv3::nrevb_,fv3::strev_,
+                    fv3::progenitor2_,fv3::zrev2_,fv3::gd_largeroom_>();
+#endif
+  return errors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -112,6 +112,11 @@ int main()
   testf.test(FV3_X86SIMD_FLAG_AVX,0);
   testf.test(FV3_X86SIMD_FLAG_FMA3,0);
   testf.test(FV3_X86SIMD_FLAG_FMA4,0);
+  testf.test(FV3_X86SIMD_FLAG_AVX2,0);
+  testf.test(FV3_X86SIMD_FLAG_AVX512F,0);
+  testf.test(FV3_SIMD_FLAG_NEON,0);
+  testf.test(FV3_SIMD_FLAG_VECTOR,0);
+  testf.test(FV3_SIMD_FLAG_VECTOR,FV3_SIMD_FLAG_SPLIT);
   testf.test(FV3_X86SIMD_FLAG_SSE2,0); // not implemented test; default to FPU
 #endif
   
@@ -126,6 +131,11 @@ int main()
   testd.test(FV3_X86SIMD_FLAG_AVX,0);
   testd.test(FV3_X86SIMD_FLAG_FMA3,0);
   testd.test(FV3_X86SIMD_FLAG_FMA4,0);
+  testd.test(FV3_X86SIMD_FLAG_AVX2,0);
+  testd.test(FV3_X86SIMD_FLAG_AVX512F,0);
+  testd.test(FV3_SIMD_FLAG_NEON,0);
+  testd.test(FV3_SIMD_FLAG_VECTOR,0);
+  testd.test(FV3_SIMD_FLAG_VECTOR,FV3_SIMD_FLAG_SPLIT);
 #endif
 
 #ifdef BUILD_FLOAT